@@ -53,7 +53,7 @@ usage() {
 	printf '    %s -h\n' "$script"
 	printf '    %s --help\n' "$script"
 	printf '    %s [-a|-bD|-dB|-c] [-CeEfgGHilmMNPrtTvz] [-O OPT_LEVEL] [-k KARATSUBA_LEN]\\\n' "$script"
-	printf '       [-s SETTING] [-S SETTING] [-p TYPE]\n'
+	printf '       [-K TOOM_LEN] [-F NTT_LEN] [-s SETTING] [-S SETTING] [-p TYPE]\n'
 	printf '    %s \\\n' "$script"
 	printf '       [--library|--bc-only --disable-dc|--dc-only --disable-bc|--coverage]  \\\n'
 	printf '       [--force --debug --disable-extra-math --disable-generated-tests]      \\\n'
@@ -61,6 +61,7 @@ usage() {
 	printf '       [--enable-editline] [--enable-readline] [--enable-internal-history]   \\\n'
 	printf '       [--disable-problematic-tests] [--install-all-locales]                 \\\n'
 	printf '       [--opt=OPT_LEVEL] [--karatsuba-len=KARATSUBA_LEN]                     \\\n'
+	printf '       [--toom-len=TOOM_LEN] [--ntt-len=NTT_LEN]                             \\\n'
 	printf '       [--set-default-on=SETTING] [--set-default-off=SETTING]                \\\n'
 	printf '       [--predefined-build-type=TYPE]                                        \\\n'
 	printf '       [--prefix=PREFIX] [--bindir=BINDIR] [--datarootdir=DATAROOTDIR]       \\\n'
@@ -129,6 +130,14 @@ usage() {
 	printf '    -k KARATSUBA_LEN, --karatsuba-len KARATSUBA_LEN\n'
 	printf '        Set the karatsuba length to KARATSUBA_LEN (default is 64).\n'
 	printf '        It is an error if KARATSUBA_LEN is not a number or is less than 16.\n'
+	printf '    -K TOOM_LEN, --toom-len TOOM_LEN\n'
+	printf '        Set the Toom-Cook length to TOOM_LEN (default is 160). Numbers with\n'
+	printf '        at least TOOM_LEN limbs are multiplied with Toom-3 instead of Karatsuba.\n'
+	printf '        It is an error if TOOM_LEN is not a number or is less than 16.\n'
+	printf '    -F NTT_LEN, --ntt-len NTT_LEN\n'
+	printf '        Set the NTT length to NTT_LEN (default is 384). Numbers with at\n'
+	printf '        least NTT_LEN limbs are multiplied with a number-theoretic transform.\n'
+	printf '        It is an error if NTT_LEN is not a number or is less than 16.\n'
 	printf '    -l, --install-all-locales\n'
 	printf '        Installs all locales, regardless of how many are on the system. This\n'
 	printf '        option is useful for package maintainers who want to make sure that\n'
@@ -875,6 +884,8 @@ bc_only=0
 dc_only=0
 coverage=0
 karatsuba_len=32
+toom_len=160
+ntt_len=384
 debug=0
 hist=1
 hist_impl="internal"
@@ -911,7 +922,7 @@ dc_default_digit_clamp=0
 # getopts is a POSIX utility, but it cannot handle long options. Thus, the
 # handling of long options is done by hand, and that's the reason that short and
 # long options cannot be mixed.
-while getopts "abBcdDeEfgGhHik:lMmNO:p:PrS:s:tTvz-" opt; do
+while getopts "abBcdDeEfF:gGhHik:K:lMmNO:p:PrS:s:tTvz-" opt; do
 
 	case "$opt" in
 		a) library=1 ;;
@@ -924,12 +935,14 @@ while getopts "abBcdDeEfgGhHik:lMmNO:p:PrS:s:tTvz-" opt; do
 		e) hist_impl="editline" ;;
 		E) extra_math=0 ;;
 		f) force=1 ;;
+		F) ntt_len="$OPTARG" ;;
 		g) debug=1 ;;
 		G) generate_tests=0 ;;
 		h) usage ;;
 		H) hist=0 ;;
 		i) hist_impl="internal" ;;
 		k) karatsuba_len="$OPTARG" ;;
+		K) toom_len="$OPTARG" ;;
 		l) all_locales=1 ;;
 		m) memcheck=1 ;;
 		M) install_manpages=0 ;;
@@ -1026,6 +1039,20 @@ while getopts "abBcdDeEfgGhHik:lMmNO:p:PrS:s:tTvz-" opt; do
 					fi
 					karatsuba_len="$1"
 					shift ;;
+				toom-len=?*) toom_len="$LONG_OPTARG" ;;
+				toom-len)
+					if [ "$#" -lt 2 ]; then
+						usage "No argument given for '--$arg' option"
+					fi
+					toom_len="$1"
+					shift ;;
+				ntt-len=?*) ntt_len="$LONG_OPTARG" ;;
+				ntt-len)
+					if [ "$#" -lt 2 ]; then
+						usage "No argument given for '--$arg' option"
+					fi
+					ntt_len="$1"
+					shift ;;
 				opt=?*) optimization="$LONG_OPTARG" ;;
 				opt)
 					if [ "$#" -lt 2 ]; then
@@ -1133,6 +1160,26 @@ if [ "$karatsuba_len" -lt 16 ]; then
 	usage "KARATSUBA_LEN is less than 16"
 fi
 
+# TOOM_LEN must be an integer and must be 16 or greater.
+case $toom_len in
+	(*[!0-9]*|'') usage "TOOM_LEN is not a number" ;;
+	(*) ;;
+esac
+
+if [ "$toom_len" -lt 16 ]; then
+	usage "TOOM_LEN is less than 16"
+fi
+
+# NTT_LEN must be an integer and must be 16 or greater.
+case $ntt_len in
+	(*[!0-9]*|'') usage "NTT_LEN is not a number" ;;
+	(*) ;;
+esac
+
+if [ "$ntt_len" -lt 16 ]; then
+	usage "NTT_LEN is less than 16"
+fi
+
 set -e
 
 if [ -z "${LONG_BIT+set}" ]; then
@@ -1889,6 +1936,8 @@ printf 'BC_ENABLE_NLS=%s\n\n' "$nls"
 printf 'BC_ENABLE_AFL=%s\n' "$fuzz"
 printf '\n'
 printf 'BC_NUM_KARATSUBA_LEN=%s\n' "$karatsuba_len"
+printf 'BC_NUM_TOOM_LEN=%s\n' "$toom_len"
+printf 'BC_NUM_NTT_LEN=%s\n' "$ntt_len"
 printf '\n'
 printf 'CC=%s\n' "$CC"
 printf 'CFLAGS=%s\n' "$CFLAGS"
@@ -2018,6 +2067,8 @@ contents=$(replace "$contents" "BC_HELP_O" "$bc_help")
 contents=$(replace "$contents" "DC_HELP_O" "$dc_help")
 contents=$(replace "$contents" "BC_LIB2_O" "$BC_LIB2_O")
 contents=$(replace "$contents" "KARATSUBA_LEN" "$karatsuba_len")
+contents=$(replace "$contents" "TOOM_LEN" "$toom_len")
+contents=$(replace "$contents" "NTT_LEN" "$ntt_len")
 
 contents=$(replace "$contents" "NLSPATH" "$NLSPATH")
 contents=$(replace "$contents" "DESTDIR" "$destdir")
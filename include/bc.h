@@ -97,7 +97,7 @@ typedef struct BcLexKeyword
 
 /// A macro for the number of keywords bc has. This has to be updated if any are
 /// added. This is for the redefined_kws field of the BcVm struct.
-#define BC_LEX_NKWS (37)
+#define BC_LEX_NKWS (40)
 
 #else // BC_ENABLE_EXTRA_MATH
 
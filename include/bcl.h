@@ -310,6 +310,37 @@ bcl_modexp(BclNumber a, BclNumber b, BclNumber c);
 BclNumber
 bcl_modexp_keep(BclNumber a, BclNumber b, BclNumber c);
 
+BclNumber
+bcl_mulmod(BclNumber a, BclNumber b, BclNumber c);
+
+BclNumber
+bcl_mulmod_keep(BclNumber a, BclNumber b, BclNumber c);
+
+BclNumber
+bcl_invmod(BclNumber a, BclNumber b);
+
+BclNumber
+bcl_invmod_keep(BclNumber a, BclNumber b);
+
+BclNumber
+bcl_gcd(BclNumber a, BclNumber b);
+
+BclNumber
+bcl_gcd_keep(BclNumber a, BclNumber b);
+
+BclNumber
+bcl_lcm(BclNumber a, BclNumber b);
+
+BclNumber
+bcl_lcm_keep(BclNumber a, BclNumber b);
+
+BclError
+bcl_gcdext(BclNumber a, BclNumber b, BclNumber* g, BclNumber* x, BclNumber* y);
+
+BclError
+bcl_gcdext_keep(BclNumber a, BclNumber b, BclNumber* g, BclNumber* x,
+                BclNumber* y);
+
 ssize_t
 bcl_cmp(BclNumber a, BclNumber b);
 
@@ -272,6 +272,17 @@ typedef enum BcInst
 	/// Do divide and modulus at the same time.
 	BC_INST_DIVMOD,
 
+#if BC_ENABLE_EXTRA_MATH
+	/// Modular multiplication.
+	BC_INST_MULMOD,
+
+	/// Modular inverse.
+	BC_INST_INVMOD,
+
+	/// Extended GCD.
+	BC_INST_GCDEXT,
+#endif // BC_ENABLE_EXTRA_MATH
+
 	/// Turns a number into a string and prints it.
 	BC_INST_PRINT_STREAM,
 
@@ -380,6 +391,25 @@ typedef struct BcConst
 
 } BcConst;
 
+#if BC_ENABLED
+
+/// The native kernel of a math library function. Which member is set depends on
+/// the number of parameters of the function.
+typedef union BcFuncNative
+{
+	/// The kernel of a function with one parameter.
+	BcNumUnaryOp unary;
+
+	/// The kernel of a function with two parameters.
+	BcNumBinaryOp binary;
+
+	/// The kernel of a function with three parameters.
+	BcNumTernaryOp ternary;
+
+} BcFuncNative;
+
+#endif // BC_ENABLED
+
 /// A function. This is also used in dc, not just bc. The reason is that strings
 /// are executed in dc, and they are converted to functions in order to be
 /// executed.
@@ -409,6 +439,13 @@ typedef struct BcFunc
 #if BC_ENABLED
 	/// True if the function is a void function.
 	bool voidfn;
+
+	/// True if a native kernel computes the function instead of the bytecode.
+	/// Only math library functions that have not been redefined have one.
+	bool native;
+
+	/// The native kernel, if there is one.
+	BcFuncNative kernel;
 #endif // BC_ENABLED
 
 } BcFunc;
@@ -359,6 +359,19 @@ typedef enum BcLexType
 	/// bc divmod keyword.
 	BC_LEX_KW_DIVMOD,
 
+#if BC_ENABLE_EXTRA_MATH
+
+	/// bc mulmod keyword.
+	BC_LEX_KW_MULMOD,
+
+	/// bc invmod keyword.
+	BC_LEX_KW_INVMOD,
+
+	/// bc gcdext keyword.
+	BC_LEX_KW_GCDEXT,
+
+#endif // BC_ENABLE_EXTRA_MATH
+
 	/// bc quit keyword.
 	BC_LEX_KW_QUIT,
 
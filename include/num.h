@@ -106,6 +106,50 @@ typedef int_least16_t BcDig;
 
 #endif // BC_LONG_BIT >= 64
 
+// This decides whether simple multiplication works on pairs of limbs at once,
+// as wide limbs of twice as many decimal digits. That needs an integer type for
+// their products, which is twice as big as BcBigDig, so with 64-bit limbs, it
+// needs a compiler with unsigned __int128. It may be turned off by defining it
+// to 0.
+#ifndef BC_NUM_WIDE
+#if BC_LONG_BIT < 64 || defined(__SIZEOF_INT128__)
+#define BC_NUM_WIDE (1)
+#else // BC_LONG_BIT < 64 || defined(__SIZEOF_INT128__)
+#define BC_NUM_WIDE (0)
+#endif // BC_LONG_BIT < 64 || defined(__SIZEOF_INT128__)
+#endif // BC_NUM_WIDE
+
+#if BC_NUM_WIDE
+
+#if BC_LONG_BIT >= 64
+
+/// A wide limb, which holds two limbs.
+typedef uint64_t BcWideDig;
+
+/// The type for products of wide limbs. __extension__ keeps pedantic compilers
+/// quiet about the type not being standard.
+__extension__ typedef unsigned __int128 BcWideProd;
+
+#else // BC_LONG_BIT >= 64
+
+/// A wide limb, which holds two limbs.
+typedef uint32_t BcWideDig;
+
+/// The type for products of wide limbs.
+typedef uint64_t BcWideProd;
+
+#endif // BC_LONG_BIT >= 64
+
+/// The max number + 1 that one wide limb can hold.
+#define BC_NUM_WIDE_POW (((BcWideDig) BC_BASE_POW) * BC_BASE_POW)
+
+#endif // BC_NUM_WIDE
+
+/// The max length, in limbs, of operands that simple multiplication does in
+/// wide limbs. The sum of half this many products of wide limbs, plus a carry,
+/// must fit in a BcWideProd.
+#define BC_NUM_WIDE_LEN (128)
+
 /// The default (and minimum) number of limbs when allocating a number.
 #define BC_NUM_DEF_SIZE (8)
 
@@ -172,6 +216,173 @@ struct BcRNG;
 #error BC_NUM_KARATSUBA_LEN must be at least 16.
 #endif // BC_NUM_KARATSUBA_LEN
 
+// This sets a default for the Toom-Cook length.
+#ifndef BC_NUM_TOOM_LEN
+#define BC_NUM_TOOM_LEN (BC_NUM_BIGDIG_C(160))
+#elif BC_NUM_TOOM_LEN < 16
+#error BC_NUM_TOOM_LEN must be at least 16.
+#endif // BC_NUM_TOOM_LEN
+
+// This sets a default for the NTT length.
+#ifndef BC_NUM_NTT_LEN
+#define BC_NUM_NTT_LEN (BC_NUM_BIGDIG_C(384))
+#elif BC_NUM_NTT_LEN < 16
+#error BC_NUM_NTT_LEN must be at least 16.
+#endif // BC_NUM_NTT_LEN
+
+// This sets a default for the length of the divisor and quotient, in limbs,
+// above which division uses Burnikel-Ziegler recursive division instead of
+// long division. It is also where the recursion bottoms out.
+#ifndef BC_NUM_BZ_LEN
+#define BC_NUM_BZ_LEN (BC_NUM_BIGDIG_C(64))
+#elif BC_NUM_BZ_LEN < 16
+#error BC_NUM_BZ_LEN must be at least 16.
+#endif // BC_NUM_BZ_LEN
+
+// This sets a default for the length of the divisor and quotient, in limbs,
+// above which division uses a Newton reciprocal instead of Burnikel-Ziegler.
+#ifndef BC_NUM_NEWTON_LEN
+#define BC_NUM_NEWTON_LEN (BC_NUM_BIGDIG_C(8000))
+#elif BC_NUM_NEWTON_LEN < 16
+#error BC_NUM_NEWTON_LEN must be at least 16.
+#endif // BC_NUM_NEWTON_LEN
+
+// This sets a default for the length, in limbs, above which conversion to and
+// from bases other than decimal uses divide and conquer.
+#ifndef BC_NUM_RADIX_LEN
+#define BC_NUM_RADIX_LEN (BC_NUM_BIGDIG_C(64))
+#elif BC_NUM_RADIX_LEN < 16
+#error BC_NUM_RADIX_LEN must be at least 16.
+#endif // BC_NUM_RADIX_LEN
+
+// This sets a default for the length of the modulus, in limbs, at and above
+// which modular exponentiation uses Barrett reduction. Below it, Montgomery
+// reduction is used if the modulus is coprime to BC_BASE_POW.
+#ifndef BC_NUM_BARRETT_LEN
+#define BC_NUM_BARRETT_LEN (BC_NUM_BIGDIG_C(256))
+#elif BC_NUM_BARRETT_LEN < 16
+#error BC_NUM_BARRETT_LEN must be at least 16.
+#endif // BC_NUM_BARRETT_LEN
+
+// This sets a default for the length of an odd modulus, in limbs, below which
+// modular exponentiation is done in binary when BC_NUM_BINARY is on. Binary
+// Montgomery reduction is quadratic, but with about half as many limbs as
+// decimal, so it beats Barrett reduction well above BC_NUM_BARRETT_LEN.
+#ifndef BC_NUM_BIN_MONT_LEN
+#define BC_NUM_BIN_MONT_LEN (BC_NUM_BIGDIG_C(1024))
+#elif BC_NUM_BIN_MONT_LEN < 2
+#error BC_NUM_BIN_MONT_LEN must be at least 2.
+#endif // BC_NUM_BIN_MONT_LEN
+
+// This sets a default for the length of the shorter operand, in limbs, at and
+// above which a product with a much longer operand is done in slices of the
+// longer one. With wide limbs, even short slices pay off because they fit brute
+// force in wide limbs.
+#ifndef BC_NUM_UNBAL_LEN
+#if BC_NUM_WIDE
+#define BC_NUM_UNBAL_LEN (BC_NUM_BIGDIG_C(6))
+#else // BC_NUM_WIDE
+#define BC_NUM_UNBAL_LEN (BC_NUM_KARATSUBA_LEN)
+#endif // BC_NUM_WIDE
+#elif BC_NUM_UNBAL_LEN < 2
+#error BC_NUM_UNBAL_LEN must be at least 2.
+#endif // BC_NUM_UNBAL_LEN
+
+// This sets a default for the length, in limbs, at and above which the GCD
+// uses the subquadratic half GCD instead of only Lehmer steps.
+#ifndef BC_NUM_HGCD_LEN
+#define BC_NUM_HGCD_LEN (BC_NUM_BIGDIG_C(128))
+#elif BC_NUM_HGCD_LEN < 16
+#error BC_NUM_HGCD_LEN must be at least 16.
+#endif // BC_NUM_HGCD_LEN
+
+/// The number of leading limbs that the Lehmer steps of the GCD run Euclid on.
+/// They fit in an int64_t.
+#define BC_NUM_GCD_LIMBS (18 / BC_BASE_DIGS)
+
+/// The largest entry in the matrix of a Lehmer step of the GCD. Two entries
+/// times limbs, plus a carry, fit in an int64_t.
+#define BC_NUM_GCD_MAX (((int64_t) 1) << 31)
+
+/// The number of limbs that are added or subtracted at once in passes that can
+/// be vectorized.
+#define BC_NUM_ADD_BLOCK (32)
+
+/// The number of limb products that are summed at once in the columns of simple
+/// multiplication, in passes that can be vectorized. The sum of this many
+/// products of limbs must fit in a BcBigDig with room left for a carry.
+#define BC_NUM_MUL_CHUNK (16)
+
+// This decides whether the limb kernels are built for more than one level of
+// vector instructions and picked at runtime. It needs GCC or Clang on x86 for
+// the target attribute and CPU detection, and it may be turned off by defining
+// it to 0.
+#ifndef BC_NUM_DISPATCH
+#if (BC_GCC && __GNUC__ >= 5 || BC_CLANG && __clang_major__ >= 6) && \
+	(defined(__x86_64__) || defined(__i386__))
+#define BC_NUM_DISPATCH (1)
+#else // (BC_GCC && __GNUC__ >= 5 || BC_CLANG && __clang_major__ >= 6) && ...
+#define BC_NUM_DISPATCH (0)
+#endif // (BC_GCC && __GNUC__ >= 5 || BC_CLANG && __clang_major__ >= 6) && ...
+#endif // BC_NUM_DISPATCH
+
+/// The number of bits in a word of binary for base conversion.
+#define BC_NUM_BIN_BITS (32)
+
+// This decides whether integer work that is naturally binary, modular
+// exponentiation with odd moduli and the bitwise functions of the extended math
+// library, is done in binary limbs of 64 bits, with decimal conversion only at
+// the ends. That needs unsigned __int128 for their products. Without it, the
+// bitwise functions work in binary limbs of 32 bits, and modular exponentiation
+// stays in decimal. It may be turned off by defining it to 0.
+#ifndef BC_NUM_BINARY
+#if BC_LONG_BIT >= 64 && defined(__SIZEOF_INT128__)
+#define BC_NUM_BINARY (1)
+#else // BC_LONG_BIT >= 64 && defined(__SIZEOF_INT128__)
+#define BC_NUM_BINARY (0)
+#endif // BC_LONG_BIT >= 64 && defined(__SIZEOF_INT128__)
+#endif // BC_NUM_BINARY
+
+#if BC_NUM_BINARY
+
+/// A binary limb.
+typedef uint64_t BcBinDig;
+
+/// The type for products of binary limbs. __extension__ keeps pedantic
+/// compilers quiet about the type not being standard.
+__extension__ typedef unsigned __int128 BcBinProd;
+
+/// The number of bits in a binary limb.
+#define BC_NUM_BINDIG_BITS (64)
+
+#else // BC_NUM_BINARY
+
+/// A binary limb.
+typedef uint32_t BcBinDig;
+
+/// The type for products of binary limbs.
+typedef uint64_t BcBinProd;
+
+/// The number of bits in a binary limb.
+#define BC_NUM_BINDIG_BITS (32)
+
+#endif // BC_NUM_BINARY
+
+/// The number of words of binary for base conversion in a binary limb.
+#define BC_NUM_BINDIG_WORDS (BC_NUM_BINDIG_BITS / BC_NUM_BIN_BITS)
+
+/**
+ * Returns true if the base @a b is a power of 2, which means that its digits
+ * can be sliced right out of binary.
+ * @param b  The base to test.
+ * @return   True if @a b is a power of 2, false otherwise.
+ */
+#define BC_NUM_BASE_POW2(b) (!((b) & ((b) - 1)))
+
+/// The precision, in decimal places, of the first estimate of a reciprocal
+/// for Newton division. It is done with long division.
+#define BC_NUM_NEWTON_START (BC_BASE_DIGS * 4)
+
 // A crude, but always big enough, calculation of
 // the size required for ibase and obase BcNum's.
 #define BC_NUM_BIGDIG_LOG10 (BC_NUM_DEF_SIZE)
@@ -204,12 +415,44 @@ struct BcRNG;
  */
 #define BC_NUM_NUM_LETTER(c) ((c) - 'A' + BC_BASE)
 
-/// The number of allocations done by bc_num_k(). If you change the number of
-/// allocations, you must change this. This is done in order to allocate them
-/// all as one allocation and just give them all pointers to different parts.
-/// Works pretty well, but you have to be careful.
+/// The number of split pieces that each level of Karatsuba carves out of its
+/// arena. If you change the number of pieces, you must change this. This is
+/// done in order to allocate the whole recursion as one allocation and just
+/// give everything pointers to different parts. Works pretty well, but you
+/// have to be careful.
 #define BC_NUM_KARATSUBA_ALLOCS (6)
 
+/// The number of sub-products that each level of Karatsuba carves out of its
+/// arena. The same warning as for BC_NUM_KARATSUBA_ALLOCS applies.
+#define BC_NUM_KARATSUBA_PRODS (3)
+
+/// The largest ratio of n to the smaller side of comb(n, r) for which the
+/// binomial is built from its prime factorization, which needs a sieve up to n.
+/// Binomials with smaller sides are divided out of a short product instead.
+#define BC_NUM_COMB_SIEVE_RATIO (64)
+
+/// The number of extra decimal places that constants are computed to before
+/// they are truncated. A few are lost to the last multiplications for pi; the
+/// rest make sure that the truncated digits are right.
+#define BC_NUM_CONST_GUARD (20)
+
+/// The number of primes used by the number-theoretic transform (NTT).
+#define BC_NUM_NTT_PRIMES (3)
+
+/// The log2 of the largest transform the NTT primes support. All of the primes
+/// have at least this many factors of 2 in p-1.
+#define BC_NUM_NTT_MAX_LOG (23)
+
+/// The largest product, in limbs, that the NTT can compute. The bound on the
+/// convolution sums (n * (BC_BASE_POW - 1)^2) must stay below the product of
+/// the primes, which is true for this length.
+#define BC_NUM_NTT_MAX ((size_t) 1 << BC_NUM_NTT_MAX_LOG)
+
+/// The number of pending limbs needed to turn CRT results into limbs. A CRT
+/// result is less than 2^87, and this must be enough to hold one in base
+/// BC_BASE_POW with room for carries.
+#define BC_NUM_NTT_CARRY_DIGS (8)
+
 /**
  * Rounds @a s (scale) up to the next power of BC_BASE_DIGS. This will also
  * check for overflow and gives a fatal error if that happens because we just
@@ -370,6 +613,27 @@ struct BcRNG;
  */
 typedef void (*BcNumBinaryOp)(BcNum* a, BcNum* b, BcNum* c, size_t scale);
 
+/**
+ * A function type for the math library kernels.
+ * @param a      The parameter.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+typedef void (*BcNumUnaryOp)(BcNum* restrict a, BcNum* restrict b,
+                             size_t scale);
+
+/**
+ * A function type for the extended math library kernels that take three
+ * parameters.
+ * @param a      The first parameter.
+ * @param b      The second parameter.
+ * @param c      The third parameter.
+ * @param d      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+typedef void (*BcNumTernaryOp)(BcNum* a, BcNum* b, BcNum* c,
+                               BcNum* restrict d, size_t scale);
+
 /**
  * A function type for binary operators *after* @a c has been properly
  * allocated. At this point, *nothing* should be pointing to @a c (in any way
@@ -394,6 +658,160 @@ typedef void (*BcNumBinOp)(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale);
 typedef size_t (*BcNumBinaryOpReq)(const BcNum* a, const BcNum* b,
                                    size_t scale);
 
+/**
+ * Precomputed data for reducing products modulo one modulus. What reduction is
+ * used depends on the modulus: Montgomery reduction if it is small enough and
+ * coprime to BC_BASE_POW, Barrett reduction if it is big, and division
+ * otherwise.
+ */
+typedef struct BcNumMod
+{
+	/// The modulus. It is a positive integer.
+	BcNum m;
+
+	/// For Montgomery reduction, -1/m modulo BC_BASE_POW, or 0 if Montgomery
+	/// reduction is not used.
+	BcBigDig minv;
+
+	/// For Montgomery reduction, BC_BASE_POW^(2*m.len) mod m, which is used to
+	/// convert to Montgomery form. For Barrett reduction, the quotient
+	/// floor(BC_BASE_POW^(2*m.len)/m). Otherwise, unused.
+	BcNum c;
+
+} BcNumMod;
+
+/**
+ * A precomputed reciprocal of a divisor, so that dividing by it takes a
+ * multiplication instead of a division. That needs products twice as big as a
+ * BcBigDig, so without them, it is just the divisor.
+ */
+typedef struct BcNumRecip
+{
+	/// The divisor.
+	BcBigDig d;
+
+#if BC_NUM_WIDE
+
+	/// floor((2^n - 1) / d), where n is the number of bits in a BcBigDig.
+	BcBigDig m;
+
+#endif // BC_NUM_WIDE
+
+} BcNumRecip;
+
+/// The levels of vector instructions that the limb kernels are built for. Each
+/// level has all of the instructions of the levels before it.
+typedef enum BcNumLevel
+{
+	/// Whatever instructions the compiler targets by default.
+	BC_NUM_LEVEL_SCALAR,
+
+#if BC_NUM_DISPATCH
+
+	/// SSE4.2.
+	BC_NUM_LEVEL_SSE42,
+
+	/// AVX2.
+	BC_NUM_LEVEL_AVX2,
+
+	/// AVX-512 Foundation.
+	BC_NUM_LEVEL_AVX512,
+
+#endif // BC_NUM_DISPATCH
+
+	/// The number of levels.
+	BC_NUM_LEVEL_NUM,
+
+} BcNumLevel;
+
+/**
+ * The limb kernels that are built for each level of vector instructions. These
+ * are the add and subtract blocks, which gain about 10% on long additions at
+ * the AVX-512 level. The column sums of multiplication vectorize too, but they
+ * measured no gain over the default level, so they are called directly, and the
+ * rest of the arithmetic is chains of carries or divisions that do not gain
+ * from wider vectors.
+ */
+typedef struct BcNumKernels
+{
+	/// Adds a block of BC_NUM_ADD_BLOCK limbs. See bc_num_addBlock().
+	bool (*addBlock)(BcDig* c, const BcDig* a, const BcDig* b, bool carry);
+
+	/// Subtracts a block of BC_NUM_ADD_BLOCK limbs. See bc_num_subBlock().
+	bool (*subBlock)(BcDig* c, const BcDig* a, const BcDig* b, bool carry);
+
+} BcNumKernels;
+
+/// The constants that bc_num_const() computes and caches.
+typedef enum BcNumConst
+{
+	/// Pi.
+	BC_NUM_CONST_PI,
+
+	/// e, the base of the natural logarithm.
+	BC_NUM_CONST_E,
+
+	/// The natural logarithm of 2.
+	BC_NUM_CONST_LN2,
+
+	/// The natural logarithm of 10.
+	BC_NUM_CONST_LN10,
+
+	/// The number of constants.
+	BC_NUM_CONST_NUM,
+
+} BcNumConst;
+
+/// The series that the constants are summed from by binary splitting.
+typedef enum BcNumSeries
+{
+	/// The Chudnovsky series, which sums to a multiple of 1 / pi.
+	BC_NUM_SERIES_CHUDNOVSKY,
+
+	/// The sum of 1 / (n + 1)!, which is e - 1.
+	BC_NUM_SERIES_E,
+
+	/// The series for atanh(1 / x), for the logarithms.
+	BC_NUM_SERIES_ATANH,
+
+} BcNumSeries;
+
+/// The bitwise operations of the extended math library.
+typedef enum BcNumBitOp
+{
+	/// And, band().
+	BC_NUM_BIT_AND,
+
+	/// Or, bor().
+	BC_NUM_BIT_OR,
+
+	/// Exclusive or, bxor().
+	BC_NUM_BIT_XOR,
+
+	/// Not in a width, bnotn().
+	BC_NUM_BIT_NOT,
+
+	/// Reversal in a width, brevn().
+	BC_NUM_BIT_REV,
+
+	/// Rotation to the left in a width, broln().
+	BC_NUM_BIT_ROL,
+
+	/// Rotation to the right in a width, brorn().
+	BC_NUM_BIT_ROR,
+
+} BcNumBitOp;
+
+/**
+ * A function type for modular operators with three operands, like
+ * bc_num_modexp().
+ * @param a  The first parameter.
+ * @param b  The second parameter.
+ * @param c  The third parameter, the modulus.
+ * @param d  The return value.
+ */
+typedef void (*BcNumModOp)(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d);
+
 /**
  * A function type for printing a "digit." Functions of this type will print one
  * digit in a number. Digits are printed differently based on the base, which is
@@ -657,6 +1075,186 @@ bc_num_rshift(BcNum* a, BcNum* b, BcNum* c, size_t scale);
 void
 bc_num_sqrt(BcNum* restrict a, BcNum* restrict b, size_t scale);
 
+/**
+ * The exponential function, e(x) in the math library. Like the rest of the
+ * math library kernels below, this computes exactly what the bc source of the
+ * library does, with the same truncation at every step.
+ * @param a      The parameter.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+void
+bc_num_exp(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * The natural logarithm, l(x) in the math library.
+ * @param a      The parameter.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+void
+bc_num_ln(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * Sine, s(x) in the math library.
+ * @param a      The parameter, in radians.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+void
+bc_num_sin(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * Cosine, c(x) in the math library.
+ * @param a      The parameter, in radians.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+void
+bc_num_cos(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * Arctangent, a(x) in the math library.
+ * @param a      The parameter.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+void
+bc_num_atan(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * Returns a constant truncated to @a scale places. Constants are computed by
+ * binary splitting and cached in the BcVm, so that a constant only has to be
+ * computed again when a bigger scale is needed.
+ * @param c      The constant.
+ * @param r      The return value. It must be initialized.
+ * @param scale  The scale to truncate to.
+ */
+void
+bc_num_const(BcNumConst c, BcNum* restrict r, size_t scale);
+
+#if BC_ENABLE_EXTRA_MATH
+
+/**
+ * Pi, pi(s) in the extended math library.
+ * @param a      The parameter, which is the number of places.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_pi(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * And of the binary forms of the absolute values of @a a and @a b, truncated,
+ * band(a,b) in the extended math library. This is a BcNumBinaryOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_band(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Or, like bc_num_band(), bor(a,b) in the extended math library.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_bor(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Exclusive or, like bc_num_band(), bxor(a,b) in the extended math library.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_bxor(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Not of the binary form of the absolute value of @a a, truncated, in @a b
+ * bytes, bnotn(x,n) in the extended math library.
+ * @param a      The operand.
+ * @param b      The width in bytes.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_bnotn(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Reversal of the bits, like bc_num_bnotn(), brevn(x,n) in the extended math
+ * library.
+ * @param a      The operand.
+ * @param b      The width in bytes.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_brevn(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Rotation to the left by @a b bits in @a c bytes, like bc_num_bnotn(),
+ * broln(x,p,n) in the extended math library.
+ * @param a      The operand.
+ * @param b      The number of bits to rotate by.
+ * @param c      The width in bytes.
+ * @param d      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_broln(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d, size_t scale);
+
+/**
+ * Rotation to the right, like bc_num_broln(), brorn(x,p,n) in the extended
+ * math library.
+ * @param a      The operand.
+ * @param b      The number of bits to rotate by.
+ * @param c      The width in bytes.
+ * @param d      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_brorn(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d, size_t scale);
+
+/**
+ * Factorial of the absolute value of @a a, truncated, f(n) in the extended
+ * math library.
+ * @param a      The operand.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_fact(BcNum* restrict a, BcNum* restrict b, size_t scale);
+
+/**
+ * Permutations, perm(n,k) in the extended math library. Like the library, this
+ * returns 0 if @a b is greater than @a a, and otherwise works on their
+ * absolute values, truncated. This is a BcNumBinaryOp function.
+ * @param a      The number of items.
+ * @param b      The number of items to choose.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_perm(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Combinations, like bc_num_perm(), comb(n,r) in the extended math library.
+ * @param a      The number of items.
+ * @param b      The number of items to choose.
+ * @param c      The return value. It must be initialized.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_comb(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+#endif // BC_ENABLE_EXTRA_MATH
+
 /**
  * Divsion and modulus together. This is a dc extension.
  * @param a      The first parameter.
@@ -781,6 +1379,65 @@ bc_num_cmp(const BcNum* a, const BcNum* b);
 void
 bc_num_modexp(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d);
 
+/**
+ * Modular multiplication. @a d is set to (@a a * @a b) % @a c, but the product
+ * is reduced with the cached data for the modulus instead of divided.
+ * @param a      The first parameter.
+ * @param b      The second parameter.
+ * @param c      The third parameter, the modulus.
+ * @param d      The return value.
+ */
+void
+bc_num_mulmod(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d);
+
+/**
+ * Modular inverse. @a c is set to the number in [0, |@a b|) that gives 1 modulo
+ * @a b when multiplied by @a a. If there is none, that is a divide by zero
+ * error. This is a BcNumBinaryOp function.
+ * @param a      The number to invert.
+ * @param b      The modulus.
+ * @param c      The return value.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_invmod(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Greatest common divisor of the truncated absolute values of @a a and @a b,
+ * gcd(a,b) in the extended math library. Like the library, this returns @a a
+ * as is if @a b is zero. This is a BcNumBinaryOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return value.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_gcd(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Least common multiple of the truncated absolute values of @a a and @a b,
+ * lcm(a,b) in the extended math library. This is a BcNumBinaryOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return value.
+ * @param scale  The current scale. It is unused.
+ */
+void
+bc_num_lcm(BcNum* a, BcNum* b, BcNum* c, size_t scale);
+
+/**
+ * Extended GCD. @a g is set to the GCD of the integers @a a and @a b, and @a x
+ * and @a y to coefficients such that @a a * @a x + @a b * @a y is @a g.
+ * @param a  The first operand.
+ * @param b  The second operand.
+ * @param g  The return value for the GCD.
+ * @param x  The return value for the coefficient of @a a.
+ * @param y  The return value for the coefficient of @a b.
+ */
+void
+bc_num_gcdext(BcNum* a, BcNum* b, BcNum* restrict g, BcNum* restrict x,
+              BcNum* restrict y);
+
 /**
  * Sets @a n to zero with a scale of zero.
  * @param n  The number to zero.
@@ -833,6 +1490,18 @@ bc_num_parse(BcNum* restrict n, const char* restrict val, BcBigDig base);
 void
 bc_num_print(BcNum* restrict n, BcBigDig base, bool newline);
 
+/**
+ * Picks the limb kernels for the best vector instructions that the CPU has.
+ * This is process-wide, so it must be called once, before any other threads
+ * can use the kernels: by bc_vm_init() in bc and dc, and by bcl_start() in the
+ * library.
+ * @param name  The name of a lower level to use instead, for benchmarking, or
+ *              NULL. It is ignored if it does not name a level that the CPU
+ *              has.
+ */
+void
+bc_num_kernelsInit(const char* name);
+
 /**
  * Invert @a into @a b at the current scale.
  * @param a      The number to invert.
@@ -894,10 +1563,22 @@ bc_num_dump(const char* varname, const BcNum* n);
 /// A reference to an array of hex digits for easy conversion for printing.
 extern const char bc_num_hex_digits[];
 
+/// The arctangent of 1 to 64 places, for the math library kernels.
+extern const char bc_num_atan1[];
+
+/// The arctangent of .2 to 64 places, for the math library kernels.
+extern const char bc_num_atan_fifth[];
+
 /// An array of powers of 10 for easy conversion from number of digits to
 /// powers.
 extern const BcBigDig bc_num_pow10[BC_BASE_DIGS + 1];
 
+/// An array of the primes used by the number-theoretic transform.
+extern const uint32_t bc_num_ntt_primes[BC_NUM_NTT_PRIMES];
+
+/// The names of the levels of vector instructions for the limb kernels.
+extern const char* const bc_num_levels[BC_NUM_LEVEL_NUM];
+
 /// A reference to a constant array that is the max of a BigDig.
 extern const BcDig bc_num_bigdigMax[];
 
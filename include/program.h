@@ -201,6 +201,14 @@ typedef struct BcProgram
 /// The index for the read function in the functions array.
 #define BC_PROG_READ (1)
 
+#if BC_ENABLED
+
+/// The most parameters that a native kernel of a math library function can
+/// take. See BcFuncNative.
+#define BC_PROG_NATIVE_MAX_PARAMS (3)
+
+#endif // BC_ENABLED
+
 /**
  * Retires (completes the execution of) an instruction. Some instructions
  * require special retirement, but most can use this. This basically pops the
@@ -378,6 +386,44 @@ bc_program_addString(BcProgram* p, const char* str);
 size_t
 bc_program_insertFunc(BcProgram* p, const char* name);
 
+#if BC_ENABLED
+
+/**
+ * Attaches a native kernel to a math library function so that calls to it skip
+ * the bytecode. Redefining the function detaches the kernel again.
+ * @param p     The program.
+ * @param name  The name of the function. It must already exist.
+ * @param op    The kernel.
+ */
+void
+bc_program_setNative(BcProgram* p, const char* name, BcNumUnaryOp op);
+
+#if BC_ENABLE_EXTRA_MATH
+
+/**
+ * Attaches a native kernel to an extended math library function with two
+ * parameters, like bc_program_setNative().
+ * @param p     The program.
+ * @param name  The name of the function. It must already exist.
+ * @param op    The kernel.
+ */
+void
+bc_program_setNative2(BcProgram* p, const char* name, BcNumBinaryOp op);
+
+/**
+ * Attaches a native kernel to an extended math library function with three
+ * parameters, like bc_program_setNative().
+ * @param p     The program.
+ * @param name  The name of the function. It must already exist.
+ * @param op    The kernel.
+ */
+void
+bc_program_setNative3(BcProgram* p, const char* name, BcNumTernaryOp op);
+
+#endif // BC_ENABLE_EXTRA_MATH
+
+#endif // BC_ENABLED
+
 /**
  * Resets a program, usually because of resetting after an error.
  * @param p  The program to reset.
@@ -607,6 +653,9 @@ extern const char bc_program_esc_seqs[];
 		&&lbl_BC_INST_SWAP,                             \
 		&&lbl_BC_INST_MODEXP,                           \
 		&&lbl_BC_INST_DIVMOD,                           \
+		&&lbl_BC_INST_MULMOD,                           \
+		&&lbl_BC_INST_INVMOD,                           \
+		&&lbl_BC_INST_GCDEXT,                           \
 		&&lbl_BC_INST_PRINT_STREAM,                     \
 		&&lbl_BC_INST_EXTENDED_REGISTERS,               \
 		&&lbl_BC_INST_POP_EXEC,                         \
@@ -813,6 +862,9 @@ extern const char bc_program_esc_seqs[];
 		&&lbl_BC_INST_SWAP,                             \
 		&&lbl_BC_INST_MODEXP,                           \
 		&&lbl_BC_INST_DIVMOD,                           \
+		&&lbl_BC_INST_MULMOD,                           \
+		&&lbl_BC_INST_INVMOD,                           \
+		&&lbl_BC_INST_GCDEXT,                           \
 		&&lbl_BC_INST_PRINT_STREAM,                     \
 		&&lbl_BC_INST_INVALID,                          \
 	}
@@ -933,15 +985,16 @@ extern const char bc_program_esc_seqs[];
 		&&lbl_BC_INST_PRINT_POP,     &&lbl_BC_INST_STR,                \
 		&&lbl_BC_INST_POP,           &&lbl_BC_INST_SWAP,               \
 		&&lbl_BC_INST_MODEXP,        &&lbl_BC_INST_DIVMOD,             \
-		&&lbl_BC_INST_PRINT_STREAM,  &&lbl_BC_INST_EXTENDED_REGISTERS, \
-		&&lbl_BC_INST_POP_EXEC,      &&lbl_BC_INST_EXECUTE,            \
-		&&lbl_BC_INST_EXEC_COND,     &&lbl_BC_INST_PRINT_STACK,        \
-		&&lbl_BC_INST_CLEAR_STACK,   &&lbl_BC_INST_REG_STACK_LEN,      \
-		&&lbl_BC_INST_STACK_LEN,     &&lbl_BC_INST_DUPLICATE,          \
-		&&lbl_BC_INST_LOAD,          &&lbl_BC_INST_PUSH_VAR,           \
-		&&lbl_BC_INST_PUSH_TO_VAR,   &&lbl_BC_INST_QUIT,               \
-		&&lbl_BC_INST_NQUIT,         &&lbl_BC_INST_EXEC_STACK_LEN,     \
-		&&lbl_BC_INST_INVALID,                                         \
+		&&lbl_BC_INST_MULMOD,        &&lbl_BC_INST_INVMOD,             \
+		&&lbl_BC_INST_GCDEXT,        &&lbl_BC_INST_PRINT_STREAM,       \
+		&&lbl_BC_INST_EXTENDED_REGISTERS, &&lbl_BC_INST_POP_EXEC,      \
+		&&lbl_BC_INST_EXECUTE,       &&lbl_BC_INST_EXEC_COND,          \
+		&&lbl_BC_INST_PRINT_STACK,   &&lbl_BC_INST_CLEAR_STACK,        \
+		&&lbl_BC_INST_REG_STACK_LEN, &&lbl_BC_INST_STACK_LEN,          \
+		&&lbl_BC_INST_DUPLICATE,     &&lbl_BC_INST_LOAD,               \
+		&&lbl_BC_INST_PUSH_VAR,      &&lbl_BC_INST_PUSH_TO_VAR,        \
+		&&lbl_BC_INST_QUIT,          &&lbl_BC_INST_NQUIT,              \
+		&&lbl_BC_INST_EXEC_STACK_LEN, &&lbl_BC_INST_INVALID,           \
 	}
 
 #else // BC_ENABLE_EXTRA_MATH
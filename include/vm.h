@@ -250,6 +250,9 @@
 /// Returns the string for the environment args environment variable.
 #define BC_VM_ENV_ARGS_STR (BC_IS_BC ? "BC_ENV_ARGS" : "DC_ENV_ARGS")
 
+/// Returns the string for the kernels environment variable.
+#define BC_VM_KERNELS_STR (BC_IS_BC ? "BC_KERNELS" : "DC_KERNELS")
+
 /// Returns the string for the expression exit environment variable.
 #define BC_VM_EXPR_EXIT_STR (BC_IS_BC ? "BC_EXPR_EXIT" : "DC_EXPR_EXIT")
 
@@ -305,6 +308,9 @@
 /// Returns the string for the environment args environment variable.
 #define BC_VM_ENV_ARGS_STR ("BC_ENV_ARGS")
 
+/// Returns the string for the kernels environment variable.
+#define BC_VM_KERNELS_STR ("BC_KERNELS")
+
 /// Returns the string for the expression exit environment variable.
 #define BC_VM_EXPR_EXIT_STR ("BC_EXPR_EXIT")
 
@@ -360,6 +366,9 @@
 /// Returns the string for the environment args environment variable.
 #define BC_VM_ENV_ARGS_STR ("DC_ENV_ARGS")
 
+/// Returns the string for the kernels environment variable.
+#define BC_VM_KERNELS_STR ("DC_KERNELS")
+
 /// Returns the string for the expression exit environment variable.
 #define BC_VM_EXPR_EXIT_STR ("DC_EXPR_EXIT")
 
@@ -400,6 +409,9 @@
 
 #else // !BC_ENABLE_LIBRARY
 
+/// Returns the string for the kernels environment variable.
+#define BC_VM_KERNELS_STR ("BC_KERNELS")
+
 #define BC_Z (vm->leading_zeroes)
 
 #define BC_DIGIT_CLAMP (vm->digit_clamp)
@@ -700,6 +712,22 @@ typedef struct BcVm
 	/// BC_BASE_POW - last_pow.
 	BcBigDig last_rem;
 
+	/// Cached powers of last_pow for divide and conquer base conversion. The
+	/// one at index i is last_pow^(2^i).
+	BcVec pows;
+
+	/// Cached powers of 2 for divide and conquer conversion to and from binary.
+	/// The one at index i is 2^(16*2^i).
+	BcVec bin_pows;
+
+	/// The reduction data for the last modulus used for modular arithmetic. The
+	/// modulus is zero if there is none.
+	BcNumMod mod;
+
+	/// Cached constants, indexed by BcNumConst. Each one is truncated to its
+	/// own scale, and it is zero if it has not been computed yet.
+	BcNum consts[BC_NUM_CONST_NUM];
+
 #if !BC_ENABLE_LIBRARY
 
 	/// A buffer of environment arguments. This is the actual value of the
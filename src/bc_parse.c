@@ -554,7 +554,8 @@ bc_parse_builtin(BcParse* p, BcLexType type, uint8_t flags, BcInst* prev)
 
 /**
  * Parses a builtin function that takes 3 arguments. This includes modexp() and
- * divmod().
+ * divmod(), as well as mulmod(), invmod(), and gcdext() if extra math is
+ * enabled, though invmod() only takes 2.
  * @param p      The parser.
  * @param type   The lex token.
  * @param flags  The expression parsing flags for parsing the argument.
@@ -563,8 +564,21 @@ bc_parse_builtin(BcParse* p, BcLexType type, uint8_t flags, BcInst* prev)
 static void
 bc_parse_builtin3(BcParse* p, BcLexType type, uint8_t flags, BcInst* prev)
 {
+	bool arr;
+
+#if BC_ENABLE_EXTRA_MATH
+	assert(type == BC_LEX_KW_MODEXP || type == BC_LEX_KW_DIVMOD ||
+	       type == BC_LEX_KW_MULMOD || type == BC_LEX_KW_INVMOD ||
+	       type == BC_LEX_KW_GCDEXT);
+
+	// Both divmod() and gcdext() return extra results in an array.
+	arr = (type == BC_LEX_KW_DIVMOD || type == BC_LEX_KW_GCDEXT);
+#else // BC_ENABLE_EXTRA_MATH
 	assert(type == BC_LEX_KW_MODEXP || type == BC_LEX_KW_DIVMOD);
 
+	arr = (type == BC_LEX_KW_DIVMOD);
+#endif // BC_ENABLE_EXTRA_MATH
+
 	// Must have a left paren.
 	bc_lex_next(&p->l);
 	if (BC_ERR(p->l.t != BC_LEX_LPAREN)) bc_parse_err(p, BC_ERR_PARSE_TOKEN);
@@ -582,16 +596,26 @@ bc_parse_builtin3(BcParse* p, BcLexType type, uint8_t flags, BcInst* prev)
 
 	bc_lex_next(&p->l);
 
-	bc_parse_expr_status(p, flags, bc_parse_next_builtin);
+#if BC_ENABLE_EXTRA_MATH
+	// If it is an invmod, the second argument is the last one, so it is parsed
+	// below.
+	if (type != BC_LEX_KW_INVMOD)
+#endif // BC_ENABLE_EXTRA_MATH
+	{
+		bc_parse_expr_status(p, flags, bc_parse_next_builtin);
 
-	// Must have a comma.
-	if (BC_ERR(p->l.t != BC_LEX_COMMA)) bc_parse_err(p, BC_ERR_PARSE_TOKEN);
+		// Must have a comma.
+		if (BC_ERR(p->l.t != BC_LEX_COMMA))
+		{
+			bc_parse_err(p, BC_ERR_PARSE_TOKEN);
+		}
 
-	bc_lex_next(&p->l);
+		bc_lex_next(&p->l);
+	}
 
-	// If it is a divmod, parse an array name. Otherwise, just parse another
-	// expression.
-	if (type == BC_LEX_KW_DIVMOD)
+	// If it is a divmod or gcdext, parse an array name. Otherwise, just parse
+	// another expression.
+	if (arr)
 	{
 		// Must have a name.
 		if (BC_ERR(p->l.t != BC_LEX_NAME)) bc_parse_err(p, BC_ERR_PARSE_TOKEN);
@@ -627,8 +651,9 @@ bc_parse_builtin3(BcParse* p, BcLexType type, uint8_t flags, BcInst* prev)
 	bc_parse_push(p, *prev);
 
 	// If we have divmod, we need to assign the modulus to the array element, so
-	// we need to push the instructions for doing so.
-	if (type == BC_LEX_KW_DIVMOD)
+	// we need to push the instructions for doing so. The same goes for the
+	// coefficients of gcdext.
+	if (arr)
 	{
 		// The zeroth element.
 		bc_parse_push(p, BC_INST_ZERO);
@@ -638,9 +663,22 @@ bc_parse_builtin3(BcParse* p, BcLexType type, uint8_t flags, BcInst* prev)
 		bc_parse_pushName(p, p->l.str.v, false);
 
 		// Swap them and assign. After this, the top item on the stack should
-		// be the quotient.
+		// be the quotient, or for gcdext, the second coefficient.
 		bc_parse_push(p, BC_INST_SWAP);
 		bc_parse_push(p, BC_INST_ASSIGN_NO_VAL);
+
+#if BC_ENABLE_EXTRA_MATH
+		// The second coefficient goes in the first element. After this, the
+		// top item on the stack should be the GCD.
+		if (type == BC_LEX_KW_GCDEXT)
+		{
+			bc_parse_push(p, BC_INST_ONE);
+			bc_parse_push(p, BC_INST_ARRAY_ELEM);
+			bc_parse_pushName(p, p->l.str.v, false);
+			bc_parse_push(p, BC_INST_SWAP);
+			bc_parse_push(p, BC_INST_ASSIGN_NO_VAL);
+		}
+#endif // BC_ENABLE_EXTRA_MATH
 	}
 
 	bc_lex_next(&p->l);
@@ -1720,6 +1758,11 @@ bc_parse_stmt(BcParse* p)
 		case BC_LEX_KW_ASCIIFY:
 		case BC_LEX_KW_MODEXP:
 		case BC_LEX_KW_DIVMOD:
+#if BC_ENABLE_EXTRA_MATH
+		case BC_LEX_KW_MULMOD:
+		case BC_LEX_KW_INVMOD:
+		case BC_LEX_KW_GCDEXT:
+#endif // BC_ENABLE_EXTRA_MATH
 		case BC_LEX_KW_READ:
 #if BC_ENABLE_EXTRA_MATH
 		case BC_LEX_KW_RAND:
@@ -2395,6 +2438,11 @@ bc_parse_expr_err(BcParse* p, uint8_t flags, BcParseNext next)
 
 			case BC_LEX_KW_MODEXP:
 			case BC_LEX_KW_DIVMOD:
+#if BC_ENABLE_EXTRA_MATH
+			case BC_LEX_KW_MULMOD:
+			case BC_LEX_KW_INVMOD:
+			case BC_LEX_KW_GCDEXT:
+#endif // BC_ENABLE_EXTRA_MATH
 			{
 				// This is a leaf and cannot come right after a leaf.
 				if (BC_ERR(BC_PARSE_LEAF(prev, bin_last, rprn)))
@@ -752,6 +752,11 @@ const char* bc_inst_names[] = {
 	"BC_INST_SWAP",
 	"BC_INST_MODEXP",
 	"BC_INST_DIVMOD",
+#if BC_ENABLE_EXTRA_MATH
+	"BC_INST_MULMOD",
+	"BC_INST_INVMOD",
+	"BC_INST_GCDEXT",
+#endif // BC_ENABLE_EXTRA_MATH
 	"BC_INST_PRINT_STREAM",
 
 #if DC_ENABLED
@@ -820,6 +825,11 @@ const BcLexKeyword bc_lex_kws[] = {
 	BC_LEX_KW_ENTRY("asciify", 7, false),
 	BC_LEX_KW_ENTRY("modexp", 6, false),
 	BC_LEX_KW_ENTRY("divmod", 6, false),
+#if BC_ENABLE_EXTRA_MATH
+	BC_LEX_KW_ENTRY("mulmod", 6, false),
+	BC_LEX_KW_ENTRY("invmod", 6, false),
+	BC_LEX_KW_ENTRY("gcdext", 6, false),
+#endif // BC_ENABLE_EXTRA_MATH
 	BC_LEX_KW_ENTRY("quit", 4, true),
 	BC_LEX_KW_ENTRY("read", 4, false),
 #if BC_ENABLE_EXTRA_MATH
@@ -888,11 +898,11 @@ const uint8_t bc_parse_exprs[] = {
 	// Starts with BC_LEX_KW_SQRT.
 	BC_PARSE_EXPR_ENTRY(true, true, true, true, true, true, true, true),
 
-	// Starts with BC_LEX_KW_QUIT.
-	BC_PARSE_EXPR_ENTRY(false, true, true, true, true, true, true, true),
+	// Starts with BC_LEX_KW_MULMOD.
+	BC_PARSE_EXPR_ENTRY(true, true, true, false, true, true, true, true),
 
-	// Starts with BC_LEX_KW_GLOBAL_STACKS.
-	BC_PARSE_EXPR_ENTRY(true, true, false, false, 0, 0, 0, 0)
+	// Starts with BC_LEX_KW_MAXSCALE.
+	BC_PARSE_EXPR_ENTRY(true, true, true, true, true, false, false, 0)
 
 #else // BC_ENABLE_EXTRA_MATH
 
@@ -1198,8 +1208,12 @@ const uchar dc_parse_insts[] = {
 	BC_INST_IRAND,
 #endif // BC_ENABLE_EXTRA_MATH
 	BC_INST_ASCIIFY,      BC_INST_MODEXP,
-	BC_INST_DIVMOD,       BC_INST_QUIT,
+	BC_INST_DIVMOD,
+#if BC_ENABLE_EXTRA_MATH
+	BC_INST_INVALID,      BC_INST_INVALID,
 	BC_INST_INVALID,
+#endif // BC_ENABLE_EXTRA_MATH
+	BC_INST_QUIT,         BC_INST_INVALID,
 #if BC_ENABLE_EXTRA_MATH
 	BC_INST_RAND,
 #endif // BC_ENABLE_EXTRA_MATH
@@ -1291,6 +1305,14 @@ const size_t bc_num_bigdigMax2_size = sizeof(bc_num_bigdigMax2) / sizeof(BcDig);
 /// A string of digits for easy conversion from characters to digits.
 const char bc_num_hex_digits[] = "0123456789ABCDEF";
 
+/// The arctangent of 1 to 64 places, as the math library has it.
+const char bc_num_atan1[] =
+	".7853981633974483096156608458198757210492923498437764552437361480";
+
+/// The arctangent of .2 to 64 places, as the math library has it.
+const char bc_num_atan_fifth[] =
+	".1973955598498807583700497651947902934475851037878521015176889402";
+
 // clang-format off
 
 /// An array for easy conversion from exponent to power of 10.
@@ -1311,6 +1333,26 @@ const BcBigDig bc_num_pow10[BC_BASE_DIGS + 1] = {
 
 // clang-format on
 
+/// The primes for the number-theoretic transform. They all have 3 as a
+/// primitive root and at least BC_NUM_NTT_MAX_LOG factors of 2 in p-1, and they
+/// are small enough that Montgomery multiplication never overflows 64 bits.
+const uint32_t bc_num_ntt_primes[BC_NUM_NTT_PRIMES] = {
+	998244353,
+	167772161,
+	469762049,
+};
+
+/// The names of the levels of vector instructions for the limb kernels, as they
+/// are given in the environment.
+const char* const bc_num_levels[BC_NUM_LEVEL_NUM] = {
+	"scalar",
+#if BC_NUM_DISPATCH
+	"sse4.2",
+	"avx2",
+	"avx512",
+#endif // BC_NUM_DISPATCH
+};
+
 #if !BC_ENABLE_LIBRARY
 
 /// An array of functions for binary operators corresponding to the order of
@@ -332,6 +332,11 @@ dc_parse_token(BcParse* p, BcLexType t, uint8_t flags)
 		case BC_LEX_KW_ASCIIFY:
 		case BC_LEX_KW_MODEXP:
 		case BC_LEX_KW_DIVMOD:
+#if BC_ENABLE_EXTRA_MATH
+		case BC_LEX_KW_MULMOD:
+		case BC_LEX_KW_INVMOD:
+		case BC_LEX_KW_GCDEXT:
+#endif // BC_ENABLE_EXTRA_MATH
 		case BC_LEX_KW_QUIT:
 #if BC_ENABLE_EXTRA_MATH
 		case BC_LEX_KW_RAND:
@@ -109,6 +109,7 @@ bc_func_init(BcFunc* f, const char* name)
 
 		f->nparams = 0;
 		f->voidfn = false;
+		f->native = false;
 	}
 
 #endif // BC_ENABLED
@@ -132,6 +133,7 @@ bc_func_reset(BcFunc* f)
 
 		f->nparams = 0;
 		f->voidfn = false;
+		f->native = false;
 	}
 #endif // BC_ENABLED
 }
@@ -88,6 +88,8 @@ static BclTls tls_real;
 BclError
 bcl_start(void)
 {
+	char* kernels;
+
 #ifndef _WIN32
 
 	int r;
@@ -109,6 +111,12 @@ bcl_start(void)
 
 #endif // _WIN32
 
+	// Pick the limb kernels for this CPU. They are process-wide, so this is
+	// done here, once, before any thread can use them.
+	kernels = bc_vm_getenv(BC_VM_KERNELS_STR);
+	bc_num_kernelsInit(kernels);
+	bc_vm_getenvFree(kernels);
+
 	tls = &tls_real;
 
 	return BCL_ERROR_NONE;
@@ -293,6 +301,15 @@ bcl_free(void)
 	bc_rand_free(&vm->rng);
 #endif // BC_ENABLE_EXTRA_MATH
 	bc_vec_free(&vm->out);
+	bc_vec_free(&vm->pows);
+	bc_vec_free(&vm->bin_pows);
+	bc_num_free(&vm->mod.c);
+	bc_num_free(&vm->mod.m);
+
+	for (i = 0; i < BC_NUM_CONST_NUM; ++i)
+	{
+		bc_num_free(&vm->consts[i]);
+	}
 
 	for (i = 0; i < vm->ctxts.len; ++i)
 	{
@@ -302,6 +319,10 @@ bcl_free(void)
 
 	bc_vec_free(&vm->ctxts);
 
+	// Numbers with the default capacity, like the caches above, are freed into
+	// the pool of temps, so it has to be emptied before the VM goes away.
+	bc_vm_freeTemps();
+
 	bc_vm_atexit();
 
 	free(vm);
@@ -1172,8 +1193,19 @@ bcl_divmod_keep(BclNumber a, BclNumber b, BclNumber* c, BclNumber* d)
 	return bcl_divmod_helper(a, b, c, d, false);
 }
 
+/**
+ * Sets up and executes a modular operator with three operands, like modular
+ * exponentiation.
+ * @param a         The first operand.
+ * @param b         The second operand.
+ * @param c         The modulus.
+ * @param op        The operation.
+ * @param destruct  True if the parameters should be consumed, false otherwise.
+ * @return          The result of the operation.
+ */
 static BclNumber
-bcl_modexp_helper(BclNumber a, BclNumber b, BclNumber c, bool destruct)
+bcl_modexp_helper(BclNumber a, BclNumber b, BclNumber c, const BcNumModOp op,
+                  bool destruct)
 {
 	BclError e = BCL_ERROR_NONE;
 	size_t req;
@@ -1214,8 +1246,8 @@ bcl_modexp_helper(BclNumber a, BclNumber b, BclNumber c, bool destruct)
 	// Initialize the result.
 	bc_num_init(BCL_NUM_NUM_NP(d), req);
 
-	bc_num_modexp(BCL_NUM_NUM(aptr), BCL_NUM_NUM(bptr), BCL_NUM_NUM(cptr),
-	              BCL_NUM_NUM_NP(d));
+	op(BCL_NUM_NUM(aptr), BCL_NUM_NUM(bptr), BCL_NUM_NUM(cptr),
+	   BCL_NUM_NUM_NP(d));
 
 err:
 
@@ -1236,13 +1268,165 @@ err:
 BclNumber
 bcl_modexp(BclNumber a, BclNumber b, BclNumber c)
 {
-	return bcl_modexp_helper(a, b, c, true);
+	return bcl_modexp_helper(a, b, c, bc_num_modexp, true);
 }
 
 BclNumber
 bcl_modexp_keep(BclNumber a, BclNumber b, BclNumber c)
 {
-	return bcl_modexp_helper(a, b, c, false);
+	return bcl_modexp_helper(a, b, c, bc_num_modexp, false);
+}
+
+BclNumber
+bcl_mulmod(BclNumber a, BclNumber b, BclNumber c)
+{
+	return bcl_modexp_helper(a, b, c, bc_num_mulmod, true);
+}
+
+BclNumber
+bcl_mulmod_keep(BclNumber a, BclNumber b, BclNumber c)
+{
+	return bcl_modexp_helper(a, b, c, bc_num_mulmod, false);
+}
+
+BclNumber
+bcl_invmod(BclNumber a, BclNumber b)
+{
+	return bcl_binary(a, b, bc_num_invmod, bc_num_mulReq, true);
+}
+
+BclNumber
+bcl_invmod_keep(BclNumber a, BclNumber b)
+{
+	return bcl_binary(a, b, bc_num_invmod, bc_num_mulReq, false);
+}
+
+BclNumber
+bcl_gcd(BclNumber a, BclNumber b)
+{
+	return bcl_binary(a, b, bc_num_gcd, bc_num_mulReq, true);
+}
+
+BclNumber
+bcl_gcd_keep(BclNumber a, BclNumber b)
+{
+	return bcl_binary(a, b, bc_num_gcd, bc_num_mulReq, false);
+}
+
+BclNumber
+bcl_lcm(BclNumber a, BclNumber b)
+{
+	return bcl_binary(a, b, bc_num_lcm, bc_num_mulReq, true);
+}
+
+BclNumber
+bcl_lcm_keep(BclNumber a, BclNumber b)
+{
+	return bcl_binary(a, b, bc_num_lcm, bc_num_mulReq, false);
+}
+
+/**
+ * Sets up and executes an extended GCD.
+ * @param a         The first operand.
+ * @param b         The second operand.
+ * @param g         An out parameter for the GCD.
+ * @param x         An out parameter for the coefficient of @a a.
+ * @param y         An out parameter for the coefficient of @a b.
+ * @param destruct  True if the parameters should be consumed, false otherwise.
+ * @return          An error code, if any.
+ */
+static BclError
+bcl_gcdext_helper(BclNumber a, BclNumber b, BclNumber* g, BclNumber* x,
+                  BclNumber* y, bool destruct)
+{
+	BclError e = BCL_ERROR_NONE;
+	size_t req;
+	BclNum* aptr;
+	BclNum* bptr;
+	BclNum gnum, xnum, ynum;
+	BclContext ctxt;
+	BcVm* vm = bcl_getspecific();
+
+	BC_CHECK_CTXT_ERR(vm, ctxt);
+
+	BC_CHECK_NUM_ERR(ctxt, a);
+	BC_CHECK_NUM_ERR(ctxt, b);
+
+	BC_FUNC_HEADER(vm, err);
+
+	BCL_GROW_NUMS(ctxt);
+
+	assert(g != NULL && x != NULL && y != NULL);
+
+	aptr = BCL_NUM(ctxt, a);
+	bptr = BCL_NUM(ctxt, b);
+
+	assert(aptr != NULL && bptr != NULL);
+	assert(BCL_NUM_ARRAY(aptr) != NULL && BCL_NUM_ARRAY(bptr) != NULL);
+
+	bc_num_clear(BCL_NUM_NUM_NP(gnum));
+	bc_num_clear(BCL_NUM_NUM_NP(xnum));
+	bc_num_clear(BCL_NUM_NUM_NP(ynum));
+
+	// The GCD and the coefficients are no longer than the larger operand.
+	req = BC_MAX(BCL_NUM_NUM(aptr)->len, BCL_NUM_NUM(bptr)->len);
+
+	// Initialize the numbers.
+	bc_num_init(BCL_NUM_NUM_NP(gnum), req);
+	bc_num_init(BCL_NUM_NUM_NP(xnum), req);
+	bc_num_init(BCL_NUM_NUM_NP(ynum), req);
+
+	bc_num_gcdext(BCL_NUM_NUM(aptr), BCL_NUM_NUM(bptr), BCL_NUM_NUM_NP(gnum),
+	              BCL_NUM_NUM_NP(xnum), BCL_NUM_NUM_NP(ynum));
+
+err:
+
+	if (destruct)
+	{
+		// Eat the operands.
+		bcl_num_dtor(ctxt, a, aptr);
+		if (b.i != a.i) bcl_num_dtor(ctxt, b, bptr);
+	}
+
+	// If there was an error...
+	if (BC_ERR(vm->err))
+	{
+		// Free the results.
+		if (BCL_NUM_ARRAY_NP(gnum) != NULL) bc_num_free(&gnum);
+		if (BCL_NUM_ARRAY_NP(xnum) != NULL) bc_num_free(&xnum);
+		if (BCL_NUM_ARRAY_NP(ynum) != NULL) bc_num_free(&ynum);
+
+		// Make sure the return values are invalid.
+		g->i = 0 - (size_t) BCL_ERROR_INVALID_NUM;
+		x->i = g->i;
+		y->i = g->i;
+
+		BC_FUNC_FOOTER(vm, e);
+	}
+	else
+	{
+		BC_FUNC_FOOTER(vm, e);
+
+		// Insert the results into the context.
+		*g = bcl_num_insert(ctxt, &gnum);
+		*x = bcl_num_insert(ctxt, &xnum);
+		*y = bcl_num_insert(ctxt, &ynum);
+	}
+
+	return e;
+}
+
+BclError
+bcl_gcdext(BclNumber a, BclNumber b, BclNumber* g, BclNumber* x, BclNumber* y)
+{
+	return bcl_gcdext_helper(a, b, g, x, y, true);
+}
+
+BclError
+bcl_gcdext_keep(BclNumber a, BclNumber b, BclNumber* g, BclNumber* x,
+                BclNumber* y)
+{
+	return bcl_gcdext_helper(a, b, g, x, y, false);
 }
 
 ssize_t
@@ -54,6 +54,9 @@
 static void
 bc_num_m(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale);
 
+static void
+bc_num_k(const BcNum* a, const BcNum* b, BcNum* restrict c);
+
 /**
  * Multiply two numbers and throw a math error if they overflow.
  * @param a  The first operand.
@@ -303,6 +306,275 @@ bc_num_subDigits(BcDig a, BcDig b, bool* carry)
 	return a - b;
 }
 
+#if BC_NUM_DISPATCH
+
+/// The limb kernels are always inlined into a copy for each level of vector
+/// instructions, so that each copy is compiled for the instructions of its
+/// level.
+#define BC_NUM_KERNEL static inline __attribute__((always_inline))
+
+#else // BC_NUM_DISPATCH
+
+/// There is only one level, so the limb kernels are ordinary functions.
+#define BC_NUM_KERNEL static inline
+
+#endif // BC_NUM_DISPATCH
+
+/**
+ * Adds blocks of BC_NUM_ADD_BLOCK limbs of @a a and @a b into @a c with a carry
+ * in and returns the carry out. @a c may be @a a. Instead of rippling the carry
+ * through every limb, this does the limbs independently in passes that have no
+ * dependencies between limbs, so the compiler can vectorize them: add and take
+ * out the carries, then add the carries to the next limbs. Adding a carry can
+ * only overflow a limb that was BC_BASE_POW - 1 and did not make a carry
+ * itself, so that is rare, and a scalar pass fixes it only when it happens.
+ * @param c      The return array.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param carry  The carry in.
+ * @return       The carry out.
+ */
+BC_NUM_KERNEL bool
+bc_num_addBlock(BcDig* c, const BcDig* a, const BcDig* b, bool carry)
+{
+	BcDig s[BC_NUM_ADD_BLOCK];
+	BcDig g[BC_NUM_ADD_BLOCK + 1];
+	BcDig over = 0;
+	size_t i;
+
+	assert(((BcBigDig) BC_BASE_POW) * 2 == ((BcDig) BC_BASE_POW) * 2);
+
+	// The carry into limb i is g[i].
+	g[0] = carry;
+
+	for (i = 0; i < BC_NUM_ADD_BLOCK; ++i)
+	{
+		BcDig sum = a[i] + b[i];
+
+		g[i + 1] = (sum >= BC_BASE_POW);
+		s[i] = sum - (BC_BASE_POW & -g[i + 1]);
+	}
+
+	for (i = 0; i < BC_NUM_ADD_BLOCK; ++i)
+	{
+		s[i] += g[i];
+		over |= (s[i] == BC_BASE_POW);
+	}
+
+	carry = g[BC_NUM_ADD_BLOCK];
+
+	if (BC_ERR(over))
+	{
+		// A limb that overflowed did not carry before, so the next limb has
+		// room for this carry, though it might overflow in turn.
+		for (i = 0; i < BC_NUM_ADD_BLOCK; ++i)
+		{
+			if (s[i] != BC_BASE_POW) continue;
+
+			s[i] = 0;
+
+			if (i + 1 < BC_NUM_ADD_BLOCK) s[i + 1] += 1;
+			else carry = true;
+		}
+	}
+
+	// NOLINTNEXTLINE
+	memcpy(c, s, BC_NUM_SIZE(BC_NUM_ADD_BLOCK));
+
+	return carry;
+}
+
+/**
+ * Subtracts blocks of BC_NUM_ADD_BLOCK limbs of @a b from @a a into @a c with a
+ * borrow in and returns the borrow out. @a c may be @a a. This works like
+ * bc_num_addBlock(); only a limb that was 0 and did not borrow itself can
+ * underflow when the borrow from the previous limb is taken out.
+ * @param c      The return array.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param carry  The borrow in.
+ * @return       The borrow out.
+ */
+BC_NUM_KERNEL bool
+bc_num_subBlock(BcDig* c, const BcDig* a, const BcDig* b, bool carry)
+{
+	BcDig s[BC_NUM_ADD_BLOCK];
+	BcDig g[BC_NUM_ADD_BLOCK + 1];
+	BcDig under = 0;
+	size_t i;
+
+	// The borrow from limb i is g[i].
+	g[0] = carry;
+
+	for (i = 0; i < BC_NUM_ADD_BLOCK; ++i)
+	{
+		BcDig diff = a[i] - b[i];
+
+		g[i + 1] = (diff < 0);
+		s[i] = diff + (BC_BASE_POW & -g[i + 1]);
+	}
+
+	for (i = 0; i < BC_NUM_ADD_BLOCK; ++i)
+	{
+		s[i] -= g[i];
+		under |= (s[i] < 0);
+	}
+
+	carry = g[BC_NUM_ADD_BLOCK];
+
+	if (BC_ERR(under))
+	{
+		for (i = 0; i < BC_NUM_ADD_BLOCK; ++i)
+		{
+			if (s[i] >= 0) continue;
+
+			s[i] = BC_BASE_POW - 1;
+
+			if (i + 1 < BC_NUM_ADD_BLOCK) s[i + 1] -= 1;
+			else carry = true;
+		}
+	}
+
+	// NOLINTNEXTLINE
+	memcpy(c, s, BC_NUM_SIZE(BC_NUM_ADD_BLOCK));
+
+	return carry;
+}
+
+/**
+ * Adds a run of limb products from one column of the lattice to a column sum.
+ * The products are the limbs of @a a going up times the limbs of @a b going
+ * down. Instead of checking the sum for overflow after every product, the
+ * products are summed in chunks of BC_NUM_MUL_CHUNK, which cannot overflow, and
+ * the sum is only normalized between chunks. Full chunks have no branches and a
+ * fixed length, so compilers can vectorize them.
+ * @param a      The first limb of the first operand.
+ * @param b      The first limb of the second operand. The next ones are below
+ *               it.
+ * @param n      The number of products.
+ * @param sum    An in/out parameter; the column sum. It must be less than
+ *               BC_BASE_POW or a carry coming in, and it is not normalized on
+ *               return.
+ * @param carry  An in/out parameter; what carries into the next column.
+ */
+static void
+bc_num_mulColumn(const BcDig* restrict a, const BcDig* restrict b, size_t n,
+                 BcBigDig* restrict sum, BcBigDig* restrict carry)
+{
+	BcBigDig s = *sum;
+
+	while (n)
+	{
+		size_t i, len = BC_MIN(n, BC_NUM_MUL_CHUNK);
+
+		// Normalize before the chunk so the chunk cannot overflow.
+		if (s >= BC_BASE_POW)
+		{
+			*carry += s / BC_BASE_POW;
+			s %= BC_BASE_POW;
+		}
+
+		// Limbs are never negative, and converting through an unsigned 32-bit
+		// type lets compilers use unsigned widening multiplies.
+		if (len == BC_NUM_MUL_CHUNK)
+		{
+			for (i = 0; i < BC_NUM_MUL_CHUNK; ++i)
+			{
+				s += ((BcBigDig) (uint32_t) a[i]) *
+				     ((BcBigDig) (uint32_t) *(b - i));
+			}
+		}
+		else
+		{
+			for (i = 0; i < len; ++i)
+			{
+				s += ((BcBigDig) (uint32_t) a[i]) *
+				     ((BcBigDig) (uint32_t) *(b - i));
+			}
+		}
+
+		a += len;
+		b -= len;
+		n -= len;
+	}
+
+	*sum = s;
+}
+
+/**
+ * Defines the copies of the limb kernels for one level of vector instructions.
+ * @param l     The name of the level.
+ * @param attr  The attribute that selects the instructions of the level.
+ */
+#define BC_NUM_KERNELS(l, attr)                                                \
+	static attr bool bc_num_addBlock_##l(BcDig* c, const BcDig* a,            \
+	                                     const BcDig* b, bool carry)          \
+	{                                                                          \
+		return bc_num_addBlock(c, a, b, carry);                                \
+	}                                                                          \
+	static attr bool bc_num_subBlock_##l(BcDig* c, const BcDig* a,            \
+	                                     const BcDig* b, bool carry)          \
+	{                                                                          \
+		return bc_num_subBlock(c, a, b, carry);                                \
+	}
+
+/**
+ * Expands to the entry of the table of limb kernels for one level.
+ * @param l  The name of the level.
+ */
+#define BC_NUM_KERNELS_ENTRY(l) { bc_num_addBlock_##l, bc_num_subBlock_##l }
+
+BC_NUM_KERNELS(scalar, )
+
+#if BC_NUM_DISPATCH
+BC_NUM_KERNELS(sse42, __attribute__((target("sse4.2"))))
+BC_NUM_KERNELS(avx2, __attribute__((target("avx2"))))
+BC_NUM_KERNELS(avx512, __attribute__((target("avx512f"))))
+#endif // BC_NUM_DISPATCH
+
+/// The limb kernels for each level of vector instructions, in the order of
+/// BcNumLevel.
+static const BcNumKernels bc_num_kernels_table[BC_NUM_LEVEL_NUM] = {
+	BC_NUM_KERNELS_ENTRY(scalar),
+#if BC_NUM_DISPATCH
+	BC_NUM_KERNELS_ENTRY(sse42),
+	BC_NUM_KERNELS_ENTRY(avx2),
+	BC_NUM_KERNELS_ENTRY(avx512),
+#endif // BC_NUM_DISPATCH
+};
+
+/// The limb kernels in use. Until bc_num_kernelsInit() is called, these are
+/// the ones that work everywhere.
+static const BcNumKernels* bc_num_kernels = bc_num_kernels_table;
+
+void
+bc_num_kernelsInit(const char* name)
+{
+#if BC_NUM_DISPATCH
+
+	size_t i, level = BC_NUM_LEVEL_SCALAR;
+
+	__builtin_cpu_init();
+
+	// Find the best level. These also check that the OS saves the registers.
+	if (__builtin_cpu_supports("sse4.2")) level = BC_NUM_LEVEL_SSE42;
+	if (__builtin_cpu_supports("avx2")) level = BC_NUM_LEVEL_AVX2;
+	if (__builtin_cpu_supports("avx512f")) level = BC_NUM_LEVEL_AVX512;
+
+	// A lower level may be asked for, but not a higher one, since the CPU could
+	// not run it.
+	for (i = 0; name != NULL && i < level; ++i)
+	{
+		if (!strcmp(name, bc_num_levels[i])) level = i;
+	}
+
+	bc_num_kernels = bc_num_kernels_table + level;
+
+#else // BC_NUM_DISPATCH
+	BC_UNUSED(name);
+#endif // BC_NUM_DISPATCH
+}
+
 /**
  * Add two BcDig arrays and store the result in the first array.
  * @param a    The first operand and out array.
@@ -315,7 +587,12 @@ bc_num_addArrays(BcDig* restrict a, const BcDig* restrict b, size_t len)
 	size_t i;
 	bool carry = false;
 
-	for (i = 0; i < len; ++i)
+	for (i = 0; i + BC_NUM_ADD_BLOCK <= len; i += BC_NUM_ADD_BLOCK)
+	{
+		carry = bc_num_kernels->addBlock(a + i, a + i, b + i, carry);
+	}
+
+	for (; i < len; ++i)
 	{
 		a[i] = bc_num_addDigits(a[i], b[i], &carry);
 	}
@@ -339,7 +616,12 @@ bc_num_subArrays(BcDig* restrict a, const BcDig* restrict b, size_t len)
 	size_t i;
 	bool carry = false;
 
-	for (i = 0; i < len; ++i)
+	for (i = 0; i + BC_NUM_ADD_BLOCK <= len; i += BC_NUM_ADD_BLOCK)
+	{
+		carry = bc_num_kernels->subBlock(a + i, a + i, b + i, carry);
+	}
+
+	for (; i < len; ++i)
 	{
 		a[i] = bc_num_subDigits(a[i], b[i], &carry);
 	}
@@ -397,6 +679,65 @@ bc_num_mulArray(const BcNum* restrict a, BcBigDig b, BcNum* restrict c)
 	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
 }
 
+/**
+ * Precomputes the reciprocal of the divisor @a d.
+ * @param r  The return parameter for the reciprocal.
+ * @param d  The divisor. It must not be zero.
+ */
+static void
+bc_num_recipInit(BcNumRecip* restrict r, BcBigDig d)
+{
+	assert(d != 0);
+
+	r->d = d;
+
+#if BC_NUM_WIDE
+	r->m = BC_NUM_BIGDIG_MAX / d;
+#endif // BC_NUM_WIDE
+}
+
+/**
+ * Divides @a n by the divisor of @a r with a multiplication by the reciprocal.
+ * The reciprocal is rounded down, so the estimate of the quotient is at most
+ * n/2^b too small, where b is the number of bits in a BcBigDig. That is less
+ * than 1, so the estimate is either right or one too small, and one check of
+ * the remainder fixes it.
+ * @param r    The reciprocal of the divisor.
+ * @param n    The number to divide.
+ * @param rem  The return parameter for the remainder.
+ * @return     The quotient.
+ */
+static inline BcBigDig
+bc_num_recipDiv(const BcNumRecip* restrict r, BcBigDig n,
+                BcBigDig* restrict rem)
+{
+#if BC_NUM_WIDE
+
+	BcBigDig q, x;
+
+	q = (BcBigDig) ((((BcWideProd) n) * r->m) >>
+	                (sizeof(BcBigDig) * CHAR_BIT));
+	x = n - q * r->d;
+
+	if (x >= r->d)
+	{
+		q += 1;
+		x -= r->d;
+	}
+
+	*rem = x;
+
+	return q;
+
+#else // BC_NUM_WIDE
+
+	*rem = n % r->d;
+
+	return n / r->d;
+
+#endif // BC_NUM_WIDE
+}
+
 /**
  * Divide a BcNum array by a one-limb number. This is a faster version of divide
  * for when we can use it.
@@ -411,17 +752,19 @@ bc_num_divArray(const BcNum* restrict a, BcBigDig b, BcNum* restrict c,
 {
 	size_t i;
 	BcBigDig carry = 0;
+	BcNumRecip r;
 
 	assert(c->cap >= a->len);
 
+	bc_num_recipInit(&r, b);
+
 	// Actual division loop.
 	for (i = a->len - 1; i < a->len; --i)
 	{
 		BcBigDig in = ((BcBigDig) a->num[i]) + carry * BC_BASE_POW;
 		assert(in / b < BC_BASE_POW);
-		c->num[i] = (BcDig) (in / b);
+		c->num[i] = (BcDig) bc_num_recipDiv(&r, in, &carry);
 		assert(c->num[i] >= 0 && c->num[i] < BC_BASE_POW);
-		carry = in % b;
 	}
 
 	// Finishing touches.
@@ -435,6 +778,51 @@ bc_num_divArray(const BcNum* restrict a, BcBigDig b, BcNum* restrict c,
 	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
 }
 
+/**
+ * Divides a BcNum by a one-limb integer to at least @a scale decimal places.
+ * The dividend is padded with zero limbs below its radix so that a single pass
+ * of short division yields the truncated quotient; the caller is expected to
+ * retire the result to its final scale.
+ * @param a      The dividend.
+ * @param b      The one limb of the divisor.
+ * @param c      The return parameter for the quotient.
+ * @param scale  The scale the quotient needs.
+ */
+static void
+bc_num_divShort(const BcNum* restrict a, BcBigDig b, BcNum* restrict c,
+                size_t scale)
+{
+	size_t i, rdx, shift, len;
+	BcBigDig carry = 0;
+	BcNumRecip r;
+
+	rdx = BC_MAX(BC_NUM_RDX_VAL(a), BC_NUM_RDX(scale));
+	shift = rdx - BC_NUM_RDX_VAL(a);
+	len = bc_vm_growSize(a->len, shift);
+
+	bc_num_expand(c, len);
+
+	// NOLINTNEXTLINE
+	memset(c->num, 0, BC_NUM_SIZE(shift));
+	// NOLINTNEXTLINE
+	memcpy(c->num + shift, a->num, BC_NUM_SIZE(a->len));
+
+	c->len = len;
+	c->rdx = 0;
+	BC_NUM_RDX_SET(c, rdx);
+	c->scale = rdx * BC_BASE_DIGS;
+
+	bc_num_recipInit(&r, b);
+
+	for (i = len - 1; i < len; --i)
+	{
+		BcBigDig in = ((BcBigDig) c->num[i]) + carry * BC_BASE_POW;
+		c->num[i] = (BcDig) bc_num_recipDiv(&r, in, &carry);
+	}
+
+	bc_num_clean(c);
+}
+
 /**
  * Compare two BcDig arrays and return >0 if @a b is greater, <0 if @a b is
  * less, and 0 if equal. Both @a a and @a b must have the same length.
@@ -733,13 +1121,14 @@ static void
 bc_num_shift(BcNum* restrict n, BcBigDig dig)
 {
 	size_t i, len = n->len;
-	BcBigDig carry = 0, pow;
+	BcBigDig carry = 0;
 	BcDig* ptr = n->num;
+	BcNumRecip pow;
 
 	assert(dig < BC_BASE_DIGS);
 
 	// Figure out the parameters for division.
-	pow = bc_num_pow10[dig];
+	bc_num_recipInit(&pow, bc_num_pow10[dig]);
 	dig = bc_num_pow10[BC_BASE_DIGS - dig];
 
 	// Run a series of divisions and mods with carries across the entire number
@@ -749,8 +1138,7 @@ bc_num_shift(BcNum* restrict n, BcBigDig dig)
 		BcBigDig in, temp;
 		in = ((BcBigDig) ptr[i]);
 		temp = carry * dig;
-		carry = in % pow;
-		ptr[i] = ((BcDig) (in / pow)) + (BcDig) temp;
+		ptr[i] = ((BcDig) bc_num_recipDiv(&pow, in, &carry)) + (BcDig) temp;
 		assert(ptr[i] >= 0 && ptr[i] < BC_BASE_POW);
 	}
 
@@ -1142,7 +1530,12 @@ bc_num_as(BcNum* a, BcNum* b, BcNum* restrict c, size_t sub)
 	if (do_sub)
 	{
 		// Actual subtraction.
-		for (i = 0; i < min_len; ++i)
+		for (i = 0; i + BC_NUM_ADD_BLOCK <= min_len; i += BC_NUM_ADD_BLOCK)
+		{
+			carry = bc_num_kernels->subBlock(ptr_c + i, ptr_l + i, ptr_r + i, carry);
+		}
+
+		for (; i < min_len; ++i)
 		{
 			ptr_c[i] = bc_num_subDigits(ptr_l[i], ptr_r[i], &carry);
 		}
@@ -1156,7 +1549,12 @@ bc_num_as(BcNum* a, BcNum* b, BcNum* restrict c, size_t sub)
 	else
 	{
 		// Actual addition.
-		for (i = 0; i < min_len; ++i)
+		for (i = 0; i + BC_NUM_ADD_BLOCK <= min_len; i += BC_NUM_ADD_BLOCK)
+		{
+			carry = bc_num_kernels->addBlock(ptr_c + i, ptr_l + i, ptr_r + i, carry);
+		}
+
+		for (; i < min_len; ++i)
 		{
 			ptr_c[i] = bc_num_addDigits(ptr_l[i], ptr_r[i], &carry);
 		}
@@ -1183,3219 +1581,9349 @@ bc_num_as(BcNum* a, BcNum* b, BcNum* restrict c, size_t sub)
 	bc_num_clean(c);
 }
 
+#if BC_NUM_WIDE
+
 /**
- * The simple multiplication that karatsuba dishes out to when the length of the
- * numbers gets low enough. This doesn't use scale because it treats the
- * operands as though they are integers.
- * @param a  The first operand.
- * @param b  The second operand.
- * @param c  The return parameter.
+ * Packs pairs of limbs into wide limbs.
+ * @param w    The return array for the wide limbs.
+ * @param a    The limbs.
+ * @param len  The number of limbs.
+ * @return     The number of wide limbs.
  */
-static void
-bc_num_m_simp(const BcNum* a, const BcNum* b, BcNum* restrict c)
+static size_t
+bc_num_widen(BcWideDig* restrict w, const BcDig* restrict a, size_t len)
 {
-	size_t i, alen = a->len, blen = b->len, clen;
-	BcDig* ptr_a = a->num;
-	BcDig* ptr_b = b->num;
-	BcDig* ptr_c;
-	BcBigDig sum = 0, carry = 0;
-
-	assert(sizeof(sum) >= sizeof(BcDig) * 2);
-	assert(!BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b));
-
-	// Make sure c is big enough.
-	clen = bc_vm_growSize(alen, blen);
-	bc_num_expand(c, bc_vm_growSize(clen, 1));
-
-	// If we don't memset, then we might have uninitialized data use later.
-	ptr_c = c->num;
-	// NOLINTNEXTLINE
-	memset(ptr_c, 0, BC_NUM_SIZE(c->cap));
+	size_t i;
 
-	// This is the actual multiplication loop. It uses the lattice form of long
-	// multiplication (see the explanation on the web page at
-	// https://knilt.arcc.albany.edu/What_is_Lattice_Multiplication or the
-	// explanation at Wikipedia).
-	for (i = 0; i < clen; ++i)
+	for (i = 0; i + 1 < len; i += 2)
 	{
-		ssize_t sidx = (ssize_t) (i - blen + 1);
-		size_t j, k;
-
-		// These are the start indices.
-		j = (size_t) BC_MAX(0, sidx);
-		k = BC_MIN(i, blen - 1);
-
-		// On every iteration of this loop, a multiplication happens, then the
-		// sum is automatically calculated.
-		for (; j < alen && k < blen; ++j, --k)
-		{
-			sum += ((BcBigDig) ptr_a[j]) * ((BcBigDig) ptr_b[k]);
-
-			if (sum >= ((BcBigDig) BC_BASE_POW) * BC_BASE_POW)
-			{
-				carry += sum / BC_BASE_POW;
-				sum %= BC_BASE_POW;
-			}
-		}
-
-		// Calculate the carry.
-		if (sum >= BC_BASE_POW)
-		{
-			carry += sum / BC_BASE_POW;
-			sum %= BC_BASE_POW;
-		}
-
-		// Store and set up for next iteration.
-		ptr_c[i] = (BcDig) sum;
-		assert(ptr_c[i] < BC_BASE_POW);
-		sum = carry;
-		carry = 0;
+		w[i / 2] = ((BcWideDig) a[i]) + ((BcWideDig) a[i + 1]) * BC_BASE_POW;
 	}
 
-	// This should always be true because there should be no carry on the last
-	// digit; multiplication never goes above the sum of both lengths.
-	assert(!sum);
+	if (i < len) w[i / 2] = (BcWideDig) a[i];
 
-	c->len = clen;
+	return (len + 1) / 2;
 }
 
 /**
- * Does a shifted add or subtract for Karatsuba below. This calls either
- * bc_num_addArrays() or bc_num_subArrays().
- * @param n      An in/out parameter; the first operand and return parameter.
- * @param a      The second operand.
- * @param shift  The amount to shift @a n by when adding/subtracting.
- * @param op     The function to call, either bc_num_addArrays() or
- *               bc_num_subArrays().
+ * Stores one column of a product of wide limbs as two limbs and returns what
+ * carries into the next column.
+ * @param c     The limbs of the product.
+ * @param clen  The number of limbs in the product.
+ * @param i     The index of the column.
+ * @param sum   The sum of the column.
+ * @return      The carry.
  */
-static void
-bc_num_shiftAddSub(BcNum* restrict n, const BcNum* restrict a, size_t shift,
-                   BcNumShiftAddOp op)
+static BcWideProd
+bc_num_narrow(BcDig* restrict c, size_t clen, size_t i, BcWideProd sum)
 {
-	assert(n->len >= shift + a->len);
-	assert(!BC_NUM_RDX_VAL(n) && !BC_NUM_RDX_VAL(a));
-	op(n->num + shift, a->num, a->len);
+	BcWideProd carry = sum / BC_NUM_WIDE_POW;
+	BcWideDig w = (BcWideDig) (sum - carry * BC_NUM_WIDE_POW);
+
+	// The top limb of the top column is past the product when both operands
+	// have an odd number of limbs, and then it must be zero.
+	c[2 * i] = (BcDig) (w % BC_BASE_POW);
+	if (2 * i + 1 < clen) c[2 * i + 1] = (BcDig) (w / BC_BASE_POW);
+	else assert(w / BC_BASE_POW == 0);
+
+	return carry;
 }
 
 /**
- * Implements the Karatsuba algorithm.
+ * Does simple multiplication in wide limbs, which holds two limbs each, so it
+ * only needs a quarter of the products. @a a and @a b must have at most
+ * BC_NUM_WIDE_LEN limbs. Like bc_num_mulCols(), it can start at a column other
+ * than 0, and then it leaves out the carries from the columns below.
+ * @param a     The limbs of the first operand.
+ * @param alen  The number of limbs in @a a.
+ * @param b     The limbs of the second operand.
+ * @param blen  The number of limbs in @a b.
+ * @param c     The return array for the limbs of the product. It must have
+ *              room for alen + blen limbs.
+ * @param lo    The first column, in wide limbs, to compute.
  */
 static void
-bc_num_k(const BcNum* a, const BcNum* b, BcNum* restrict c)
+bc_num_m_wide(const BcDig* a, size_t alen, const BcDig* b, size_t blen,
+              BcDig* restrict c, size_t lo)
 {
-	size_t max, max2, total;
-	BcNum l1, h1, l2, h2, m2, m1, z0, z1, z2, temp;
-	BcDig* digs;
-	BcDig* dig_ptr;
-	BcNumShiftAddOp op;
-	bool aone = BC_NUM_ONE(a);
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+	BcWideDig wa[BC_NUM_WIDE_LEN / 2], wb[BC_NUM_WIDE_LEN / 2];
+	size_t i, walen, wblen, wclen;
+	BcWideProd carry = 0;
 
-	assert(BC_NUM_ZERO(c));
+	assert(alen <= BC_NUM_WIDE_LEN && blen <= BC_NUM_WIDE_LEN);
 
-	if (BC_NUM_ZERO(a) || BC_NUM_ZERO(b)) return;
+	walen = bc_num_widen(wa, a, alen);
+	wblen = bc_num_widen(wb, b, blen);
+	wclen = walen + wblen;
 
-	if (aone || BC_NUM_ONE(b))
+	// This is the same lattice as bc_num_m_simp().
+	for (i = lo; i < wclen; ++i)
 	{
-		bc_num_copy(c, aone ? b : a);
-		if ((aone && BC_NUM_NEG(a)) || BC_NUM_NEG(b)) BC_NUM_NEG_TGL(c);
-		return;
-	}
+		ssize_t sidx = (ssize_t) (i - wblen + 1);
+		size_t j, k;
+		BcWideProd sum = carry;
 
-	// Shell out to the simple algorithm with certain conditions.
-	if (a->len < BC_NUM_KARATSUBA_LEN || b->len < BC_NUM_KARATSUBA_LEN)
-	{
-		bc_num_m_simp(a, b, c);
-		return;
-	}
-
-	// We need to calculate the max size of the numbers that can result from the
-	// operations.
-	max = BC_MAX(a->len, b->len);
-	max = BC_MAX(max, BC_NUM_DEF_SIZE);
-	max2 = (max + 1) / 2;
-
-	// Calculate the space needed for all of the temporary allocations. We do
-	// this to just allocate once.
-	total = bc_vm_arraySize(BC_NUM_KARATSUBA_ALLOCS, max);
-
-	BC_SIG_LOCK;
-
-	// Allocate space for all of the temporaries.
-	digs = dig_ptr = bc_vm_malloc(BC_NUM_SIZE(total));
-
-	// Set up the temporaries.
-	bc_num_setup(&l1, dig_ptr, max);
-	dig_ptr += max;
-	bc_num_setup(&h1, dig_ptr, max);
-	dig_ptr += max;
-	bc_num_setup(&l2, dig_ptr, max);
-	dig_ptr += max;
-	bc_num_setup(&h2, dig_ptr, max);
-	dig_ptr += max;
-	bc_num_setup(&m1, dig_ptr, max);
-	dig_ptr += max;
-	bc_num_setup(&m2, dig_ptr, max);
-
-	// Some temporaries need the ability to grow, so we allocate them
-	// separately.
-	max = bc_vm_growSize(max, 1);
-	bc_num_init(&z0, max);
-	bc_num_init(&z1, max);
-	bc_num_init(&z2, max);
-	max = bc_vm_growSize(max, max) + 1;
-	bc_num_init(&temp, max);
-
-	BC_SETJMP_LOCKED(vm, err);
-
-	BC_SIG_UNLOCK;
-
-	// First, set up c.
-	bc_num_expand(c, max);
-	c->len = max;
-	// NOLINTNEXTLINE
-	memset(c->num, 0, BC_NUM_SIZE(c->len));
+		j = (size_t) BC_MAX(0, sidx);
+		k = BC_MIN(i, wblen - 1);
 
-	// Split the parameters.
-	bc_num_split(a, max2, &l1, &h1);
-	bc_num_split(b, max2, &l2, &h2);
+		for (; j < walen && k < wblen; ++j, --k)
+		{
+			sum += ((BcWideProd) wa[j]) * wb[k];
+		}
 
-	// Do the subtraction.
-	bc_num_sub(&h1, &l1, &m1, 0);
-	bc_num_sub(&l2, &h2, &m2, 0);
+		carry = bc_num_narrow(c, alen + blen, i, sum);
+	}
 
-	// The if statements below are there for efficiency reasons. The best way to
-	// understand them is to understand the Karatsuba algorithm because now that
-	// the ollocations and splits are done, the algorithm is pretty
-	// straightforward.
+	assert(!carry);
+}
 
-	if (BC_NUM_NONZERO(&h1) && BC_NUM_NONZERO(&h2))
-	{
-		assert(BC_NUM_RDX_VALID_NP(h1));
-		assert(BC_NUM_RDX_VALID_NP(h2));
+/**
+ * Does simple squaring in wide limbs. It is the same as bc_num_m_wide(), but
+ * with the products doubled like bc_num_sqr_simp(). @a a must have at most
+ * BC_NUM_WIDE_LEN limbs.
+ * @param a     The limbs of the operand.
+ * @param alen  The number of limbs in @a a.
+ * @param c     The return array for the limbs of the square. It must have room
+ *              for 2 * alen limbs.
+ */
+static void
+bc_num_sqr_wide(const BcDig* a, size_t alen, BcDig* restrict c)
+{
+	BcWideDig wa[BC_NUM_WIDE_LEN / 2];
+	size_t i, walen, wclen;
+	BcWideProd carry = 0;
 
-		bc_num_m(&h1, &h2, &z2, 0);
-		bc_num_clean(&z2);
+	assert(alen <= BC_NUM_WIDE_LEN);
 
-		bc_num_shiftAddSub(c, &z2, max2 * 2, bc_num_addArrays);
-		bc_num_shiftAddSub(c, &z2, max2, bc_num_addArrays);
-	}
+	walen = bc_num_widen(wa, a, alen);
+	wclen = 2 * walen;
 
-	if (BC_NUM_NONZERO(&l1) && BC_NUM_NONZERO(&l2))
+	for (i = 0; i < wclen; ++i)
 	{
-		assert(BC_NUM_RDX_VALID_NP(l1));
-		assert(BC_NUM_RDX_VALID_NP(l2));
+		ssize_t sidx = (ssize_t) (i - walen + 1);
+		size_t j, k;
+		BcWideProd sum = 0;
 
-		bc_num_m(&l1, &l2, &z0, 0);
-		bc_num_clean(&z0);
+		j = (size_t) BC_MAX(0, sidx);
+		k = i - j;
 
-		bc_num_shiftAddSub(c, &z0, max2, bc_num_addArrays);
-		bc_num_shiftAddSub(c, &z0, 0, bc_num_addArrays);
-	}
+		for (; j < k; ++j, --k)
+		{
+			sum += ((BcWideProd) wa[j]) * wa[k];
+		}
 
-	if (BC_NUM_NONZERO(&m1) && BC_NUM_NONZERO(&m2))
-	{
-		assert(BC_NUM_RDX_VALID_NP(m1));
-		assert(BC_NUM_RDX_VALID_NP(m1));
+		sum = sum * 2 + carry;
 
-		bc_num_m(&m1, &m2, &z1, 0);
-		bc_num_clean(&z1);
+		if (j == k) sum += ((BcWideProd) wa[j]) * wa[j];
 
-		op = (BC_NUM_NEG_NP(m1) != BC_NUM_NEG_NP(m2)) ?
-		         bc_num_subArrays :
-		         bc_num_addArrays;
-		bc_num_shiftAddSub(c, &z1, max2, op);
+		carry = bc_num_narrow(c, 2 * alen, i, sum);
 	}
 
-err:
-	BC_SIG_MAYLOCK;
-	free(digs);
-	bc_num_free(&temp);
-	bc_num_free(&z2);
-	bc_num_free(&z1);
-	bc_num_free(&z0);
-	BC_LONGJMP_CONT(vm);
+	assert(!carry);
 }
 
+#endif // BC_NUM_WIDE
+
 /**
- * Does checks for Karatsuba. It also changes things to ensure that the
- * Karatsuba and simple multiplication can treat the numbers as integers. This
- * is a BcNumBinOp function.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter.
- * @param scale  The current scale.
+ * Computes columns @a lo and up of the product of @a a and @a b. This is the
+ * actual multiplication loop. It uses the lattice form of long multiplication
+ * (see the explanation on the web page at
+ * https://knilt.arcc.albany.edu/What_is_Lattice_Multiplication or the
+ * explanation at Wikipedia). The carries out of the columns below @a lo are
+ * left out, so unless @a lo is 0, the result can be too small, and the limbs
+ * of @a c below @a lo are not touched.
+ * @param a     The first operand.
+ * @param alen  The length of @a a.
+ * @param b     The second operand.
+ * @param blen  The length of @a b.
+ * @param c     The return array. It must have room for alen + blen limbs.
+ * @param lo    The first column to compute.
  */
 static void
-bc_num_m(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+bc_num_mulCols(const BcDig* a, size_t alen, const BcDig* b, size_t blen,
+               BcDig* restrict c, size_t lo)
 {
-	BcNum cpa, cpb;
-	size_t ascale, bscale, ardx, brdx, zero, len, rscale;
-	// These are meant to quiet warnings on GCC about longjmp() clobbering.
-	// The problem is real here.
-	size_t scale1, scale2, realscale;
-	// These are meant to quiet the GCC longjmp() clobbering, even though it
-	// does not apply here.
-	volatile size_t azero;
-	volatile size_t bzero;
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
-
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-
-	bc_num_zero(c);
-
-	ascale = a->scale;
-	bscale = b->scale;
+	size_t i, clen = alen + blen;
+	BcBigDig sum = 0, carry = 0;
 
-	// This sets the final scale according to the bc spec.
-	scale1 = BC_MAX(scale, ascale);
-	scale2 = BC_MAX(scale1, bscale);
-	rscale = ascale + bscale;
-	realscale = BC_MIN(rscale, scale2);
+	assert(sizeof(sum) >= sizeof(BcDig) * 2);
 
-	// If this condition is true, we can use bc_num_mulArray(), which would be
-	// much faster.
-	if ((a->len == 1 || b->len == 1) && !a->rdx && !b->rdx)
+	for (i = lo; i < clen; ++i)
 	{
-		BcNum* operand;
-		BcBigDig dig;
+		ssize_t sidx = (ssize_t) (i - blen + 1);
+		size_t j, k;
 
-		// Set the correct operands.
-		if (a->len == 1)
+		// These are the start indices.
+		j = (size_t) BC_MAX(0, sidx);
+		k = BC_MIN(i, blen - 1);
+
+		// Long columns are summed in chunks. Short ones do not gain from it,
+		// so they use the simple loop.
+		if (j < alen && BC_MIN(alen - j, k + 1) >= BC_NUM_MUL_CHUNK)
 		{
-			dig = (BcBigDig) a->num[0];
-			operand = b;
+			bc_num_mulColumn(a + j, b + k, BC_MIN(alen - j, k + 1), &sum,
+			                 &carry);
 		}
 		else
 		{
-			dig = (BcBigDig) b->num[0];
-			operand = a;
-		}
+			// On every iteration of this loop, a multiplication happens, then
+			// the sum is automatically calculated.
+			for (; j < alen && k < blen; ++j, --k)
+			{
+				sum += ((BcBigDig) a[j]) * ((BcBigDig) b[k]);
 
-		bc_num_mulArray(operand, dig, c);
+				if (sum >= ((BcBigDig) BC_BASE_POW) * BC_BASE_POW)
+				{
+					carry += sum / BC_BASE_POW;
+					sum %= BC_BASE_POW;
+				}
+			}
+		}
 
-		// Need to make sure the sign is correct.
-		if (BC_NUM_NONZERO(c))
+		// Calculate the carry.
+		if (sum >= BC_BASE_POW)
 		{
-			c->rdx = BC_NUM_NEG_VAL(c, BC_NUM_NEG(a) != BC_NUM_NEG(b));
+			carry += sum / BC_BASE_POW;
+			sum %= BC_BASE_POW;
 		}
 
-		return;
+		// Store and set up for next iteration.
+		c[i] = (BcDig) sum;
+		assert(c[i] < BC_BASE_POW);
+		sum = carry;
+		carry = 0;
 	}
 
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
+	// This should always be true because there should be no carry on the last
+	// digit; multiplication never goes above the sum of both lengths.
+	assert(!sum);
+}
 
-	BC_SIG_LOCK;
+/**
+ * The simple multiplication that karatsuba dishes out to when the length of the
+ * numbers gets low enough. This doesn't use scale because it treats the
+ * operands as though they are integers.
+ * @param a  The first operand.
+ * @param b  The second operand.
+ * @param c  The return parameter.
+ */
+static void
+bc_num_m_simp(const BcNum* a, const BcNum* b, BcNum* restrict c)
+{
+	size_t alen = a->len, blen = b->len, clen;
+	BcDig* ptr_a = a->num;
+	BcDig* ptr_b = b->num;
+	BcDig* ptr_c;
 
-	// We need copies because of all of the mutation needed to make Karatsuba
-	// think the numbers are integers.
-	bc_num_init(&cpa, a->len + BC_NUM_RDX_VAL(a));
-	bc_num_init(&cpb, b->len + BC_NUM_RDX_VAL(b));
+	assert(!BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b));
 
-	BC_SETJMP_LOCKED(vm, init_err);
+	// Make sure c is big enough.
+	clen = bc_vm_growSize(alen, blen);
+	bc_num_expand(c, bc_vm_growSize(clen, 1));
 
-	BC_SIG_UNLOCK;
+	// If we don't memset, then we might have uninitialized data use later.
+	ptr_c = c->num;
+	// NOLINTNEXTLINE
+	memset(ptr_c, 0, BC_NUM_SIZE(c->cap));
 
-	bc_num_copy(&cpa, a);
-	bc_num_copy(&cpb, b);
+#if BC_NUM_WIDE
+	// Small enough operands are done in wide limbs.
+	if (alen <= BC_NUM_WIDE_LEN && blen <= BC_NUM_WIDE_LEN)
+	{
+		bc_num_m_wide(ptr_a, alen, ptr_b, blen, ptr_c, 0);
+		c->len = clen;
+		return;
+	}
+#endif // BC_NUM_WIDE
 
-	assert(BC_NUM_RDX_VALID_NP(cpa));
-	assert(BC_NUM_RDX_VALID_NP(cpb));
+	bc_num_mulCols(ptr_a, alen, ptr_b, blen, ptr_c, 0);
 
-	BC_NUM_NEG_CLR_NP(cpa);
-	BC_NUM_NEG_CLR_NP(cpb);
+	c->len = clen;
+}
 
-	assert(BC_NUM_RDX_VALID_NP(cpa));
-	assert(BC_NUM_RDX_VALID_NP(cpb));
+/**
+ * The simple squaring that karatsuba dishes out to when the length of the
+ * number gets low enough. It is the same lattice as bc_num_m_simp(), but
+ * because the operand is multiplied by itself, every column is symmetric, so
+ * only half of the limb products need to be calculated and then doubled.
+ * @param a  The operand.
+ * @param c  The return parameter.
+ */
+static void
+bc_num_sqr_simp(const BcNum* a, BcNum* restrict c)
+{
+	size_t i, alen = a->len, clen;
+	BcDig* ptr_a = a->num;
+	BcDig* ptr_c;
+	BcBigDig sum, carry = 0;
 
-	// These are what makes them appear like integers.
-	ardx = BC_NUM_RDX_VAL_NP(cpa) * BC_BASE_DIGS;
-	bc_num_shiftLeft(&cpa, ardx);
+	assert(sizeof(sum) >= sizeof(BcDig) * 2);
+	assert(!BC_NUM_RDX_VAL(a));
 
-	brdx = BC_NUM_RDX_VAL_NP(cpb) * BC_BASE_DIGS;
-	bc_num_shiftLeft(&cpb, brdx);
+	// Make sure c is big enough.
+	clen = bc_vm_growSize(alen, alen);
+	bc_num_expand(c, bc_vm_growSize(clen, 1));
 
-	// We need to reset the jump here because azero and bzero are used in the
-	// cleanup, and local variables are not guaranteed to be the same after a
-	// jump.
-	BC_SIG_LOCK;
+	// If we don't memset, then we might have uninitialized data use later.
+	ptr_c = c->num;
+	// NOLINTNEXTLINE
+	memset(ptr_c, 0, BC_NUM_SIZE(c->cap));
 
-	BC_UNSETJMP(vm);
+#if BC_NUM_WIDE
+	// Small enough operands are done in wide limbs.
+	if (alen <= BC_NUM_WIDE_LEN)
+	{
+		bc_num_sqr_wide(ptr_a, alen, ptr_c);
+		c->len = clen;
+		return;
+	}
+#endif // BC_NUM_WIDE
 
-	// We want to ignore zero limbs.
-	azero = bc_num_shiftZero(&cpa);
-	bzero = bc_num_shiftZero(&cpb);
+	for (i = 0; i < clen; ++i)
+	{
+		ssize_t sidx = (ssize_t) (i - alen + 1);
+		size_t j, k;
+		BcBigDig half = 0, hcarry = 0;
 
-	BC_SETJMP_LOCKED(vm, err);
+		// These are the start indices. j only goes up to the middle of the
+		// column, and k only goes down to it.
+		j = (size_t) BC_MAX(0, sidx);
+		k = i - j;
 
-	BC_SIG_UNLOCK;
+		for (; j < k; ++j, --k)
+		{
+			half += ((BcBigDig) ptr_a[j]) * ((BcBigDig) ptr_a[k]);
 
-	bc_num_clean(&cpa);
-	bc_num_clean(&cpb);
+			if (half >= ((BcBigDig) BC_BASE_POW) * BC_BASE_POW)
+			{
+				hcarry += half / BC_BASE_POW;
+				half %= BC_BASE_POW;
+			}
+		}
 
-	bc_num_k(&cpa, &cpb, c);
+		// Every product above has a twin on the other side of the middle, and
+		// the carry from the last column comes in once.
+		sum = half * 2 + carry;
+		carry = hcarry * 2;
 
-	// The return parameter needs to have its scale set. This is the start. It
-	// also needs to be shifted by the same amount as a and b have limbs after
-	// the decimal point.
-	zero = bc_vm_growSize(azero, bzero);
-	len = bc_vm_growSize(c->len, zero);
+		// The middle of an even column is the only product without a twin.
+		if (j == k) sum += ((BcBigDig) ptr_a[j]) * ((BcBigDig) ptr_a[j]);
 
-	bc_num_expand(c, len);
+		// Calculate the carry.
+		if (sum >= BC_BASE_POW)
+		{
+			carry += sum / BC_BASE_POW;
+			sum %= BC_BASE_POW;
+		}
 
-	// Shift c based on the limbs after the decimal point in a and b.
-	bc_num_shiftLeft(c, (len - c->len) * BC_BASE_DIGS);
-	bc_num_shiftRight(c, ardx + brdx);
+		// Store.
+		ptr_c[i] = (BcDig) sum;
+		assert(ptr_c[i] < BC_BASE_POW);
+	}
 
-	bc_num_retireMul(c, realscale, BC_NUM_NEG(a), BC_NUM_NEG(b));
+	// This should always be true because there should be no carry on the last
+	// digit; squaring never goes above twice the length.
+	assert(!carry);
 
-err:
-	BC_SIG_MAYLOCK;
-	bc_num_unshiftZero(&cpb, bzero);
-	bc_num_unshiftZero(&cpa, azero);
-init_err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&cpb);
-	bc_num_free(&cpa);
-	BC_LONGJMP_CONT(vm);
+	c->len = clen;
 }
 
 /**
- * Returns true if the BcDig array has non-zero limbs, false otherwise.
- * @param a    The array to test.
- * @param len  The length of the array.
- * @return     True if @a has any non-zero limbs, false otherwise.
+ * Does a shifted add or subtract for Karatsuba below. This calls either
+ * bc_num_addArrays() or bc_num_subArrays().
+ * @param n      An in/out parameter; the first operand and return parameter.
+ * @param a      The second operand.
+ * @param shift  The amount to shift @a n by when adding/subtracting.
+ * @param op     The function to call, either bc_num_addArrays() or
+ *               bc_num_subArrays().
  */
-static bool
-bc_num_nonZeroDig(BcDig* restrict a, size_t len)
+static void
+bc_num_shiftAddSub(BcNum* restrict n, const BcNum* restrict a, size_t shift,
+                   BcNumShiftAddOp op)
 {
-	size_t i;
-
-	for (i = len - 1; i < len; --i)
-	{
-		if (a[i] != 0) return true;
-	}
-
-	return false;
+	assert(n->len >= shift + a->len);
+	assert(!BC_NUM_RDX_VAL(n) && !BC_NUM_RDX_VAL(a));
+	op(n->num + shift, a->num, a->len);
 }
 
 /**
- * Compares a BcDig array against a BcNum. This is especially suited for
- * division. Returns >0 if @a a is greater than @a b, <0 if it is less, and =0
- * if they are equal.
- * @param a    The array.
- * @param b    The number.
- * @param len  The length to assume the arrays are. This is always less than the
- *             actual length because of how this is implemented.
+ * Sets up @a r as a read-only view of @a len limbs of @a n, starting at limb
+ * @a idx. The view is always an integer, even if @a n has a fractional part.
+ * The view does not own its limbs, so it must never be written to, expanded,
+ * or freed. This is used to split numbers without copying them.
+ * @param n    The number to view.
+ * @param idx  The index of the first limb in the view.
+ * @param len  The maximum number of limbs in the view.
+ * @param r    An out parameter; the view.
  */
-static ssize_t
-bc_num_divCmp(const BcDig* a, const BcNum* b, size_t len)
+static void
+bc_num_view(const BcNum* restrict n, size_t idx, size_t len,
+            BcNum* restrict r)
 {
-	ssize_t cmp;
+	r->scale = 0;
+	r->rdx = 0;
 
-	if (b->len > len && a[len]) cmp = bc_num_compare(a, b->num, len + 1);
-	else if (b->len <= len)
+	// Views past the end of the number are just zero.
+	if (idx >= n->len)
 	{
-		if (a[len]) cmp = 1;
-		else cmp = bc_num_compare(a, b->num, len);
+		r->num = n->num;
+		r->len = r->cap = 0;
+		return;
 	}
-	else cmp = -1;
 
-	return cmp;
+	r->num = n->num + idx;
+	r->len = r->cap = BC_MIN(len, n->len - idx);
+
+	bc_num_clean(r);
 }
 
 /**
- * Extends the two operands of a division by BC_BASE_DIGS minus the number of
- * digits in the divisor estimate. In other words, it is shifting the numbers in
- * order to force the divisor estimate to fill the limb.
- * @param a        The first operand.
- * @param b        The second operand.
- * @param divisor  The divisor estimate.
+ * Returns a view of the integer part of @a n without its sign. The GCD and the
+ * bitwise and combinatorial functions of the extended math library take the
+ * absolute values of their operands and truncate them, and this does both
+ * without a copy.
+ * @param n  The number to view.
+ * @param v  An out parameter; the view.
  */
 static void
-bc_num_divExtend(BcNum* restrict a, BcNum* restrict b, BcBigDig divisor)
+bc_num_intView(const BcNum* restrict n, BcNum* restrict v)
 {
-	size_t pow;
+	bc_num_view(n, BC_NUM_RDX_VAL(n), n->len, v);
+}
 
-	assert(divisor < BC_BASE_POW);
+/**
+ * Divides @a n, which can be negative, by the small number @a d in place. The
+ * division *must* be exact; this is used for the interpolation steps of
+ * Toom-Cook, where that is guaranteed.
+ * @param n  The number to divide.
+ * @param d  The divisor.
+ */
+static void
+bc_num_divExact(BcNum* restrict n, BcBigDig d)
+{
+	size_t i;
+	BcBigDig carry = 0;
+	BcNumRecip r;
 
-	pow = BC_BASE_DIGS - bc_num_log10((size_t) divisor);
+	assert(!BC_NUM_RDX_VAL(n) && d != 0 && d < BC_BASE_POW);
 
-	bc_num_shiftLeft(a, pow);
-	bc_num_shiftLeft(b, pow);
+	bc_num_recipInit(&r, d);
+
+	for (i = n->len - 1; i < n->len; --i)
+	{
+		BcBigDig in = ((BcBigDig) n->num[i]) + carry * BC_BASE_POW;
+		n->num[i] = (BcDig) bc_num_recipDiv(&r, in, &carry);
+	}
+
+	assert(!carry);
+
+	bc_num_clean(n);
 }
 
 /**
- * Actually does division. This is a rewrite of my original code by Stefan Esser
- * from FreeBSD.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter.
- * @param scale  The current scale.
+ * Implements the Toom-Cook 3-way algorithm, using the evaluation points and the
+ * interpolation sequence by Marco Bodrato (0, 1, -1, -2, and infinity). Each
+ * operand is split into three pieces, so one multiplication of size n becomes
+ * five multiplications of size n/3, which is O(n^log_3(5)) overall. The five
+ * point-wise products go back through bc_num_mul(), so they pick whichever of
+ * Toom-3, Karatsuba, or brute force fits their size. If @a a and @a b are the
+ * same pointer, only one operand is evaluated and the point-wise products are
+ * all squares.
+ * @param a  The first operand. It must be a non-negative integer.
+ * @param b  The second operand. It must be a non-negative integer.
+ * @param c  The return parameter. It must be zero.
  */
 static void
-bc_num_d_long(BcNum* restrict a, BcNum* restrict b, BcNum* restrict c,
-              size_t scale)
+bc_num_toom3(const BcNum* a, const BcNum* b, BcNum* restrict c)
 {
-	BcBigDig divisor;
-	size_t i, rdx;
-	// This is volatile and len 2 and reallen exist to quiet the GCC warning
-	// about clobbering on longjmp(). This one is possible, I think.
-	volatile size_t len;
-	size_t len2, reallen;
-	// This is volatile and realend exists to quiet the GCC warning about
-	// clobbering on longjmp(). This one is possible, I think.
-	volatile size_t end;
-	size_t realend;
-	BcNum cpb;
-	// This is volatile and realnonzero exists to quiet the GCC warning about
-	// clobbering on longjmp(). This one is possible, I think.
-	volatile bool nonzero;
-	bool realnonzero;
+	size_t max, k, req;
+	BcNum a0, a1, a2, b0, b1, b2;
+	BcNum t, ap1, am1, am2, bp1, bm1, bm2, r0, r1, rm1, rm2, rinf;
+	bool sqr = (a == b);
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	assert(b->len < a->len);
-
-	len = b->len;
-	end = a->len - len;
+	assert(BC_NUM_ZERO(c));
+	assert(!BC_NUM_NEG(a) && !BC_NUM_NEG(b));
 
-	assert(len >= 1);
+	// Split into three pieces. If the operands are lopsided, the high pieces
+	// of the smaller one are just zero.
+	max = BC_MAX(a->len, b->len);
+	k = (max + 2) / 3;
 
-	// This is a final time to make sure c is big enough and that its array is
-	// properly zeroed.
-	bc_num_expand(c, a->len);
-	// NOLINTNEXTLINE
-	memset(c->num, 0, c->cap * sizeof(BcDig));
+	bc_num_view(a, 0, k, &a0);
+	bc_num_view(a, k, k, &a1);
+	bc_num_view(a, 2 * k, k, &a2);
+	bc_num_view(b, 0, k, &b0);
+	bc_num_view(b, k, k, &b1);
+	bc_num_view(b, 2 * k, k, &b2);
 
-	// Setup.
-	BC_NUM_RDX_SET(c, BC_NUM_RDX_VAL(a));
-	c->scale = a->scale;
-	c->len = a->len;
+	// The evaluations can be at most a couple of limbs longer than k, and the
+	// products are at most twice that.
+	req = bc_vm_growSize(k, 2);
 
-	// This is pulling the most significant limb of b in order to establish a
-	// good "estimate" for the actual divisor.
-	divisor = (BcBigDig) b->num[len - 1];
+	BC_SIG_LOCK;
 
-	// The entire bit of code in this if statement is to tighten the estimate of
-	// the divisor. The condition asks if b has any other non-zero limbs.
-	if (len > 1 && bc_num_nonZeroDig(b->num, len - 1))
-	{
-		// This takes a little bit of understanding. The "10*BC_BASE_DIGS/6+1"
-		// results in either 16 for 64-bit 9-digit limbs or 7 for 32-bit 4-digit
-		// limbs. Then it shifts a 1 by that many, which in both cases, puts the
-		// result above *half* of the max value a limb can store. Basically,
-		// this quickly calculates if the divisor is greater than half the max
-		// of a limb.
-		nonzero = (divisor > 1 << ((10 * BC_BASE_DIGS) / 6 + 1));
+	bc_num_init(&t, req);
+	bc_num_init(&ap1, req);
+	bc_num_init(&am1, req);
+	bc_num_init(&am2, req);
+	bc_num_init(&bp1, req);
+	bc_num_init(&bm1, req);
+	bc_num_init(&bm2, req);
 
-		// If the divisor is *not* greater than half the limb...
-		if (!nonzero)
-		{
-			// Extend the parameters by the number of missing digits in the
-			// divisor.
-			bc_num_divExtend(a, b, divisor);
+	req = bc_vm_growSize(req, req);
 
-			// Check bc_num_d(). In there, we grow a again and again. We do it
-			// again here; we *always* want to be sure it is big enough.
-			len2 = BC_MAX(a->len, b->len);
-			bc_num_expand(a, len2 + 1);
+	bc_num_init(&r0, req);
+	bc_num_init(&r1, req);
+	bc_num_init(&rm1, req);
+	bc_num_init(&rm2, req);
+	bc_num_init(&rinf, req);
 
-			// Make a have a zero most significant limb to match the len.
-			if (len2 + 1 > a->len) a->len = len2 + 1;
+	BC_SETJMP_LOCKED(vm, err);
 
-			// Grab the new divisor estimate, new because the shift has made it
-			// different.
-			reallen = b->len;
-			realend = a->len - reallen;
-			divisor = (BcBigDig) b->num[reallen - 1];
+	BC_SIG_UNLOCK;
 
-			realnonzero = bc_num_nonZeroDig(b->num, reallen - 1);
-		}
-		else
-		{
-			realend = end;
-			realnonzero = nonzero;
-		}
-	}
-	else
+	// Evaluate the first operand at 1, -1, and -2. The evaluations at 0 and
+	// infinity are just a0 and a2.
+	bc_num_add(&a0, &a2, &t, 0);
+	bc_num_add(&t, &a1, &ap1, 0);
+	bc_num_sub(&t, &a1, &am1, 0);
+	bc_num_add(&am1, &a2, &am2, 0);
+	bc_num_add(&am2, &am2, &am2, 0);
+	bc_num_sub(&am2, &a0, &am2, 0);
+
+	// Same for the second operand, unless this is a square.
+	if (!sqr)
 	{
-		realend = end;
-		realnonzero = false;
+		bc_num_add(&b0, &b2, &t, 0);
+		bc_num_add(&t, &b1, &bp1, 0);
+		bc_num_sub(&t, &b1, &bm1, 0);
+		bc_num_add(&bm1, &b2, &bm2, 0);
+		bc_num_add(&bm2, &bm2, &bm2, 0);
+		bc_num_sub(&bm2, &b0, &bm2, 0);
 	}
 
-	// If b has other nonzero limbs, we want the divisor to be one higher, so
-	// that it is an upper bound.
-	divisor += realnonzero;
-
-	// Make sure c can fit the new length.
-	bc_num_expand(c, a->len);
+	// The point-wise products. For a square, passing the same pointer twice
+	// makes them squares too.
+	bc_num_mul(&a0, sqr ? &a0 : &b0, &r0, 0);
+	bc_num_mul(&ap1, sqr ? &ap1 : &bp1, &r1, 0);
+	bc_num_mul(&am1, sqr ? &am1 : &bm1, &rm1, 0);
+	bc_num_mul(&am2, sqr ? &am2 : &bm2, &rm2, 0);
+	bc_num_mul(&a2, sqr ? &a2 : &b2, &rinf, 0);
+
+	// Interpolation. After this, r0, r1, rm1, rm2, and rinf hold the
+	// coefficients of x^0, x^1, x^2, x^3, and x^4, respectively. While the
+	// intermediate values can be negative, the coefficients cannot be because
+	// they are sums of products of non-negative pieces.
+	bc_num_sub(&rm2, &r1, &rm2, 0);
+	bc_num_divExact(&rm2, 3);
+	bc_num_sub(&r1, &rm1, &r1, 0);
+	bc_num_divExact(&r1, 2);
+	bc_num_sub(&rm1, &r0, &rm1, 0);
+	bc_num_sub(&rm1, &rm2, &rm2, 0);
+	bc_num_divExact(&rm2, 2);
+	bc_num_add(&rm2, &rinf, &rm2, 0);
+	bc_num_add(&rm2, &rinf, &rm2, 0);
+	bc_num_add(&rm1, &r1, &rm1, 0);
+	bc_num_sub(&rm1, &rinf, &rm1, 0);
+	bc_num_sub(&r1, &rm2, &r1, 0);
+
+	assert(!BC_NUM_NEG_NP(r1) && !BC_NUM_NEG_NP(rm1) && !BC_NUM_NEG_NP(rm2));
+
+	// Set up c, then recompose the product.
+	req = bc_vm_growSize(bc_vm_growSize(a->len, b->len), k);
+	bc_num_expand(c, req);
+	c->len = req;
 	// NOLINTNEXTLINE
-	memset(c->num, 0, BC_NUM_SIZE(c->cap));
+	memset(c->num, 0, BC_NUM_SIZE(c->len));
 
-	assert(c->scale >= scale);
-	rdx = BC_NUM_RDX_VAL(c) - BC_NUM_RDX(scale);
+	bc_num_shiftAddSub(c, &r0, 0, bc_num_addArrays);
+	bc_num_shiftAddSub(c, &r1, k, bc_num_addArrays);
+	bc_num_shiftAddSub(c, &rm1, 2 * k, bc_num_addArrays);
+	bc_num_shiftAddSub(c, &rm2, 3 * k, bc_num_addArrays);
+	bc_num_shiftAddSub(c, &rinf, 4 * k, bc_num_addArrays);
 
-	BC_SIG_LOCK;
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&rinf);
+	bc_num_free(&rm2);
+	bc_num_free(&rm1);
+	bc_num_free(&r1);
+	bc_num_free(&r0);
+	bc_num_free(&bm2);
+	bc_num_free(&bm1);
+	bc_num_free(&bp1);
+	bc_num_free(&am2);
+	bc_num_free(&am1);
+	bc_num_free(&ap1);
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
+}
 
-	bc_num_init(&cpb, len + 1);
+/**
+ * Does a Montgomery reduction of @a t modulo the NTT prime @a p. The result is
+ * t / 2^32 modulo @a p.
+ * @param t     The value to reduce. It must be less than @a p * 2^32.
+ * @param p     The prime.
+ * @param pinv  The negated inverse of @a p modulo 2^32.
+ * @return      The reduced value, which is less than @a p.
+ */
+static inline uint32_t
+bc_num_ntt_redc(uint64_t t, uint32_t p, uint32_t pinv)
+{
+	uint32_t m = ((uint32_t) t) * pinv;
+	uint64_t u = (t + ((uint64_t) m) * p) >> 32;
 
-	BC_SETJMP_LOCKED(vm, err);
+	return (uint32_t) (u >= p ? u - p : u);
+}
 
-	BC_SIG_UNLOCK;
+/**
+ * Multiplies two values modulo the NTT prime @a p with Montgomery
+ * multiplication. If both values are in Montgomery form, so is the result. If
+ * only one is, the result is in normal form.
+ * @param a     The first operand. It must be less than 2^32.
+ * @param b     The second operand. It must be less than @a p.
+ * @param p     The prime.
+ * @param pinv  The negated inverse of @a p modulo 2^32.
+ * @return      The product, which is less than @a p.
+ */
+static inline uint32_t
+bc_num_ntt_mul(uint32_t a, uint32_t b, uint32_t p, uint32_t pinv)
+{
+	return bc_num_ntt_redc(((uint64_t) a) * b, p, pinv);
+}
 
-	// This is the actual division loop.
-	for (i = realend - 1; i < realend && i >= rdx && BC_NUM_NONZERO(a); --i)
-	{
-		ssize_t cmp;
-		BcDig* n;
-		BcBigDig result;
+/**
+ * Calculates @a b ^ @a e modulo @a p the plain way. This is only used for
+ * setting up constants, so it does not need to be fast.
+ * @param b  The base.
+ * @param e  The exponent.
+ * @param p  The modulus. It must be less than 2^32.
+ * @return   @a b ^ @a e modulo @a p.
+ */
+static uint32_t
+bc_num_ntt_pow(uint64_t b, uint64_t e, uint32_t p)
+{
+	uint64_t r = 1;
 
-		n = a->num + i;
-		assert(n >= a->num);
-		result = 0;
+	b %= p;
 
-		cmp = bc_num_divCmp(n, b, len);
+	while (e)
+	{
+		if (e & 1) r = r * b % p;
+		b = b * b % p;
+		e >>= 1;
+	}
 
-		// This is true if n is greater than b, which means that division can
-		// proceed, so this inner loop is the part that implements one instance
-		// of the division.
-		while (cmp >= 0)
-		{
-			BcBigDig n1, dividend, quotient;
+	return (uint32_t) r;
+}
 
-			// These should be named obviously enough. Just imagine that it's a
-			// division of one limb. Because that's what it is.
-			n1 = (BcBigDig) n[len];
-			dividend = n1 * BC_BASE_POW + (BcBigDig) n[len - 1];
-			quotient = (dividend / divisor);
+/**
+ * Does a forward number-theoretic transform in place. This uses decimation in
+ * frequency, so the output is in bit-reversed order, which is fine because
+ * bc_num_ntt_inv() takes its input in that order.
+ * @param a     The array to transform, in Montgomery form.
+ * @param n     The length of @a a. It must be a power of 2.
+ * @param tw    The twiddle factors; the first n/2 powers of a primitive n-th
+ *              root of unity, in Montgomery form.
+ * @param p     The prime.
+ * @param pinv  The negated inverse of @a p modulo 2^32.
+ */
+static void
+bc_num_ntt_fwd(uint32_t* restrict a, size_t n, const uint32_t* restrict tw,
+               uint32_t p, uint32_t pinv)
+{
+	size_t len, step, i, j;
 
-			// If this is true, then we can just subtract. Remember: setting
-			// quotient to 1 is not bad because we already know that n is
-			// greater than b.
-			if (quotient <= 1)
-			{
-				quotient = 1;
-				bc_num_subArrays(n, b->num, len);
-			}
-			else
+	for (len = n / 2, step = 1; len; len >>= 1, step <<= 1)
+	{
+		for (i = 0; i < n; i += 2 * len)
+		{
+			for (j = 0; j < len; ++j)
 			{
-				assert(quotient <= BC_BASE_POW);
+				uint32_t u = a[i + j];
+				uint32_t v = a[i + j + len];
+				uint32_t s = u + v;
 
-				// We need to multiply and subtract for a quotient above 1.
-				bc_num_mulArray(b, (BcBigDig) quotient, &cpb);
-				bc_num_subArrays(n, cpb.num, cpb.len);
+				a[i + j] = s >= p ? s - p : s;
+				a[i + j + len] = bc_num_ntt_mul(u + p - v, tw[j * step], p,
+				                                pinv);
 			}
-
-			// The result is the *real* quotient, by the way, but it might take
-			// multiple trips around this loop to get it.
-			result += quotient;
-			assert(result <= BC_BASE_POW);
-
-			// And here's why it might take multiple trips: n might *still* be
-			// greater than b. So we have to loop again. That's what this is
-			// setting up for: the condition of the while loop.
-			if (realnonzero) cmp = bc_num_divCmp(n, b, len);
-			else cmp = -1;
 		}
-
-		assert(result < BC_BASE_POW);
-
-		// Store the actual limb quotient.
-		c->num[i] = (BcDig) result;
 	}
-
-err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&cpb);
-	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Implements division. This is a BcNumBinOp function.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter.
- * @param scale  The current scale.
+ * Does an inverse number-theoretic transform in place, without the final
+ * division by @a n. This uses decimation in time, so it takes its input in
+ * bit-reversed order and gives its output in natural order.
+ * @param a     The array to transform, in Montgomery form.
+ * @param n     The length of @a a. It must be a power of 2.
+ * @param tw    The same twiddle factors given to bc_num_ntt_fwd(). The
+ *              inverse roots are derived from them.
+ * @param p     The prime.
+ * @param pinv  The negated inverse of @a p modulo 2^32.
  */
 static void
-bc_num_d(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+bc_num_ntt_inv(uint32_t* restrict a, size_t n, const uint32_t* restrict tw,
+               uint32_t p, uint32_t pinv)
 {
-	size_t len, cpardx;
-	BcNum cpa, cpb;
+	size_t len, step, i, j, half = n / 2;
+
+	for (len = 1, step = half; len < n; len <<= 1, step >>= 1)
+	{
+		for (i = 0; i < n; i += 2 * len)
+		{
+			for (j = 0; j < len; ++j)
+			{
+				size_t k = j * step;
+
+				// Because w^(n/2) is -1, w^-k is -w^(n/2-k).
+				uint32_t w = k ? p - tw[half - k] : tw[0];
+				uint32_t u = a[i + j];
+				uint32_t v = bc_num_ntt_mul(a[i + j + len], w, p, pinv);
+				uint32_t s = u + v;
+				uint32_t d = u + p - v;
+
+				a[i + j] = s >= p ? s - p : s;
+				a[i + j + len] = d >= p ? d - p : d;
+			}
+		}
+	}
+}
+
+/**
+ * Multiplies two integers with a number-theoretic transform. The product is
+ * computed modulo three primes, and then the Chinese Remainder Theorem puts
+ * each limb back together. This is O(n log n), but the transforms have a big
+ * constant factor, so it is only used for huge numbers. If @a a and @a b are
+ * the same pointer, the operand is only transformed once and squared.
+ * @param a  The first operand. It must be a non-negative integer.
+ * @param b  The second operand. It must be a non-negative integer.
+ * @param c  The return parameter. It must be zero.
+ */
+static void
+bc_num_ntt(const BcNum* a, const BcNum* b, BcNum* restrict c)
+{
+	size_t i, j, n, clen, pdlen;
+	uint32_t* buf;
+	uint32_t* fa;
+	uint32_t* fb;
+	uint32_t* tw;
+	uint32_t* res;
+	uint32_t p0, p1, p2;
+	uint64_t p01, inv0, inv01;
+	uint64_t pd[BC_NUM_NTT_CARRY_DIGS];
+	uint64_t pend[BC_NUM_NTT_CARRY_DIGS];
+	bool sqr = (a == b);
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	if (BC_NUM_ZERO(b)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
-
-	if (BC_NUM_ZERO(a))
-	{
-		bc_num_setToZero(c, scale);
-		return;
-	}
+	assert(BC_NUM_ZERO(c));
+	assert(!BC_NUM_NEG(a) && !BC_NUM_NEG(b));
+	assert(BC_NUM_NTT_PRIMES == 3);
 
-	if (BC_NUM_ONE(b))
-	{
-		bc_num_copy(c, a);
-		bc_num_retireMul(c, scale, BC_NUM_NEG(a), BC_NUM_NEG(b));
-		return;
-	}
+	clen = bc_vm_growSize(a->len, b->len);
+	assert(clen <= BC_NUM_NTT_MAX);
 
-	// If this is true, we can use bc_num_divArray(), which would be faster.
-	if (!BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b) && b->len == 1 && !scale)
+	// The transform length must be a power of 2.
+	for (n = 1; n < clen; n <<= 1)
 	{
-		BcBigDig rem;
-		bc_num_divArray(a, (BcBigDig) b->num[0], c, &rem);
-		bc_num_retireMul(c, scale, BC_NUM_NEG(a), BC_NUM_NEG(b));
-		return;
+		continue;
 	}
 
-	len = bc_num_divReq(a, b, scale);
-
 	BC_SIG_LOCK;
 
-	// Initialize copies of the parameters. We want the length of the first
-	// operand copy to be as big as the result because of the way the division
-	// is implemented.
-	bc_num_init(&cpa, len);
-	bc_num_copy(&cpa, a);
-	bc_num_createCopy(&cpb, b);
+	// One allocation for both transforms, the twiddle factors, and the results
+	// for the first two primes. The results for the last prime stay in fa. A
+	// square only needs one transform.
+	buf = bc_vm_malloc(bc_vm_arraySize((2 - sqr) * n + n / 2 + 2 * clen,
+	                                   sizeof(uint32_t)));
 
 	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	len = b->len;
+	fa = buf;
+	fb = sqr ? fa : fa + n;
+	tw = fb + n;
+	res = tw + n / 2;
 
-	// Like the above comment, we want the copy of the first parameter to be
-	// larger than the second parameter.
-	if (len > cpa.len)
+	bc_num_expand(c, clen);
+
+	for (i = 0; i < BC_NUM_NTT_PRIMES; ++i)
 	{
-		bc_num_expand(&cpa, bc_vm_growSize(len, 2));
-		bc_num_extend(&cpa, (len - cpa.len) * BC_BASE_DIGS);
-	}
+		uint32_t p = bc_num_ntt_primes[i];
+		uint32_t pinv = p, r1, r2, w, ninv;
+		uint32_t* out = i < BC_NUM_NTT_PRIMES - 1 ? res + i * clen : fa;
 
-	cpardx = BC_NUM_RDX_VAL_NP(cpa);
-	cpa.scale = cpardx * BC_BASE_DIGS;
+		// Newton's method for the inverse modulo 2^32. Each iteration doubles
+		// the correct bits, and p is its own inverse to 3 bits.
+		for (j = 0; j < 4; ++j)
+		{
+			pinv *= 2 - p * pinv;
+		}
 
-	// This is just setting up the scale in preparation for the division.
-	bc_num_extend(&cpa, b->scale);
-	cpardx = BC_NUM_RDX_VAL_NP(cpa) - BC_NUM_RDX(b->scale);
-	BC_NUM_RDX_SET_NP(cpa, cpardx);
-	cpa.scale = cpardx * BC_BASE_DIGS;
+		pinv = 0 - pinv;
 
-	// Once again, just setting things up, this time to match scale.
-	if (scale > cpa.scale)
-	{
-		bc_num_extend(&cpa, scale);
-		cpardx = BC_NUM_RDX_VAL_NP(cpa);
-		cpa.scale = cpardx * BC_BASE_DIGS;
-	}
+		// r1 is 1 in Montgomery form, and r2 converts to Montgomery form.
+		r1 = (uint32_t) ((((uint64_t) 1) << 32) % p);
+		r2 = (uint32_t) (((uint64_t) r1) * r1 % p);
 
-	// Grow if necessary.
-	if (cpa.cap == cpa.len) bc_num_expand(&cpa, bc_vm_growSize(cpa.len, 1));
+		// 3 is a primitive root of all of the primes.
+		w = bc_num_ntt_mul(bc_num_ntt_pow(3, (p - 1) / n, p), r2, p, pinv);
 
-	// We want an extra zero in front to make things simpler.
-	cpa.num[cpa.len++] = 0;
+		tw[0] = r1;
 
-	// Still setting things up. Why all of these things are needed is not
-	// something that can be easily explained, but it has to do with making the
-	// actual algorithm easier to understand because it can assume a lot of
-	// things. Thus, you should view all of this setup code as establishing
-	// assumptions for bc_num_d_long(), where the actual division happens.
-	if (cpardx == cpa.len) cpa.len = bc_num_nonZeroLen(&cpa);
-	if (BC_NUM_RDX_VAL_NP(cpb) == cpb.len) cpb.len = bc_num_nonZeroLen(&cpb);
-	cpb.scale = 0;
-	BC_NUM_RDX_SET_NP(cpb, 0);
+		for (j = 1; j < n / 2; ++j)
+		{
+			tw[j] = bc_num_ntt_mul(tw[j - 1], w, p, pinv);
+		}
 
-	bc_num_d_long(&cpa, &cpb, c, scale);
+		// Load the operands in Montgomery form, padded with zeroes.
+		for (j = 0; j < a->len; ++j)
+		{
+			fa[j] = bc_num_ntt_mul((uint32_t) a->num[j], r2, p, pinv);
+		}
 
-	bc_num_retireMul(c, scale, BC_NUM_NEG(a), BC_NUM_NEG(b));
+		// NOLINTNEXTLINE
+		memset(fa + a->len, 0, (n - a->len) * sizeof(uint32_t));
 
-err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&cpb);
-	bc_num_free(&cpa);
-	BC_LONGJMP_CONT(vm);
-}
+		bc_num_ntt_fwd(fa, n, tw, p, pinv);
 
-/**
- * Implements divmod. This is the actual modulus function; since modulus
- * requires a division anyway, this returns the quotient and modulus. Either can
- * be thrown out as desired.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter for the quotient.
- * @param d      The return parameter for the modulus.
- * @param scale  The current scale.
- * @param ts     The scale that the operation should be done to. Yes, it's not
- *               necessarily the same as scale, per the bc spec.
- */
-static void
-bc_num_r(BcNum* a, BcNum* b, BcNum* restrict c, BcNum* restrict d, size_t scale,
-         size_t ts)
-{
-	BcNum temp;
-	// realscale is meant to quiet a warning on GCC about longjmp() clobbering.
-	// This one is real.
-	size_t realscale;
-	bool neg;
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+		if (!sqr)
+		{
+			for (j = 0; j < b->len; ++j)
+			{
+				fb[j] = bc_num_ntt_mul((uint32_t) b->num[j], r2, p, pinv);
+			}
 
-	if (BC_NUM_ZERO(b)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+			// NOLINTNEXTLINE
+			memset(fb + b->len, 0, (n - b->len) * sizeof(uint32_t));
 
-	if (BC_NUM_ZERO(a))
+			bc_num_ntt_fwd(fb, n, tw, p, pinv);
+		}
+
+		for (j = 0; j < n; ++j)
+		{
+			fa[j] = bc_num_ntt_mul(fa[j], fb[j], p, pinv);
+		}
+
+		bc_num_ntt_inv(fa, n, tw, p, pinv);
+
+		// Dividing by n with n^-1 in normal form also takes the values out of
+		// Montgomery form.
+		ninv = p - (p - 1) / (uint32_t) n;
+
+		for (j = 0; j < clen; ++j)
+		{
+			out[j] = bc_num_ntt_mul(fa[j], ninv, p, pinv);
+		}
+	}
+
+	p0 = bc_num_ntt_primes[0];
+	p1 = bc_num_ntt_primes[1];
+	p2 = bc_num_ntt_primes[2];
+	p01 = ((uint64_t) p0) * p1;
+	inv0 = bc_num_ntt_pow(p0, p1 - 2, p1);
+	inv01 = bc_num_ntt_pow(p01, p2 - 2, p2);
+
+	// The limbs of p0 * p1, for adding multiples of it.
+	for (pdlen = 0, pd[0] = p01; pd[pdlen] >= BC_BASE_POW; ++pdlen)
 	{
-		bc_num_setToZero(c, ts);
-		bc_num_setToZero(d, ts);
-		return;
+		pd[pdlen + 1] = pd[pdlen] / BC_BASE_POW;
+		pd[pdlen] %= BC_BASE_POW;
 	}
 
-	BC_SIG_LOCK;
+	pdlen += 1;
 
-	bc_num_init(&temp, d->cap);
+	// NOLINTNEXTLINE
+	memset(pend, 0, sizeof(pend));
 
-	BC_SETJMP_LOCKED(vm, err);
+	// Garner's algorithm puts each coefficient back together as x + p0*p1*u,
+	// where x is less than p0*p1 and u is less than p2. Coefficients are bigger
+	// than a limb, so they are added into pending limbs, and the lowest pending
+	// limb is retired for every coefficient.
+	for (i = 0; i < clen; ++i)
+	{
+		uint64_t r0 = res[i], x, u, carry;
 
-	BC_SIG_UNLOCK;
+		x = (res[clen + i] + p1 - r0 % p1) % p1 * inv0 % p1;
+		x = r0 + p0 * x;
+		u = (fa[i] + p2 - x % p2) % p2 * inv01 % p2;
 
-	// Division.
-	bc_num_d(a, b, c, scale);
+		for (j = 0; x; ++j)
+		{
+			pend[j] += x % BC_BASE_POW;
+			x /= BC_BASE_POW;
+		}
 
-	// We want an extra digit so we can safely truncate.
-	if (scale) realscale = ts + 1;
-	else realscale = scale;
+		for (j = 0; j < pdlen; ++j)
+		{
+			pend[j] += u * pd[j];
+		}
 
-	assert(BC_NUM_RDX_VALID(c));
-	assert(BC_NUM_RDX_VALID(b));
+		carry = pend[0] / BC_BASE_POW;
+		c->num[i] = (BcDig) (pend[0] % BC_BASE_POW);
 
-	// Implement the rest of the (a - (a / b) * b) formula.
-	bc_num_m(c, b, &temp, realscale);
-	bc_num_sub(a, &temp, d, realscale);
+		// NOLINTNEXTLINE
+		memmove(pend, pend + 1, sizeof(pend) - sizeof(uint64_t));
+		pend[BC_NUM_NTT_CARRY_DIGS - 1] = 0;
+		pend[0] += carry;
+	}
 
-	// Extend if necessary.
-	if (ts > d->scale && BC_NUM_NONZERO(d)) bc_num_extend(d, ts - d->scale);
+	c->len = clen;
 
-	neg = BC_NUM_NEG(d);
-	bc_num_retireMul(d, ts, BC_NUM_NEG(a), BC_NUM_NEG(b));
-	d->rdx = BC_NUM_NEG_VAL(d, BC_NUM_NONZERO(d) ? neg : false);
+	// The product fits in clen limbs, so nothing can be pending.
+	assert(!pend[0] && !pend[1]);
 
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&temp);
+	free(buf);
 	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Implements modulus/remainder. (Yes, I know they are different, but not in the
- * context of bc.) This is a BcNumBinOp function.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter.
- * @param scale  The current scale.
+ * Returns the number of limbs of scratch space that bc_num_kArena() needs to
+ * multiply numbers with at most @a len limbs. Each level of the recursion
+ * needs its split pieces and its three sub-products, and because the
+ * sub-products are done one after the other, they can all share the rest of
+ * the arena below that.
+ * @param len  The length of the longer operand.
+ * @return     The number of limbs that the arena needs.
  */
-static void
-bc_num_rem(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+static size_t
+bc_num_kArenaSize(size_t len)
 {
-	BcNum c1;
-	size_t ts;
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
-
-	ts = bc_vm_growSize(scale, b->scale);
-	ts = BC_MAX(ts, a->scale);
-
-	BC_SIG_LOCK;
-
-	// Need a temp for the quotient.
-	bc_num_init(&c1, bc_num_mulReq(a, b, ts));
+	size_t total = 0;
 
-	BC_SETJMP_LOCKED(vm, err);
+	while (len >= BC_NUM_KARATSUBA_LEN)
+	{
+		size_t half = (len + 1) / 2;
 
-	BC_SIG_UNLOCK;
+		total = bc_vm_growSize(total, bc_vm_arraySize(BC_NUM_KARATSUBA_ALLOCS,
+		                                              half + 1));
+		total = bc_vm_growSize(total, bc_vm_arraySize(BC_NUM_KARATSUBA_PRODS,
+		                                              2 * half + 3));
 
-	bc_num_r(a, b, &c1, c, scale, ts);
+		len = half;
+	}
 
-err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&c1);
-	BC_LONGJMP_CONT(vm);
+	return total;
 }
 
 /**
- * Implements power (exponentiation). This is a BcNumBinOp function.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter.
- * @param scale  The current scale.
+ * Does the cases of Karatsuba that do not need any temporaries: zeroes, ones,
+ * and numbers small enough for the simple algorithm.
+ * @param a  The first operand.
+ * @param b  The second operand.
+ * @param c  The return parameter. It must be zero.
+ * @return   True if the product was done, false otherwise.
  */
-static void
-bc_num_p(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+static bool
+bc_num_kBase(const BcNum* a, const BcNum* b, BcNum* restrict c)
 {
-	BcNum copy, btemp;
-	BcBigDig exp;
-	// realscale is meant to quiet a warning on GCC about longjmp() clobbering.
-	// This one is real.
-	size_t powrdx, resrdx, realscale;
-	bool neg;
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
-
-	// This is here to silence a warning from GCC.
-#if BC_GCC
-	btemp.len = 0;
-	btemp.rdx = 0;
-	btemp.num = NULL;
-#endif // BC_GCC
-
-	if (BC_ERR(bc_num_nonInt(b, &btemp))) bc_err(BC_ERR_MATH_NON_INTEGER);
+	bool aone = BC_NUM_ONE(a);
 
-	assert(btemp.len == 0 || btemp.num != NULL);
+	assert(BC_NUM_ZERO(c));
 
-	if (BC_NUM_ZERO(&btemp))
-	{
-		bc_num_one(c);
-		return;
-	}
+	if (BC_NUM_ZERO(a) || BC_NUM_ZERO(b)) return true;
 
-	if (BC_NUM_ZERO(a))
+	if (aone || BC_NUM_ONE(b))
 	{
-		if (BC_NUM_NEG_NP(btemp)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
-		bc_num_setToZero(c, scale);
-		return;
+		bc_num_copy(c, aone ? b : a);
+		if ((aone && BC_NUM_NEG(a)) || BC_NUM_NEG(b)) BC_NUM_NEG_TGL(c);
+		return true;
 	}
 
-	if (BC_NUM_ONE(&btemp))
+	// Shell out to the simple algorithm with certain conditions. In wide limbs,
+	// it is faster than Karatsuba for anything that fits.
+	if (a->len < BC_NUM_KARATSUBA_LEN || b->len < BC_NUM_KARATSUBA_LEN ||
+	    (BC_NUM_WIDE && a->len <= BC_NUM_WIDE_LEN && b->len <= BC_NUM_WIDE_LEN))
 	{
-		if (!BC_NUM_NEG_NP(btemp)) bc_num_copy(c, a);
-		else bc_num_inv(a, c, scale);
-		return;
+		if (a == b) bc_num_sqr_simp(a, c);
+		else bc_num_m_simp(a, b, c);
+		return true;
 	}
 
-	neg = BC_NUM_NEG_NP(btemp);
-	BC_NUM_NEG_CLR_NP(btemp);
+	return false;
+}
 
-	exp = bc_num_bigdig(&btemp);
+/**
+ * Implements the Karatsuba algorithm. If @a a and @a b are the same pointer,
+ * this squares instead: only one split is needed, all three sub-products are
+ * squares, and the levels below it are told to square as well. All of the
+ * temporaries come out of @a arena, which must have at least
+ * bc_num_kArenaSize() limbs, so nothing here allocates or needs a jump.
+ * @param a      The first operand. It must be a non-negative integer.
+ * @param b      The second operand. It must be a non-negative integer.
+ * @param c      The return parameter. It must be zero, and if it came out of
+ *               the arena, it must have room for the product.
+ * @param arena  The scratch space for the temporaries.
+ */
+static void
+bc_num_kArena(const BcNum* a, const BcNum* b, BcNum* restrict c,
+              BcDig* restrict arena)
+{
+	size_t max, max2, plen, zlen;
+	BcNum l1, h1, l2, h2, m2, m1, z0, z1, z2;
+	BcNum* pl2;
+	BcNum* ph2;
+	BcNum* pm2;
+	BcNumShiftAddOp op;
+	bool sqr = (a == b), neg1, neg2;
 
-	BC_SIG_LOCK;
+	if (bc_num_kBase(a, b, c)) return;
 
-	bc_num_createCopy(&copy, a);
+	// Pieces of numbers in the Karatsuba range never get to Toom-Cook or the
+	// NTT, so the arena only ever has to cover Karatsuba.
+	assert(a->len < BC_NUM_TOOM_LEN || b->len < BC_NUM_TOOM_LEN);
 
-	BC_SETJMP_LOCKED(vm, err);
+	// We need to calculate the max size of the numbers that can result from the
+	// operations. The pieces and their differences are at most max2 limbs, and
+	// the sub-products need room for the levels below them.
+	max = BC_MAX(a->len, b->len);
+	max2 = (max + 1) / 2;
+	plen = max2 + 1;
+	zlen = 2 * max2 + 3;
 
-	BC_SIG_UNLOCK;
+	// Set up the temporaries.
+	bc_num_setup(&l1, arena, plen);
+	arena += plen;
+	bc_num_setup(&h1, arena, plen);
+	arena += plen;
+	bc_num_setup(&l2, arena, plen);
+	arena += plen;
+	bc_num_setup(&h2, arena, plen);
+	arena += plen;
+	bc_num_setup(&m1, arena, plen);
+	arena += plen;
+	bc_num_setup(&m2, arena, plen);
+	arena += plen;
+	bc_num_setup(&z0, arena, zlen);
+	arena += zlen;
+	bc_num_setup(&z1, arena, zlen);
+	arena += zlen;
+	bc_num_setup(&z2, arena, zlen);
+	arena += zlen;
 
-	// If this is true, then we do not have to do a division, and we need to
-	// set scale accordingly.
-	if (!neg)
+	// First, set up c.
+	max = 2 * max + 3;
+	bc_num_expand(c, max);
+	c->len = max;
+	// NOLINTNEXTLINE
+	memset(c->num, 0, BC_NUM_SIZE(c->len));
+
+	// Split the parameters. The low piece can have leading zeroes.
+	bc_num_split(a, max2, &l1, &h1);
+	bc_num_clean(&l1);
+
+	// Do the subtraction.
+	bc_num_sub(&h1, &l1, &m1, 0);
+
+	// For a square, the second operand's pieces are the first's, except that
+	// m2 would be -m1. That is accounted for when adding z1 below.
+	if (sqr)
 	{
-		size_t max = BC_MAX(scale, a->scale), scalepow;
-		scalepow = bc_num_mulOverflow(a->scale, exp);
-		realscale = BC_MIN(scalepow, max);
+		pl2 = &l1;
+		ph2 = &h1;
+		pm2 = &m1;
 	}
-	else realscale = scale;
+	else
+	{
+		bc_num_split(b, max2, &l2, &h2);
+		bc_num_clean(&l2);
+		bc_num_sub(&l2, &h2, &m2, 0);
 
-	// This is only implementing the first exponentiation by squaring, until it
-	// reaches the first time where the square is actually used.
-	for (powrdx = a->scale; !(exp & 1); exp >>= 1)
+		pl2 = &l2;
+		ph2 = &h2;
+		pm2 = &m2;
+	}
+
+	// The sub-products are done on magnitudes, so remember the signs of the
+	// differences for later.
+	neg1 = BC_NUM_NEG_NP(m1);
+	neg2 = BC_NUM_NEG(pm2);
+	BC_NUM_NEG_CLR_NP(m1);
+	BC_NUM_NEG_CLR(pm2);
+
+	// The if statements below are there for efficiency reasons. The best way to
+	// understand them is to understand the Karatsuba algorithm because now that
+	// the ollocations and splits are done, the algorithm is pretty
+	// straightforward.
+
+	if (BC_NUM_NONZERO(&h1) && BC_NUM_NONZERO(ph2))
 	{
-		powrdx <<= 1;
-		assert(BC_NUM_RDX_VALID_NP(copy));
-		bc_num_mul(&copy, &copy, &copy, powrdx);
+		assert(BC_NUM_RDX_VALID_NP(h1));
+		assert(BC_NUM_RDX_VALID(ph2));
+
+		bc_num_kArena(&h1, ph2, &z2, arena);
+		bc_num_clean(&z2);
+
+		bc_num_shiftAddSub(c, &z2, max2 * 2, bc_num_addArrays);
+		bc_num_shiftAddSub(c, &z2, max2, bc_num_addArrays);
 	}
 
-	// Make c a copy of copy for the purpose of saving the squares that should
-	// be saved.
-	bc_num_copy(c, &copy);
-	resrdx = powrdx;
+	if (BC_NUM_NONZERO(&l1) && BC_NUM_NONZERO(pl2))
+	{
+		assert(BC_NUM_RDX_VALID_NP(l1));
+		assert(BC_NUM_RDX_VALID(pl2));
 
-	// Now finish the exponentiation by squaring, this time saving the squares
-	// as necessary.
-	while (exp >>= 1)
+		bc_num_kArena(&l1, pl2, &z0, arena);
+		bc_num_clean(&z0);
+
+		bc_num_shiftAddSub(c, &z0, max2, bc_num_addArrays);
+		bc_num_shiftAddSub(c, &z0, 0, bc_num_addArrays);
+	}
+
+	if (BC_NUM_NONZERO(&m1) && BC_NUM_NONZERO(pm2))
 	{
-		powrdx <<= 1;
-		assert(BC_NUM_RDX_VALID_NP(copy));
-		bc_num_mul(&copy, &copy, &copy, powrdx);
+		assert(BC_NUM_RDX_VALID_NP(m1));
+		assert(BC_NUM_RDX_VALID(pm2));
 
-		// If this is true, we want to save that particular square. This does
-		// that by multiplying c with copy.
-		if (exp & 1)
-		{
-			resrdx += powrdx;
-			assert(BC_NUM_RDX_VALID(c));
-			assert(BC_NUM_RDX_VALID_NP(copy));
-			bc_num_mul(c, &copy, c, resrdx);
-		}
+		bc_num_kArena(&m1, pm2, &z1, arena);
+		bc_num_clean(&z1);
+
+		op = (sqr || neg1 != neg2) ? bc_num_subArrays : bc_num_addArrays;
+		bc_num_shiftAddSub(c, &z1, max2, op);
 	}
+}
 
-	// Invert if necessary.
-	if (neg) bc_num_inv(c, c, realscale);
+/**
+ * Multiplies numbers of very different lengths. Splitting by the longer length,
+ * as the balanced algorithms do, would leave the shorter operand with nothing
+ * in most of its pieces. Instead, the longer operand is cut into slices as long
+ * as the shorter one, each slice is multiplied by the shorter operand with
+ * whichever algorithm fits a balanced product of that size, and the products
+ * are added into place.
+ * @param a  The longer operand. It must be a non-negative integer.
+ * @param b  The shorter operand. It must be a non-negative integer.
+ * @param c  The return parameter. It must be zero.
+ */
+static void
+bc_num_m_unbal(const BcNum* a, const BcNum* b, BcNum* restrict c)
+{
+	size_t i, len = b->len, clen;
+	BcNum slice, prod;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// Truncate if necessary.
-	if (c->scale > realscale) bc_num_truncate(c, c->scale - realscale);
+	assert(a->len > b->len && b->len != 0);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&prod, bc_vm_growSize(bc_vm_growSize(len, len), 1));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// Set up c. The product has at most as many limbs as both operands.
+	clen = bc_vm_growSize(a->len, len);
+	bc_num_expand(c, clen);
+	c->len = clen;
+	// NOLINTNEXTLINE
+	memset(c->num, 0, BC_NUM_SIZE(c->len));
+
+	for (i = 0; i < a->len; i += len)
+	{
+		// The slice is a view, which cleans off the leading zeroes.
+		bc_num_view(a, i, len, &slice);
+
+		bc_num_zero(&prod);
+		bc_num_k(&slice, b, &prod);
+
+		// Everything that the slice's product can carry into is still inside c
+		// because the whole product fits.
+		if (BC_NUM_NONZERO(&prod))
+		{
+			bc_num_clean(&prod);
+			bc_num_shiftAddSub(c, &prod, i, bc_num_addArrays);
+		}
+	}
 
 	bc_num_clean(c);
 
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&copy);
+	bc_num_free(&prod);
 	BC_LONGJMP_CONT(vm);
 }
 
-#if BC_ENABLE_EXTRA_MATH
 /**
- * Implements the places operator. This is a BcNumBinOp function.
- * @param a      The first operand.
- * @param b      The second operand.
- * @param c      The return parameter.
- * @param scale  The current scale.
+ * Picks the multiplication algorithm for the size of the operands. For
+ * Karatsuba, this allocates one arena for the whole recursion. If @a a and
+ * @a b are the same pointer, this squares instead.
+ * @param a  The first operand. It must be a non-negative integer.
+ * @param b  The second operand. It must be a non-negative integer.
+ * @param c  The return parameter. It must be zero.
  */
 static void
-bc_num_place(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+bc_num_k(const BcNum* a, const BcNum* b, BcNum* restrict c)
 {
-	BcBigDig val;
+	BcDig* arena;
+	size_t len;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	BC_UNUSED(scale);
+	// Slice the longer operand if the other is much shorter, unless they are
+	// both big enough for the NTT, whose cost only depends on the total length.
+	if (a != b && BC_MIN(a->len, b->len) >= BC_NUM_UNBAL_LEN &&
+	    !(a->len >= BC_NUM_NTT_LEN && b->len >= BC_NUM_NTT_LEN &&
+	      a->len + b->len <= BC_NUM_NTT_MAX))
+	{
+		if (a->len >= 2 * b->len)
+		{
+			bc_num_m_unbal(a, b, c);
+			return;
+		}
+		else if (b->len >= 2 * a->len)
+		{
+			bc_num_m_unbal(b, a, c);
+			return;
+		}
+	}
 
-	val = bc_num_intop(a, b, c);
+	if (bc_num_kBase(a, b, c)) return;
 
-	// Just truncate or extend as appropriate.
-	if (val < c->scale) bc_num_truncate(c, c->scale - val);
-	else if (val > c->scale) bc_num_extend(c, val - c->scale);
+	// Shell out to the NTT for huge numbers, as long as the product fits.
+	if (a->len >= BC_NUM_NTT_LEN && b->len >= BC_NUM_NTT_LEN &&
+	    a->len + b->len <= BC_NUM_NTT_MAX)
+	{
+		bc_num_ntt(a, b, c);
+		return;
+	}
+
+	// Shell out to Toom-Cook for bigger numbers.
+	if (a->len >= BC_NUM_TOOM_LEN && b->len >= BC_NUM_TOOM_LEN)
+	{
+		bc_num_toom3(a, b, c);
+		return;
+	}
+
+	len = bc_num_kArenaSize(BC_MAX(a->len, b->len));
+
+	BC_SIG_LOCK;
+
+	arena = bc_vm_malloc(BC_NUM_SIZE(len));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_kArena(a, b, c, arena);
+
+err:
+	BC_SIG_MAYLOCK;
+	free(arena);
+	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Implements the left shift operator. This is a BcNumBinOp function.
+ * Returns the number of products in the columns from @a lo up of the lattice
+ * for operands of @a alen and @a blen limbs.
+ * @param alen  The length of the first operand.
+ * @param blen  The length of the second operand.
+ * @param lo    The first column.
+ * @return      The number of products.
  */
-static void
-bc_num_left(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+static size_t
+bc_num_mulCost(size_t alen, size_t blen, size_t lo)
 {
-	BcBigDig val;
+	size_t i, total = 0;
 
-	BC_UNUSED(scale);
+	for (i = lo; i < alen + blen - 1; ++i)
+	{
+		size_t j = i >= blen ? i - blen + 1 : 0;
+		size_t k = BC_MIN(i, alen - 1);
 
-	val = bc_num_intop(a, b, c);
+		total += k - j + 1;
+	}
 
-	bc_num_shiftLeft(c, (size_t) val);
+	return total;
 }
 
 /**
- * Implements the right shift operator. This is a BcNumBinOp function.
+ * Computes a short product: only the limbs of the product of @a a and @a b from
+ * @a drop up, because the caller is going to truncate the rest. The columns
+ * below @a drop are left out, except for three guard limbs. What they add up
+ * to is less than m * BC_BASE_POW in units of the bottom guard limb, where m is
+ * the length of the shorter operand, so if m < BC_BASE_POW, it can change the
+ * limbs above the guard limbs only if the top guard limb is BC_BASE_POW - 1. In
+ * that case, this gives up. In wide limbs, the bottom column also leaves out
+ * products that would land one limb higher, so it needs a fourth guard limb.
+ *
+ * In bc, a product keeps at least as many decimal places as either operand, so
+ * at most the bottom half of the columns can be dropped. That only pays off
+ * for brute force; the faster algorithms lose their advantage when split up
+ * that way. So this is only done for operands that go to brute force, and
+ * only when it saves at least a quarter of the products.
+ * @param a     The first operand. It must be a non-negative integer.
+ * @param b     The second operand. It must be a non-negative integer.
+ * @param c     The return parameter. It must be zero. The limbs below @a drop
+ *              are garbage.
+ * @param drop  The number of low limbs that are going to be truncated.
+ * @return      True if the short product was done, false if the caller needs
+ *              to do the full product instead.
  */
-static void
-bc_num_right(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+static bool
+bc_num_m_short(const BcNum* a, const BcNum* b, BcNum* restrict c, size_t drop)
 {
-	BcBigDig val;
+	size_t alen = a->len, blen = b->len, clen, lo, full, part;
 
-	BC_UNUSED(scale);
+	assert(BC_NUM_ZERO(c));
 
-	val = bc_num_intop(a, b, c);
+	if (BC_NUM_ZERO(a) || BC_NUM_ZERO(b)) return true;
 
-	if (BC_NUM_ZERO(c)) return;
+	clen = bc_vm_growSize(alen, blen);
 
-	bc_num_shiftRight(c, (size_t) val);
+	// If everything is going to be truncated, the result is just zero.
+	if (drop >= clen) return true;
+
+	if (drop <= 4 || BC_MIN(alen, blen) >= BC_BASE_POW) return false;
+
+	lo = drop - 3;
+
+#if BC_NUM_WIDE
+
+	if (alen > BC_NUM_WIDE_LEN || blen > BC_NUM_WIDE_LEN) return false;
+
+	// Work in wide limbs, which means starting at an even limb, below the
+	// fourth guard limb.
+	alen = (alen + 1) / 2;
+	blen = (blen + 1) / 2;
+	lo = (lo - 1) / 2;
+
+	if (a == b) full = alen * (alen + 1) / 2;
+	else full = alen * blen;
+
+	part = bc_num_mulCost(alen, blen, lo);
+
+#else // BC_NUM_WIDE
+
+	if (alen >= BC_NUM_KARATSUBA_LEN && blen >= BC_NUM_KARATSUBA_LEN)
+	{
+		return false;
+	}
+
+	if (a == b) full = alen * (alen + 1) / 2;
+	else full = alen * blen;
+
+	part = bc_num_mulCost(alen, blen, lo);
+
+#endif // BC_NUM_WIDE
+
+	if (part * 4 > full * 3) return false;
+
+	bc_num_expand(c, bc_vm_growSize(clen, 1));
+
+#if BC_NUM_WIDE
+	bc_num_m_wide(a->num, a->len, b->num, b->len, c->num, lo);
+	lo = lo * 2 + 1;
+#else // BC_NUM_WIDE
+	bc_num_mulCols(a->num, alen, b->num, blen, c->num, lo);
+#endif // BC_NUM_WIDE
+
+	// This is the top guard limb in both cases.
+	if (c->num[lo + 2] == BC_BASE_POW - 1) return false;
+
+	// NOLINTNEXTLINE
+	memset(c->num, 0, BC_NUM_SIZE(lo));
+
+	c->len = clen;
+	bc_num_clean(c);
+
+	return true;
 }
-#endif // BC_ENABLE_EXTRA_MATH
 
 /**
- * Prepares for, and calls, a binary operator function. This is probably the
- * most important function in the entire file because it establishes assumptions
- * that make the rest of the code so easy. Those assumptions include:
- *
- * - a is not the same pointer as c.
- * - b is not the same pointer as c.
- * - there is enough room in c for the result.
- *
- * Without these, this whole function would basically have to be duplicated for
- * *all* binary operators.
- *
+ * Does checks for Karatsuba. It also changes things to ensure that the
+ * Karatsuba and simple multiplication can treat the numbers as integers. This
+ * is a BcNumBinOp function.
  * @param a      The first operand.
  * @param b      The second operand.
  * @param c      The return parameter.
  * @param scale  The current scale.
- * @param req    The number of limbs needed to fit the result.
  */
 static void
-bc_num_binary(BcNum* a, BcNum* b, BcNum* c, size_t scale, BcNumBinOp op,
-              size_t req)
+bc_num_m(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
 {
-	BcNum* ptr_a;
-	BcNum* ptr_b;
-	BcNum num2;
+	BcNum cpa, cpb;
+	size_t ascale, bscale, ardx, brdx, zero, len, rscale, drop;
+	// These are meant to quiet warnings on GCC about longjmp() clobbering.
+	// The problem is real here.
+	size_t scale1, scale2, realscale;
+	// These are meant to quiet the GCC longjmp() clobbering, even though it
+	// does not apply here.
+	volatile size_t azero;
+	volatile size_t bzero;
 #if BC_ENABLE_LIBRARY
-	BcVm* vm = NULL;
+	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	assert(a != NULL && b != NULL && c != NULL && op != NULL);
-
 	assert(BC_NUM_RDX_VALID(a));
 	assert(BC_NUM_RDX_VALID(b));
 
-	BC_SIG_LOCK;
-
-	ptr_a = c == a ? &num2 : a;
-	ptr_b = c == b ? &num2 : b;
+	bc_num_zero(c);
 
-	// Actually reallocate. If we don't reallocate, we want to expand at the
-	// very least.
-	if (c == a || c == b)
-	{
-#if BC_ENABLE_LIBRARY
-		vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+	ascale = a->scale;
+	bscale = b->scale;
 
-		// NOLINTNEXTLINE
-		memcpy(&num2, c, sizeof(BcNum));
+	// This sets the final scale according to the bc spec.
+	scale1 = BC_MAX(scale, ascale);
+	scale2 = BC_MAX(scale1, bscale);
+	rscale = ascale + bscale;
+	realscale = BC_MIN(rscale, scale2);
+
+	// If this condition is true, we can use bc_num_mulArray(), which would be
+	// much faster.
+	if ((a->len == 1 || b->len == 1) && !a->rdx && !b->rdx)
+	{
+		BcNum* operand;
+		BcBigDig dig;
+
+		// Set the correct operands.
+		if (a->len == 1)
+		{
+			dig = (BcBigDig) a->num[0];
+			operand = b;
+		}
+		else
+		{
+			dig = (BcBigDig) b->num[0];
+			operand = a;
+		}
+
+		bc_num_mulArray(operand, dig, c);
+
+		// Need to make sure the sign is correct.
+		if (BC_NUM_NONZERO(c))
+		{
+			c->rdx = BC_NUM_NEG_VAL(c, BC_NUM_NEG(a) != BC_NUM_NEG(b));
+		}
+
+		return;
+	}
+
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+
+	BC_SIG_LOCK;
+
+	// We need copies because of all of the mutation needed to make Karatsuba
+	// think the numbers are integers.
+	bc_num_init(&cpa, a->len + BC_NUM_RDX_VAL(a));
+	bc_num_init(&cpb, b->len + BC_NUM_RDX_VAL(b));
+
+	BC_SETJMP_LOCKED(vm, init_err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_copy(&cpa, a);
+	bc_num_copy(&cpb, b);
+
+	assert(BC_NUM_RDX_VALID_NP(cpa));
+	assert(BC_NUM_RDX_VALID_NP(cpb));
+
+	BC_NUM_NEG_CLR_NP(cpa);
+	BC_NUM_NEG_CLR_NP(cpb);
+
+	assert(BC_NUM_RDX_VALID_NP(cpa));
+	assert(BC_NUM_RDX_VALID_NP(cpb));
+
+	// These are what makes them appear like integers.
+	ardx = BC_NUM_RDX_VAL_NP(cpa) * BC_BASE_DIGS;
+	bc_num_shiftLeft(&cpa, ardx);
+
+	brdx = BC_NUM_RDX_VAL_NP(cpb) * BC_BASE_DIGS;
+	bc_num_shiftLeft(&cpb, brdx);
+
+	// We need to reset the jump here because azero and bzero are used in the
+	// cleanup, and local variables are not guaranteed to be the same after a
+	// jump.
+	BC_SIG_LOCK;
+
+	BC_UNSETJMP(vm);
+
+	// We want to ignore zero limbs.
+	azero = bc_num_shiftZero(&cpa);
+	bzero = bc_num_shiftZero(&cpb);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_clean(&cpa);
+	bc_num_clean(&cpb);
+
+	// If the product is going to be truncated, its low limbs do not need to be
+	// computed. This counts them, ignoring the zero limbs that were cut off.
+	drop = (ardx + brdx) / BC_BASE_DIGS;
+	drop = drop > BC_NUM_RDX(realscale) ? drop - BC_NUM_RDX(realscale) : 0;
+	drop = drop > azero + bzero ? drop - azero - bzero : 0;
+
+	// Keep a square a square so that bc_num_k() can take advantage of it.
+	if (!drop || !bc_num_m_short(&cpa, a == b ? &cpa : &cpb, c, drop))
+	{
+		bc_num_k(&cpa, a == b ? &cpa : &cpb, c);
+	}
+
+	// The return parameter needs to have its scale set. This is the start. It
+	// also needs to be shifted by the same amount as a and b have limbs after
+	// the decimal point.
+	zero = bc_vm_growSize(azero, bzero);
+	len = bc_vm_growSize(c->len, zero);
+
+	bc_num_expand(c, len);
+
+	// Shift c based on the limbs after the decimal point in a and b.
+	bc_num_shiftLeft(c, (len - c->len) * BC_BASE_DIGS);
+	bc_num_shiftRight(c, ardx + brdx);
+
+	bc_num_retireMul(c, realscale, BC_NUM_NEG(a), BC_NUM_NEG(b));
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_unshiftZero(&cpb, bzero);
+	bc_num_unshiftZero(&cpa, azero);
+init_err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&cpb);
+	bc_num_free(&cpa);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Returns true if the BcDig array has non-zero limbs, false otherwise.
+ * @param a    The array to test.
+ * @param len  The length of the array.
+ * @return     True if @a has any non-zero limbs, false otherwise.
+ */
+static bool
+bc_num_nonZeroDig(BcDig* restrict a, size_t len)
+{
+	size_t i;
+
+	for (i = len - 1; i < len; --i)
+	{
+		if (a[i] != 0) return true;
+	}
+
+	return false;
+}
+
+/**
+ * Compares a BcDig array against a BcNum. This is especially suited for
+ * division. Returns >0 if @a a is greater than @a b, <0 if it is less, and =0
+ * if they are equal.
+ * @param a    The array.
+ * @param b    The number.
+ * @param len  The length to assume the arrays are. This is always less than the
+ *             actual length because of how this is implemented.
+ */
+static ssize_t
+bc_num_divCmp(const BcDig* a, const BcNum* b, size_t len)
+{
+	ssize_t cmp;
+
+	if (b->len > len && a[len]) cmp = bc_num_compare(a, b->num, len + 1);
+	else if (b->len <= len)
+	{
+		if (a[len]) cmp = 1;
+		else cmp = bc_num_compare(a, b->num, len);
+	}
+	else cmp = -1;
+
+	return cmp;
+}
+
+/**
+ * Extends the two operands of a division by BC_BASE_DIGS minus the number of
+ * digits in the divisor estimate. In other words, it is shifting the numbers in
+ * order to force the divisor estimate to fill the limb.
+ * @param a        The first operand.
+ * @param b        The second operand.
+ * @param divisor  The divisor estimate.
+ */
+static void
+bc_num_divExtend(BcNum* restrict a, BcNum* restrict b, BcBigDig divisor)
+{
+	size_t pow;
+
+	assert(divisor < BC_BASE_POW);
+
+	pow = BC_BASE_DIGS - bc_num_log10((size_t) divisor);
+
+	bc_num_shiftLeft(a, pow);
+	bc_num_shiftLeft(b, pow);
+}
+
+/**
+ * Actually does division. This is a rewrite of my original code by Stefan Esser
+ * from FreeBSD.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_d_long(BcNum* restrict a, BcNum* restrict b, BcNum* restrict c,
+              size_t scale)
+{
+	BcBigDig divisor;
+	size_t i, rdx;
+	// This is volatile and len 2 and reallen exist to quiet the GCC warning
+	// about clobbering on longjmp(). This one is possible, I think.
+	volatile size_t len;
+	size_t len2, reallen;
+	// This is volatile and realend exists to quiet the GCC warning about
+	// clobbering on longjmp(). This one is possible, I think.
+	volatile size_t end;
+	size_t realend;
+	BcNum cpb;
+	// This is volatile and realnonzero exists to quiet the GCC warning about
+	// clobbering on longjmp(). This one is possible, I think.
+	volatile bool nonzero;
+	bool realnonzero;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(b->len < a->len);
+
+	len = b->len;
+	end = a->len - len;
+
+	assert(len >= 1);
+
+	// This is a final time to make sure c is big enough and that its array is
+	// properly zeroed.
+	bc_num_expand(c, a->len);
+	// NOLINTNEXTLINE
+	memset(c->num, 0, c->cap * sizeof(BcDig));
+
+	// Setup.
+	BC_NUM_RDX_SET(c, BC_NUM_RDX_VAL(a));
+	c->scale = a->scale;
+	c->len = a->len;
+
+	// This is pulling the most significant limb of b in order to establish a
+	// good "estimate" for the actual divisor.
+	divisor = (BcBigDig) b->num[len - 1];
+
+	// The entire bit of code in this if statement is to tighten the estimate of
+	// the divisor. The condition asks if b has any other non-zero limbs.
+	if (len > 1 && bc_num_nonZeroDig(b->num, len - 1))
+	{
+		// This takes a little bit of understanding. The "10*BC_BASE_DIGS/6+1"
+		// results in either 16 for 64-bit 9-digit limbs or 7 for 32-bit 4-digit
+		// limbs. Then it shifts a 1 by that many, which in both cases, puts the
+		// result above *half* of the max value a limb can store. Basically,
+		// this quickly calculates if the divisor is greater than half the max
+		// of a limb.
+		nonzero = (divisor > 1 << ((10 * BC_BASE_DIGS) / 6 + 1));
+
+		// If the divisor is *not* greater than half the limb...
+		if (!nonzero)
+		{
+			// Extend the parameters by the number of missing digits in the
+			// divisor.
+			bc_num_divExtend(a, b, divisor);
+
+			// Check bc_num_d(). In there, we grow a again and again. We do it
+			// again here; we *always* want to be sure it is big enough.
+			len2 = BC_MAX(a->len, b->len);
+			bc_num_expand(a, len2 + 1);
+
+			// Make a have a zero most significant limb to match the len.
+			if (len2 + 1 > a->len) a->len = len2 + 1;
+
+			// Grab the new divisor estimate, new because the shift has made it
+			// different.
+			reallen = b->len;
+			realend = a->len - reallen;
+			divisor = (BcBigDig) b->num[reallen - 1];
+
+			realnonzero = bc_num_nonZeroDig(b->num, reallen - 1);
+		}
+		else
+		{
+			realend = end;
+			realnonzero = nonzero;
+		}
+	}
+	else
+	{
+		realend = end;
+		realnonzero = false;
+	}
+
+	// If b has other nonzero limbs, we want the divisor to be one higher, so
+	// that it is an upper bound.
+	divisor += realnonzero;
+
+	// Make sure c can fit the new length.
+	bc_num_expand(c, a->len);
+	// NOLINTNEXTLINE
+	memset(c->num, 0, BC_NUM_SIZE(c->cap));
+
+	assert(c->scale >= scale);
+	rdx = BC_NUM_RDX_VAL(c) - BC_NUM_RDX(scale);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&cpb, len + 1);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// This is the actual division loop.
+	for (i = realend - 1; i < realend && i >= rdx && BC_NUM_NONZERO(a); --i)
+	{
+		ssize_t cmp;
+		BcDig* n;
+		BcBigDig result;
+
+		n = a->num + i;
+		assert(n >= a->num);
+		result = 0;
+
+		cmp = bc_num_divCmp(n, b, len);
+
+		// This is true if n is greater than b, which means that division can
+		// proceed, so this inner loop is the part that implements one instance
+		// of the division.
+		while (cmp >= 0)
+		{
+			BcBigDig n1, dividend, quotient;
+
+			// These should be named obviously enough. Just imagine that it's a
+			// division of one limb. Because that's what it is.
+			n1 = (BcBigDig) n[len];
+			dividend = n1 * BC_BASE_POW + (BcBigDig) n[len - 1];
+			quotient = (dividend / divisor);
+
+			// If this is true, then we can just subtract. Remember: setting
+			// quotient to 1 is not bad because we already know that n is
+			// greater than b.
+			if (quotient <= 1)
+			{
+				quotient = 1;
+				bc_num_subArrays(n, b->num, len);
+			}
+			else
+			{
+				assert(quotient <= BC_BASE_POW);
+
+				// We need to multiply and subtract for a quotient above 1.
+				bc_num_mulArray(b, (BcBigDig) quotient, &cpb);
+				bc_num_subArrays(n, cpb.num, cpb.len);
+			}
+
+			// The result is the *real* quotient, by the way, but it might take
+			// multiple trips around this loop to get it.
+			result += quotient;
+			assert(result <= BC_BASE_POW);
+
+			// And here's why it might take multiple trips: n might *still* be
+			// greater than b. So we have to loop again. That's what this is
+			// setting up for: the condition of the while loop.
+			if (realnonzero) cmp = bc_num_divCmp(n, b, len);
+			else cmp = -1;
+		}
+
+		assert(result < BC_BASE_POW);
+
+		// Store the actual limb quotient.
+		c->num[i] = (BcDig) result;
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&cpb);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Returns true if a division of an @a alen limb integer by a @a blen limb
+ * integer is big enough that long division would be slower than
+ * bc_num_divInt(). Long division is quadratic in the lengths of the divisor
+ * and the quotient, so both have to be big.
+ * @param alen  The length of the dividend.
+ * @param blen  The length of the divisor.
+ * @return      True if bc_num_divInt() should be used, false otherwise.
+ */
+static bool
+bc_num_divBig(size_t alen, size_t blen)
+{
+	return blen >= BC_NUM_BZ_LEN && alen >= blen + BC_NUM_BZ_LEN;
+}
+
+/**
+ * Returns true if a division of an @a alen limb integer by a @a blen limb
+ * integer is big enough for Newton division to beat Burnikel-Ziegler.
+ * @param alen  The length of the dividend.
+ * @param blen  The length of the divisor.
+ * @return      True if bc_num_divNewton() should be used, false otherwise.
+ */
+static bool
+bc_num_divNewtonOk(size_t alen, size_t blen)
+{
+	return blen >= BC_NUM_NEWTON_LEN && alen >= blen + BC_NUM_NEWTON_LEN;
+}
+
+/**
+ * Sets up @a d as a read-only view of the top limbs of the positive integer
+ * @a b with the radix point moved in front of them, which puts it in the range
+ * [1/BC_BASE_POW, 1). Only enough limbs are used for @a s decimal places plus
+ * some guard limbs.
+ * @param b  The number to view.
+ * @param s  The number of decimal places that the view should be good for.
+ * @param d  An out parameter; the view.
+ */
+static void
+bc_num_divFrac(const BcNum* restrict b, size_t s, BcNum* restrict d)
+{
+	size_t len = BC_MIN(b->len, bc_vm_growSize(BC_NUM_RDX(s), 2));
+
+	bc_num_view(b, b->len - len, len, d);
+
+	BC_NUM_RDX_SET_NEG(d, len, false);
+	d->scale = len * BC_BASE_DIGS;
+}
+
+/**
+ * Divides the integer @a a by the integer @a b with a reciprocal of @a b that
+ * is calculated by Newton's method, doubling the working precision on every
+ * step, so that the whole division costs a handful of multiplications. The
+ * quotient estimate can be off by a little, so it is fixed up with the
+ * remainder at the end.
+ * @param a  The dividend. It must be a non-negative integer.
+ * @param b  The divisor. It must be a positive integer.
+ * @param q  The return parameter for the quotient. It must be initialized.
+ * @param r  The return parameter for the remainder. It must be initialized.
+ */
+static void
+bc_num_divNewton(BcNum* a, BcNum* b, BcNum* restrict q, BcNum* restrict r)
+{
+	BcNum one, d, y, t, e, atop, qview;
+	BcDig one_digs[1];
+	size_t s, i, nsteps, shift;
+	size_t steps[sizeof(size_t) * CHAR_BIT];
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(!BC_NUM_NEG(a) && !BC_NUM_RDX_VAL(a));
+	assert(!BC_NUM_NEG(b) && !BC_NUM_RDX_VAL(b) && BC_NUM_NONZERO(b));
+
+	if (bc_num_cmp(a, b) < 0)
+	{
+		bc_num_zero(q);
+		bc_num_copy(r, a);
+		return;
+	}
+
+	// Figure out the precision of every Newton step, from the last one back.
+	// The last step needs the length of the quotient plus some guard limbs.
+	s = (a->len - b->len + 3) * BC_BASE_DIGS;
+
+	for (nsteps = 0; s > BC_NUM_NEWTON_START; ++nsteps)
+	{
+		steps[nsteps] = s;
+		s = s / 2 + BC_BASE_DIGS;
+	}
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_init(&y, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&e, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+
+	// The first estimate of the reciprocal is small enough for long division.
+	bc_num_divFrac(b, s, &d);
+	bc_num_div(&one, &d, &y, s);
+
+	for (i = nsteps - 1; i < nsteps; --i)
+	{
+		s = steps[i];
+
+		bc_num_divFrac(b, s, &d);
+
+		// This is the Newton iteration, y = y + y * (1 - d * y).
+		bc_num_mul(&d, &y, &t, s);
+		bc_num_sub(&one, &t, &e, s);
+		if (e.scale > s) bc_num_truncate(&e, e.scale - s);
+
+		bc_num_mul(&y, &e, &t, s);
+		bc_num_add(&y, &t, &y, s);
+		if (y.scale > s) bc_num_truncate(&y, y.scale - s);
+	}
+
+	// The limbs of a below the top of b can only change the estimate by one,
+	// so they are left out of the multiplication.
+	shift = b->len > 2 ? b->len - 2 : 0;
+	bc_num_view(a, shift, a->len - shift, &atop);
+
+	// The estimate is floor(atop * y / BC_BASE_POW^(b->len - shift)). Because
+	// y is 1/d, that is the integer limbs of the product, minus the bottom
+	// b->len - shift of them.
+	bc_num_mul(&atop, &y, &t, 0);
+	bc_num_view(&t, BC_NUM_RDX_VAL_NP(t) + b->len - shift, t.len, &qview);
+	bc_num_copy(q, &qview);
+
+	// Fix up the estimate with the remainder.
+	bc_num_mul(q, b, &t, 0);
+	bc_num_sub(a, &t, r, 0);
+
+	while (BC_NUM_NEG(r))
+	{
+		bc_num_sub(q, &one, q, 0);
+		bc_num_add(r, b, r, 0);
+	}
+
+	while (bc_num_cmp(r, b) >= 0)
+	{
+		bc_num_add(q, &one, q, 0);
+		bc_num_sub(r, b, r, 0);
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&e);
+	bc_num_free(&t);
+	bc_num_free(&y);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Divides the integer @a a by the integer @a b with long division and returns
+ * both the quotient and the remainder. This is the base case of
+ * Burnikel-Ziegler division. The top limb of @a b must be at least half of
+ * BC_BASE_POW, which keeps bc_num_d_long() from touching @a b.
+ * @param a  The dividend. It must be a non-negative integer.
+ * @param b  The divisor. It must be a positive integer.
+ * @param q  The return parameter for the quotient. It must be initialized.
+ * @param r  The return parameter for the remainder. It must be initialized.
+ */
+static void
+bc_num_divLong(BcNum* a, BcNum* b, BcNum* restrict q, BcNum* restrict r)
+{
+	assert(!BC_NUM_NEG(a) && !BC_NUM_RDX_VAL(a));
+	assert(!BC_NUM_NEG(b) && !BC_NUM_RDX_VAL(b) && BC_NUM_NONZERO(b));
+	assert(b->num[b->len - 1] >= BC_BASE_POW / 2);
+
+	if (bc_num_cmp(a, b) < 0)
+	{
+		bc_num_zero(q);
+		bc_num_copy(r, a);
+		return;
+	}
+
+	// bc_num_d_long() divides in place, so the dividend becomes the remainder.
+	// It also wants an extra zero limb on top.
+	bc_num_copy(r, a);
+	bc_num_expand(r, bc_vm_growSize(r->len, 1));
+	r->num[r->len++] = 0;
+
+	bc_num_d_long(r, b, q, 0);
+
+	bc_num_clean(q);
+	bc_num_clean(r);
+}
+
+/**
+ * Sets @a c to @a a * BC_BASE_POW^k + @a b, for non-negative integers, where
+ * @a b must be less than BC_BASE_POW^k. In other words, this puts the limbs of
+ * @a a above the bottom @a k limbs, which are taken from @a b.
+ * @param a  The high part.
+ * @param b  The low part.
+ * @param k  The number of limbs in the low part.
+ * @param c  The return parameter. It must be initialized and must not be
+ *           either of the other parameters.
+ */
+static void
+bc_num_join(const BcNum* restrict a, const BcNum* restrict b, size_t k,
+            BcNum* restrict c)
+{
+	size_t len;
+
+	assert(!BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b) && b->len <= k);
+
+	len = BC_NUM_NONZERO(a) ? bc_vm_growSize(a->len, k) : b->len;
+
+	bc_num_expand(c, len);
+
+	// NOLINTNEXTLINE
+	memcpy(c->num, b->num, BC_NUM_SIZE(b->len));
+
+	if (BC_NUM_NONZERO(a))
+	{
+		// NOLINTNEXTLINE
+		memset(c->num + b->len, 0, BC_NUM_SIZE(k - b->len));
+		// NOLINTNEXTLINE
+		memcpy(c->num + k, a->num, BC_NUM_SIZE(a->len));
+	}
+
+	c->len = len;
+	c->rdx = 0;
+	c->scale = 0;
+}
+
+static void
+bc_num_divBZ2(BcNum* a, BcNum* b, size_t n, BcNum* restrict q,
+              BcNum* restrict r);
+
+/**
+ * Divides a 3k-limb number by a 2k-limb number, the "3n/2n" half of
+ * Burnikel-Ziegler division. It estimates the quotient by dividing the top two
+ * thirds of @a a by the top half of @a b, which is a 2k/k division, and then
+ * corrects the estimate, which is off by at most two.
+ * @param a  The dividend. It must be less than @a b * BC_BASE_POW^k.
+ * @param b  The divisor. It must have exactly 2k limbs, and its top limb must
+ *           be at least half of BC_BASE_POW.
+ * @param k  Half the length of @a b.
+ * @param q  The return parameter for the quotient. It must be initialized.
+ * @param r  The return parameter for the remainder. It must be initialized.
+ */
+static void
+bc_num_divBZ3(BcNum* a, BcNum* b, size_t k, BcNum* restrict q,
+              BcNum* restrict r)
+{
+	BcNum a1, a12, a3, b1, b2, zero, one, t, d;
+	BcDig one_digs[1];
+	size_t i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(b->len == 2 * k);
+
+	bc_num_view(a, 2 * k, k, &a1);
+	bc_num_view(a, k, 2 * k, &a12);
+	bc_num_view(a, 0, k, &a3);
+	bc_num_view(b, k, k, &b1);
+	bc_num_view(b, 0, k, &b2);
+	bc_num_view(b, b->len, 0, &zero);
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_init(&t, bc_vm_growSize(b->len, 1));
+	bc_num_init(&d, bc_vm_growSize(b->len, 1));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+
+	if (bc_num_cmp(&a1, &b1) < 0) bc_num_divBZ2(&a12, &b1, k, q, &t);
+	else
+	{
+		// The quotient estimate is BC_BASE_POW^k - 1, which makes the
+		// remainder of the estimate a12 - b1 * BC_BASE_POW^k + b1.
+		bc_num_expand(q, k);
+		for (i = 0; i < k; ++i)
+		{
+			q->num[i] = BC_BASE_POW - 1;
+		}
+		q->len = k;
+		q->rdx = 0;
+		q->scale = 0;
+
+		bc_num_add(&a12, &b1, &t, 0);
+		bc_num_join(&b1, &zero, k, &d);
+		bc_num_sub(&t, &d, &t, 0);
+	}
+
+	// r = t * BC_BASE_POW^k + a3 - q * b2.
+	bc_num_mul(q, &b2, &d, 0);
+	bc_num_join(&t, &a3, k, r);
+	bc_num_clean(r);
+	bc_num_sub(r, &d, r, 0);
+
+	while (BC_NUM_NEG(r))
+	{
+		bc_num_sub(q, &one, q, 0);
+		bc_num_add(r, b, r, 0);
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&d);
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Divides a 2n-limb number by an n-limb number, the "2n/1n" half of
+ * Burnikel-Ziegler division. It does that with two 3n/2n divisions on halves,
+ * which recurse back here, so every level does its work with fast
+ * multiplication instead of long division.
+ * @param a  The dividend. It must be less than @a b * BC_BASE_POW^n.
+ * @param b  The divisor. It must have exactly @a n limbs, and its top limb must
+ *           be at least half of BC_BASE_POW.
+ * @param n  The length of @a b.
+ * @param q  The return parameter for the quotient. It must be initialized.
+ * @param r  The return parameter for the remainder. It must be initialized.
+ */
+static void
+bc_num_divBZ2(BcNum* a, BcNum* b, size_t n, BcNum* restrict q,
+              BcNum* restrict r)
+{
+	BcNum ahi, a4, q1, q2, t;
+	size_t k;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(b->len == n);
+
+	if ((n & 1) || n < BC_NUM_BZ_LEN)
+	{
+		bc_num_divLong(a, b, q, r);
+		return;
+	}
+
+	k = n / 2;
+
+	bc_num_view(a, k, 3 * k, &ahi);
+	bc_num_view(a, 0, k, &a4);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&q1, bc_vm_growSize(k, 1));
+	bc_num_init(&q2, bc_vm_growSize(k, 1));
+	bc_num_init(&t, bc_vm_growSize(a->len, 1));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// The top three quarters of a first, then the remainder with the last
+	// quarter brought down.
+	bc_num_divBZ3(&ahi, b, k, &q1, &t);
+	bc_num_join(&t, &a4, k, r);
+	bc_num_clean(r);
+	bc_num_divBZ3(r, b, k, &q2, &t);
+
+	bc_num_join(&q1, &q2, k, q);
+	bc_num_clean(q);
+	bc_num_copy(r, &t);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&t);
+	bc_num_free(&q2);
+	bc_num_free(&q1);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Divides the integer @a a by the integer @a b with Burnikel-Ziegler recursive
+ * division. The divisor is normalized and padded to a length that halves
+ * evenly down to the long division threshold, and then the dividend is
+ * divided one block of that length at a time with bc_num_divBZ2().
+ * @param a  The dividend. It must be a non-negative integer.
+ * @param b  The divisor. It must be a positive integer.
+ * @param q  The return parameter for the quotient. It must be initialized.
+ * @param r  The return parameter for the remainder. It must be initialized.
+ */
+static void
+bc_num_divBZ(BcNum* a, BcNum* b, BcNum* restrict q, BcNum* restrict r)
+{
+	BcNum na, nb, z, qi, ri, blk, zero;
+	BcBigDig f, rem;
+	size_t n, m, j, t, i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(!BC_NUM_NEG(a) && !BC_NUM_RDX_VAL(a));
+	assert(!BC_NUM_NEG(b) && !BC_NUM_RDX_VAL(b) && BC_NUM_NONZERO(b));
+
+	if (bc_num_cmp(a, b) < 0)
+	{
+		bc_num_zero(q);
+		bc_num_copy(r, a);
+		return;
+	}
+
+	// Pick the block length: m * 2^j, with m under the threshold, is the
+	// smallest length that halves evenly down to long division.
+	for (m = b->len, j = 0; m >= BC_NUM_BZ_LEN; ++j)
+	{
+		m = (m + 1) / 2;
+	}
+
+	n = m << j;
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&na, bc_vm_growSize(a->len, n));
+	bc_num_init(&nb, bc_vm_growSize(n, 1));
+	bc_num_init(&z, bc_vm_growSize(n, n));
+	bc_num_init(&qi, bc_vm_growSize(n, 1));
+	bc_num_init(&ri, bc_vm_growSize(n, 1));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_view(b, b->len, 0, &zero);
+
+	// Normalize, as in Knuth's Algorithm D: multiplying both operands by f
+	// puts the top limb of the divisor in the top half of a limb, which keeps
+	// the quotient estimates close. Then both are padded by whole limbs up to
+	// the block length. Neither changes the quotient.
+	f = BC_BASE_POW / ((BcBigDig) b->num[b->len - 1] + 1);
+
+	bc_num_mulArray(b, f, &z);
+	bc_num_join(&z, &zero, n - b->len, &nb);
+	bc_num_mulArray(a, f, &z);
+	bc_num_join(&z, &zero, n - b->len, &na);
+
+	assert(nb.len == n && nb.num[n - 1] >= BC_BASE_POW / 2);
+
+	// The number of blocks in a, with room for a zero limb on top, so that
+	// the top block is less than nb.
+	t = BC_MAX((na.len + n) / n, 2);
+
+	bc_num_expand(q, (t - 1) * n);
+	// NOLINTNEXTLINE
+	memset(q->num, 0, BC_NUM_SIZE(q->cap));
+	q->len = (t - 1) * n;
+	q->rdx = 0;
+	q->scale = 0;
+
+	// Divide one block at a time, from the top, bringing down the next block
+	// each time, just like long division does with limbs.
+	bc_num_view(&na, (t - 2) * n, 2 * n, &blk);
+	bc_num_copy(&z, &blk);
+
+	for (i = t - 2; i < t; --i)
+	{
+		bc_num_divBZ2(&z, &nb, n, &qi, &ri);
+
+		assert(qi.len <= n);
+
+		// NOLINTNEXTLINE
+		memcpy(q->num + i * n, qi.num, BC_NUM_SIZE(qi.len));
+
+		if (i)
+		{
+			bc_num_view(&na, (i - 1) * n, n, &blk);
+			bc_num_join(&ri, &blk, n, &z);
+			bc_num_clean(&z);
+		}
+	}
+
+	bc_num_clean(q);
+
+	// Undo the normalization on the remainder. It is exact.
+	bc_num_view(&ri, n - b->len, ri.len, &blk);
+	bc_num_expand(r, bc_vm_growSize(blk.len, 1));
+	r->rdx = 0;
+	r->scale = 0;
+	bc_num_divArray(&blk, f, r, &rem);
+
+	assert(!rem);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&ri);
+	bc_num_free(&qi);
+	bc_num_free(&z);
+	bc_num_free(&nb);
+	bc_num_free(&na);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Divides the non-negative integer @a a by the positive integer @a b, picking
+ * the fastest algorithm for the sizes.
+ * @param a  The dividend.
+ * @param b  The divisor.
+ * @param q  The return parameter for the quotient. It must be initialized.
+ * @param r  The return parameter for the remainder. It must be initialized.
+ */
+static void
+bc_num_divInt(BcNum* a, BcNum* b, BcNum* restrict q, BcNum* restrict r)
+{
+	BcNum atop, btop, one, t;
+	BcDig one_digs[1];
+	size_t qlen, shift;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	qlen = a->len >= b->len ? a->len - b->len + 1 : 0;
+
+	if (b->len <= qlen + 2)
+	{
+		if (bc_num_divNewtonOk(a->len, b->len)) bc_num_divNewton(a, b, q, r);
+		else bc_num_divBZ(a, b, q, r);
+		return;
+	}
+
+	// A short quotient only depends on the top limbs of the divisor. Dividing
+	// by those gives an estimate that is off by at most one, and then the
+	// estimate is fixed up with the remainder, which costs one unbalanced
+	// multiplication instead of a full size division.
+	shift = b->len - qlen - 2;
+	bc_num_view(a, shift, a->len - shift, &atop);
+	bc_num_view(b, shift, b->len - shift, &btop);
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_init(&t, bc_vm_growSize(a->len, 1));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+
+	bc_num_divInt(&atop, &btop, q, r);
+
+	bc_num_mul(q, b, &t, 0);
+	bc_num_sub(a, &t, r, 0);
+
+	while (BC_NUM_NEG(r))
+	{
+		bc_num_sub(q, &one, q, 0);
+		bc_num_add(r, b, r, 0);
+	}
+
+	while (bc_num_cmp(r, b) >= 0)
+	{
+		bc_num_add(q, &one, q, 0);
+		bc_num_sub(r, b, r, 0);
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Does division for big operands, where long division would be too slow. This
+ * has the same contract as bc_num_d_long(), but it leaves both operands alone.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_d_big(BcNum* restrict a, BcNum* restrict b, BcNum* restrict c,
+             size_t scale)
+{
+	BcNum atop, bview, q, r;
+	size_t rdx;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(b->len < a->len);
+
+	// Setup, same as bc_num_d_long().
+	bc_num_expand(c, a->len);
+	// NOLINTNEXTLINE
+	memset(c->num, 0, BC_NUM_SIZE(c->cap));
+
+	BC_NUM_RDX_SET(c, BC_NUM_RDX_VAL(a));
+	c->scale = a->scale;
+	c->len = a->len;
+
+	assert(c->scale >= scale);
+	rdx = BC_NUM_RDX_VAL(c) - BC_NUM_RDX(scale);
+
+	// The limbs below rdx would be truncated anyway, and because
+	// floor(floor(x) / y) == floor(x / y), they can just be left out. The
+	// views also drop the signs, which are for bc_num_retireMul() to handle.
+	bc_num_view(a, rdx, a->len - rdx, &atop);
+	bc_num_view(b, 0, b->len, &bview);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&q, BC_NUM_DEF_SIZE);
+	bc_num_init(&r, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_divInt(&atop, &bview, &q, &r);
+
+	assert(q.len <= c->len - rdx);
+
+	// NOLINTNEXTLINE
+	memcpy(c->num + rdx, q.num, BC_NUM_SIZE(q.len));
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&r);
+	bc_num_free(&q);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Implements division. This is a BcNumBinOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_d(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+{
+	size_t len, cpardx;
+	BcNum cpa, cpb;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (BC_NUM_ZERO(b)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+
+	if (BC_NUM_ZERO(a))
+	{
+		bc_num_setToZero(c, scale);
+		return;
+	}
+
+	if (BC_NUM_ONE(b))
+	{
+		bc_num_copy(c, a);
+		bc_num_retireMul(c, scale, BC_NUM_NEG(a), BC_NUM_NEG(b));
+		return;
+	}
+
+	// A one-limb integer divisor only needs short division, whatever the scale.
+	// Series like the ones in the math library divide by small integers a lot.
+	if (!BC_NUM_RDX_VAL(b) && b->len == 1)
+	{
+		bc_num_divShort(a, (BcBigDig) b->num[0], c, scale);
+		bc_num_retireMul(c, scale, BC_NUM_NEG(a), BC_NUM_NEG(b));
+		return;
+	}
+
+	len = bc_num_divReq(a, b, scale);
+
+	BC_SIG_LOCK;
+
+	// Initialize copies of the parameters. We want the length of the first
+	// operand copy to be as big as the result because of the way the division
+	// is implemented.
+	bc_num_init(&cpa, len);
+	bc_num_copy(&cpa, a);
+	bc_num_createCopy(&cpb, b);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	len = b->len;
+
+	// Like the above comment, we want the copy of the first parameter to be
+	// larger than the second parameter.
+	if (len > cpa.len)
+	{
+		bc_num_expand(&cpa, bc_vm_growSize(len, 2));
+		bc_num_extend(&cpa, (len - cpa.len) * BC_BASE_DIGS);
+	}
+
+	cpardx = BC_NUM_RDX_VAL_NP(cpa);
+	cpa.scale = cpardx * BC_BASE_DIGS;
+
+	// This is just setting up the scale in preparation for the division.
+	bc_num_extend(&cpa, b->scale);
+	cpardx = BC_NUM_RDX_VAL_NP(cpa) - BC_NUM_RDX(b->scale);
+	BC_NUM_RDX_SET_NP(cpa, cpardx);
+	cpa.scale = cpardx * BC_BASE_DIGS;
+
+	// Once again, just setting things up, this time to match scale.
+	if (scale > cpa.scale)
+	{
+		bc_num_extend(&cpa, scale);
+		cpardx = BC_NUM_RDX_VAL_NP(cpa);
+		cpa.scale = cpardx * BC_BASE_DIGS;
+	}
+
+	// Grow if necessary.
+	if (cpa.cap == cpa.len) bc_num_expand(&cpa, bc_vm_growSize(cpa.len, 1));
+
+	// We want an extra zero in front to make things simpler.
+	cpa.num[cpa.len++] = 0;
+
+	// Still setting things up. Why all of these things are needed is not
+	// something that can be easily explained, but it has to do with making the
+	// actual algorithm easier to understand because it can assume a lot of
+	// things. Thus, you should view all of this setup code as establishing
+	// assumptions for bc_num_d_long(), where the actual division happens.
+	if (cpardx == cpa.len) cpa.len = bc_num_nonZeroLen(&cpa);
+	if (BC_NUM_RDX_VAL_NP(cpb) == cpb.len) cpb.len = bc_num_nonZeroLen(&cpb);
+	cpb.scale = 0;
+	BC_NUM_RDX_SET_NP(cpb, 0);
+
+	// If both the divisor and the quotient are big, go for the fast methods.
+	len = BC_NUM_RDX_VAL_NP(cpa) - BC_NUM_RDX(scale);
+	len = cpa.len - BC_MIN(len, cpa.len);
+
+	if (bc_num_divBig(len, cpb.len)) bc_num_d_big(&cpa, &cpb, c, scale);
+	else bc_num_d_long(&cpa, &cpb, c, scale);
+
+	bc_num_retireMul(c, scale, BC_NUM_NEG(a), BC_NUM_NEG(b));
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&cpb);
+	bc_num_free(&cpa);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Implements divmod. This is the actual modulus function; since modulus
+ * requires a division anyway, this returns the quotient and modulus. Either can
+ * be thrown out as desired.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter for the quotient.
+ * @param d      The return parameter for the modulus.
+ * @param scale  The current scale.
+ * @param ts     The scale that the operation should be done to. Yes, it's not
+ *               necessarily the same as scale, per the bc spec.
+ */
+static void
+bc_num_r(BcNum* a, BcNum* b, BcNum* restrict c, BcNum* restrict d, size_t scale,
+         size_t ts)
+{
+	BcNum temp;
+	// realscale is meant to quiet a warning on GCC about longjmp() clobbering.
+	// This one is real.
+	size_t realscale;
+	bool neg;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (BC_NUM_ZERO(b)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+
+	if (BC_NUM_ZERO(a))
+	{
+		bc_num_setToZero(c, ts);
+		bc_num_setToZero(d, ts);
+		return;
+	}
+
+	// For big integers, the fast division algorithms give the remainder for
+	// free, so there is no need to multiply and subtract.
+	if (!ts && !BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b) &&
+	    bc_num_divBig(a->len, b->len))
+	{
+		BcNum aview, bview;
+
+		// The views drop the signs.
+		bc_num_view(a, 0, a->len, &aview);
+		bc_num_view(b, 0, b->len, &bview);
+
+		bc_num_divInt(&aview, &bview, c, d);
+
+		// The quotient is truncated toward zero, so the remainder has the
+		// sign of a.
+		c->rdx = BC_NUM_NEG_VAL(c, BC_NUM_NONZERO(c) &&
+		                               BC_NUM_NEG(a) != BC_NUM_NEG(b));
+		d->rdx = BC_NUM_NEG_VAL(d, BC_NUM_NONZERO(d) && BC_NUM_NEG(a));
+
+		return;
+	}
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&temp, d->cap);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// Division.
+	bc_num_d(a, b, c, scale);
+
+	// We want an extra digit so we can safely truncate.
+	if (scale) realscale = ts + 1;
+	else realscale = scale;
+
+	assert(BC_NUM_RDX_VALID(c));
+	assert(BC_NUM_RDX_VALID(b));
+
+	// Implement the rest of the (a - (a / b) * b) formula.
+	bc_num_m(c, b, &temp, realscale);
+	bc_num_sub(a, &temp, d, realscale);
+
+	// Extend if necessary.
+	if (ts > d->scale && BC_NUM_NONZERO(d)) bc_num_extend(d, ts - d->scale);
+
+	neg = BC_NUM_NEG(d);
+	bc_num_retireMul(d, ts, BC_NUM_NEG(a), BC_NUM_NEG(b));
+	d->rdx = BC_NUM_NEG_VAL(d, BC_NUM_NONZERO(d) ? neg : false);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&temp);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Implements modulus/remainder. (Yes, I know they are different, but not in the
+ * context of bc.) This is a BcNumBinOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_rem(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+{
+	BcNum c1;
+	size_t ts;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	ts = bc_vm_growSize(scale, b->scale);
+	ts = BC_MAX(ts, a->scale);
+
+	BC_SIG_LOCK;
+
+	// Need a temp for the quotient.
+	bc_num_init(&c1, bc_num_mulReq(a, b, ts));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_r(a, b, &c1, c, scale, ts);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&c1);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Implements power (exponentiation). This is a BcNumBinOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_p(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+{
+	BcNum copy, btemp;
+	BcBigDig exp;
+	// realscale is meant to quiet a warning on GCC about longjmp() clobbering.
+	// This one is real.
+	size_t powrdx, resrdx, realscale;
+	bool neg;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// This is here to silence a warning from GCC.
+#if BC_GCC
+	btemp.len = 0;
+	btemp.rdx = 0;
+	btemp.num = NULL;
+#endif // BC_GCC
+
+	if (BC_ERR(bc_num_nonInt(b, &btemp))) bc_err(BC_ERR_MATH_NON_INTEGER);
+
+	assert(btemp.len == 0 || btemp.num != NULL);
+
+	if (BC_NUM_ZERO(&btemp))
+	{
+		bc_num_one(c);
+		return;
+	}
+
+	if (BC_NUM_ZERO(a))
+	{
+		if (BC_NUM_NEG_NP(btemp)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+		bc_num_setToZero(c, scale);
+		return;
+	}
+
+	if (BC_NUM_ONE(&btemp))
+	{
+		if (!BC_NUM_NEG_NP(btemp)) bc_num_copy(c, a);
+		else bc_num_inv(a, c, scale);
+		return;
+	}
+
+	neg = BC_NUM_NEG_NP(btemp);
+	BC_NUM_NEG_CLR_NP(btemp);
+
+	exp = bc_num_bigdig(&btemp);
+
+	BC_SIG_LOCK;
+
+	bc_num_createCopy(&copy, a);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// If this is true, then we do not have to do a division, and we need to
+	// set scale accordingly.
+	if (!neg)
+	{
+		size_t max = BC_MAX(scale, a->scale), scalepow;
+		scalepow = bc_num_mulOverflow(a->scale, exp);
+		realscale = BC_MIN(scalepow, max);
+	}
+	else realscale = scale;
+
+	// This is only implementing the first exponentiation by squaring, until it
+	// reaches the first time where the square is actually used.
+	for (powrdx = a->scale; !(exp & 1); exp >>= 1)
+	{
+		powrdx <<= 1;
+		assert(BC_NUM_RDX_VALID_NP(copy));
+		bc_num_mul(&copy, &copy, &copy, powrdx);
+	}
+
+	// Make c a copy of copy for the purpose of saving the squares that should
+	// be saved.
+	bc_num_copy(c, &copy);
+	resrdx = powrdx;
+
+	// Now finish the exponentiation by squaring, this time saving the squares
+	// as necessary.
+	while (exp >>= 1)
+	{
+		powrdx <<= 1;
+		assert(BC_NUM_RDX_VALID_NP(copy));
+		bc_num_mul(&copy, &copy, &copy, powrdx);
+
+		// If this is true, we want to save that particular square. This does
+		// that by multiplying c with copy.
+		if (exp & 1)
+		{
+			resrdx += powrdx;
+			assert(BC_NUM_RDX_VALID(c));
+			assert(BC_NUM_RDX_VALID_NP(copy));
+			bc_num_mul(c, &copy, c, resrdx);
+		}
+	}
+
+	// Invert if necessary.
+	if (neg) bc_num_inv(c, c, realscale);
+
+	// Truncate if necessary.
+	if (c->scale > realscale) bc_num_truncate(c, c->scale - realscale);
+
+	bc_num_clean(c);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&copy);
+	BC_LONGJMP_CONT(vm);
+}
+
+#if BC_ENABLE_EXTRA_MATH
+/**
+ * Implements the places operator. This is a BcNumBinOp function.
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_place(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+{
+	BcBigDig val;
+
+	BC_UNUSED(scale);
+
+	val = bc_num_intop(a, b, c);
+
+	// Just truncate or extend as appropriate.
+	if (val < c->scale) bc_num_truncate(c, c->scale - val);
+	else if (val > c->scale) bc_num_extend(c, val - c->scale);
+}
+
+/**
+ * Implements the left shift operator. This is a BcNumBinOp function.
+ */
+static void
+bc_num_left(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+{
+	BcBigDig val;
+
+	BC_UNUSED(scale);
+
+	val = bc_num_intop(a, b, c);
+
+	bc_num_shiftLeft(c, (size_t) val);
+}
+
+/**
+ * Implements the right shift operator. This is a BcNumBinOp function.
+ */
+static void
+bc_num_right(BcNum* a, BcNum* b, BcNum* restrict c, size_t scale)
+{
+	BcBigDig val;
+
+	BC_UNUSED(scale);
+
+	val = bc_num_intop(a, b, c);
+
+	if (BC_NUM_ZERO(c)) return;
+
+	bc_num_shiftRight(c, (size_t) val);
+}
+#endif // BC_ENABLE_EXTRA_MATH
+
+/**
+ * Prepares for, and calls, a binary operator function. This is probably the
+ * most important function in the entire file because it establishes assumptions
+ * that make the rest of the code so easy. Those assumptions include:
+ *
+ * - a is not the same pointer as c.
+ * - b is not the same pointer as c.
+ * - there is enough room in c for the result.
+ *
+ * Without these, this whole function would basically have to be duplicated for
+ * *all* binary operators.
+ *
+ * @param a      The first operand.
+ * @param b      The second operand.
+ * @param c      The return parameter.
+ * @param scale  The current scale.
+ * @param req    The number of limbs needed to fit the result.
+ */
+static void
+bc_num_binary(BcNum* a, BcNum* b, BcNum* c, size_t scale, BcNumBinOp op,
+              size_t req)
+{
+	BcNum* ptr_a;
+	BcNum* ptr_b;
+	BcNum num2;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = NULL;
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && c != NULL && op != NULL);
+
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+
+	BC_SIG_LOCK;
+
+	ptr_a = c == a ? &num2 : a;
+	ptr_b = c == b ? &num2 : b;
+
+	// Actually reallocate. If we don't reallocate, we want to expand at the
+	// very least.
+	if (c == a || c == b)
+	{
+#if BC_ENABLE_LIBRARY
+		vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+		// NOLINTNEXTLINE
+		memcpy(&num2, c, sizeof(BcNum));
 
 		bc_num_init(c, req);
 
-		// Must prepare for cleanup. We want this here so that locals that got
-		// set stay set since a longjmp() is not guaranteed to preserve locals.
-		BC_SETJMP_LOCKED(vm, err);
-		BC_SIG_UNLOCK;
-	}
-	else
+		// Must prepare for cleanup. We want this here so that locals that got
+		// set stay set since a longjmp() is not guaranteed to preserve locals.
+		BC_SETJMP_LOCKED(vm, err);
+		BC_SIG_UNLOCK;
+	}
+	else
+	{
+		BC_SIG_UNLOCK;
+		bc_num_expand(c, req);
+	}
+
+	// It is okay for a and b to be the same. If a binary operator function does
+	// need them to be different, the binary operator function is responsible
+	// for that.
+
+	// Call the actual binary operator function.
+	op(ptr_a, ptr_b, c, scale);
+
+	assert(!BC_NUM_NEG(c) || BC_NUM_NONZERO(c));
+	assert(BC_NUM_RDX_VAL(c) <= c->len || !c->len);
+	assert(BC_NUM_RDX_VALID(c));
+	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
+
+err:
+	// Cleanup only needed if we initialized c to a new number.
+	if (c == a || c == b)
+	{
+		BC_SIG_MAYLOCK;
+		bc_num_free(&num2);
+		BC_LONGJMP_CONT(vm);
+	}
+}
+
+/**
+ * Tests a number string for validity. This function has a history; I originally
+ * wrote it because I did not trust my parser. Over time, however, I came to
+ * trust it, so I was able to relegate this function to debug builds only, and I
+ * used it in assert()'s. But then I created the library, and well, I can't
+ * trust users, so I reused this for yelling at users.
+ * @param val  The string to check to see if it's a valid number string.
+ * @return     True if the string is a valid number string, false otherwise.
+ */
+bool
+bc_num_strValid(const char* restrict val)
+{
+	bool radix = false;
+	size_t i, len = strlen(val);
+
+	// Notice that I don't check if there is a negative sign. That is not part
+	// of a valid number, except in the library. The library-specific code takes
+	// care of that part.
+
+	// Nothing in the string is okay.
+	if (!len) return true;
+
+	// Loop through the characters.
+	for (i = 0; i < len; ++i)
+	{
+		BcDig c = val[i];
+
+		// If we have found a radix point...
+		if (c == '.')
+		{
+			// We don't allow two radices.
+			if (radix) return false;
+
+			radix = true;
+			continue;
+		}
+
+		// We only allow digits and uppercase letters.
+		if (!(isdigit(c) || isupper(c))) return false;
+	}
+
+	return true;
+}
+
+/**
+ * Parses one character and returns the digit that corresponds to that
+ * character according to the base.
+ * @param c     The character to parse.
+ * @param base  The base.
+ * @return      The character as a digit.
+ */
+static BcBigDig
+bc_num_parseChar(char c, size_t base)
+{
+	assert(isupper(c) || isdigit(c));
+
+	// If a letter...
+	if (isupper(c))
+	{
+#if BC_ENABLE_LIBRARY
+		BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+		// This returns the digit that directly corresponds with the letter.
+		c = BC_NUM_NUM_LETTER(c);
+
+		// If the digit is greater than the base, we clamp.
+		if (BC_DIGIT_CLAMP)
+		{
+			c = ((size_t) c) >= base ? (char) base - 1 : c;
+		}
+	}
+	// Straight convert the digit to a number.
+	else c -= '0';
+
+	return (BcBigDig) (uchar) c;
+}
+
+/**
+ * Parses a string as a decimal number. This is separate because it's going to
+ * be the most used, and it can be heavily optimized for decimal only.
+ * @param n    The number to parse into and return. Must be preallocated.
+ * @param val  The string to parse.
+ */
+static void
+bc_num_parseDecimal(BcNum* restrict n, const char* restrict val)
+{
+	size_t len, i, temp, mod;
+	const char* ptr;
+	bool zero = true, rdx;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// Eat leading zeroes.
+	for (i = 0; val[i] == '0'; ++i)
+	{
+		continue;
+	}
+
+	val += i;
+	assert(!val[0] || isalnum(val[0]) || val[0] == '.');
+
+	// All 0's. We can just return, since this procedure expects a virgin
+	// (already 0) BcNum.
+	if (!val[0]) return;
+
+	// The length of the string is the length of the number, except it might be
+	// one bigger because of a decimal point.
+	len = strlen(val);
+
+	// Find the location of the decimal point.
+	ptr = strchr(val, '.');
+	rdx = (ptr != NULL);
+
+	// We eat leading zeroes again. These leading zeroes are different because
+	// they will come after the decimal point if they exist, and since that's
+	// the case, they must be preserved.
+	for (i = 0; i < len && (zero = (val[i] == '0' || val[i] == '.')); ++i)
+	{
+		continue;
+	}
+
+	// Set the scale of the number based on the location of the decimal point.
+	// The casts to uintptr_t is to ensure that bc does not hit undefined
+	// behavior when doing math on the values.
+	n->scale = (size_t) (rdx *
+	                     (((uintptr_t) (val + len)) - (((uintptr_t) ptr) + 1)));
+
+	// Set rdx.
+	BC_NUM_RDX_SET(n, BC_NUM_RDX(n->scale));
+
+	// Calculate length. First, the length of the integer, then the number of
+	// digits in the last limb, then the length.
+	i = len - (ptr == val ? 0 : i) - rdx;
+	temp = BC_NUM_ROUND_POW(i);
+	mod = n->scale % BC_BASE_DIGS;
+	i = mod ? BC_BASE_DIGS - mod : 0;
+	n->len = ((temp + i) / BC_BASE_DIGS);
+
+	// Expand and zero. The plus extra is in case the lack of clamping causes
+	// the number to overflow the original bounds.
+	bc_num_expand(n, n->len + !BC_DIGIT_CLAMP);
+	// NOLINTNEXTLINE
+	memset(n->num, 0, BC_NUM_SIZE(n->len + !BC_DIGIT_CLAMP));
+
+	if (zero)
+	{
+		// I think I can set rdx directly to zero here because n should be a
+		// new number with sign set to false.
+		n->len = n->rdx = 0;
+	}
+	else
+	{
+		// There is actually stuff to parse if we make it here. Yay...
+		BcBigDig exp, pow;
+
+		assert(i <= BC_NUM_BIGDIG_MAX);
+
+		// The exponent and power.
+		exp = (BcBigDig) i;
+		pow = bc_num_pow10[exp];
+
+		// Parse loop. We parse backwards because numbers are stored little
+		// endian.
+		for (i = len - 1; i < len; --i, ++exp)
+		{
+			char c = val[i];
+
+			// Skip the decimal point.
+			if (c == '.') exp -= 1;
+			else
+			{
+				// The index of the limb.
+				size_t idx = exp / BC_BASE_DIGS;
+				BcBigDig dig;
+
+				if (isupper(c))
+				{
+					// Clamp for the base.
+					if (!BC_DIGIT_CLAMP) c = BC_NUM_NUM_LETTER(c);
+					else c = 9;
+				}
+				else c -= '0';
+
+				// Add the digit to the limb. This takes care of overflow from
+				// lack of clamping.
+				dig = ((BcBigDig) n->num[idx]) + ((BcBigDig) c) * pow;
+				if (dig >= BC_BASE_POW)
+				{
+					// We cannot go over BC_BASE_POW with clamping.
+					assert(!BC_DIGIT_CLAMP);
+
+					n->num[idx + 1] = (BcDig) (dig / BC_BASE_POW);
+					n->num[idx] = (BcDig) (dig % BC_BASE_POW);
+					assert(n->num[idx] >= 0 && n->num[idx] < BC_BASE_POW);
+					assert(n->num[idx + 1] >= 0 &&
+					       n->num[idx + 1] < BC_BASE_POW);
+				}
+				else
+				{
+					n->num[idx] = (BcDig) dig;
+					assert(n->num[idx] >= 0 && n->num[idx] < BC_BASE_POW);
+				}
+
+				// Adjust the power and exponent.
+				if ((exp + 1) % BC_BASE_DIGS == 0) pow = 1;
+				else pow *= BC_BASE;
+			}
+		}
+	}
+
+	// Make sure to add one to the length if needed from lack of clamping.
+	n->len += (!BC_DIGIT_CLAMP && n->num[n->len] != 0);
+}
+
+/**
+ * Updates the cached exponent, power, and remainder for @a base, if it is not
+ * the last base that was used, and throws out the cached powers of the old
+ * base. The cached values are there to prevent us from calculating them every
+ * time because printing and parsing will probably happen multiple times in the
+ * same base.
+ * @param base  The base to use.
+ */
+static void
+bc_num_setBase(BcBigDig base)
+{
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (base == vm->last_base) return;
+
+	vm->last_pow = 1;
+	vm->last_exp = 0;
+
+	// Calculate the exponent and power.
+	while (vm->last_pow * base <= BC_BASE_POW)
+	{
+		vm->last_pow *= base;
+		vm->last_exp += 1;
+	}
+
+	// Also, the remainder and base itself.
+	vm->last_rem = BC_BASE_POW - vm->last_pow;
+	vm->last_base = base;
+
+	bc_vec_popAll(&vm->pows);
+}
+
+/**
+ * Pushes the next power onto a cache of powers. Each power is the square of
+ * the last, so the power at index i is @a root^(2^i).
+ * @param pows  The cache of powers.
+ * @param root  The power at index 0.
+ */
+static void
+bc_num_pushPow(BcVec* restrict pows, BcBigDig root)
+{
+	BcNum* pow;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	BC_SIG_LOCK;
+
+	pow = bc_vec_pushEmpty(pows);
+	bc_num_init(pow, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	if (pows->len == 1) bc_num_bigdig2num(pow, root);
+	else
+	{
+		BcNum* last = bc_vec_item(pows, pows->len - 2);
+		bc_num_mul(last, last, pow, 0);
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	// A power that was interrupted is thrown out; it would be wrong.
+	if (BC_SIG_EXC(vm)) bc_vec_pop(pows);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Makes sure that the cached powers of vm->last_pow go up to at least index
+ * @a i and returns the one at index @a i. Because this can push onto the
+ * cache, pointers to powers are only good until the next call.
+ * @param i  The index of the power to return.
+ * @return   vm->last_pow^(2^i).
+ */
+static BcNum*
+bc_num_basePow(size_t i)
+{
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	while (vm->pows.len <= i)
+	{
+		bc_num_pushPow(&vm->pows, vm->last_pow);
+	}
+
+	return bc_vec_item(&vm->pows, i);
+}
+
+/**
+ * Makes sure that the cached powers of 2 for binary conversion go up to at
+ * least index @a i and returns the one at index @a i. Because this can push
+ * onto the cache, pointers to powers are only good until the next call.
+ * @param i  The index of the power to return.
+ * @return   2^(BC_NUM_BIN_BITS * 2^i / 2), so index 1 is the first that is a
+ *           whole number of words.
+ */
+static BcNum*
+bc_num_binPow(size_t i)
+{
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	while (vm->bin_pows.len <= i)
+	{
+		bc_num_pushPow(&vm->bin_pows,
+		               ((BcBigDig) 1) << (BC_NUM_BIN_BITS / 2));
+	}
+
+	return bc_vec_item(&vm->bin_pows, i);
+}
+
+/**
+ * Converts the first @a len limbs of @a n, a non-negative integer, to binary
+ * with Horner's method, one limb at a time from the top. This is quadratic, so
+ * it is only for small numbers.
+ * @param n    The number to convert.
+ * @param w    The return parameter; little-endian words. It must have room for
+ *             @a wlen words.
+ * @param wlen The number of words in @a w. It must be enough to hold @a n.
+ */
+static void
+bc_num_toBinLimbs(const BcNum* restrict n, uint32_t* restrict w, size_t wlen)
+{
+	size_t i, j;
+
+	// NOLINTNEXTLINE
+	memset(w, 0, wlen * sizeof(uint32_t));
+
+	for (i = n->len - 1; i < n->len; --i)
+	{
+		uint64_t carry = (uint64_t) n->num[i];
+
+		for (j = 0; j < wlen; ++j)
+		{
+			carry += ((uint64_t) w[j]) * BC_BASE_POW;
+			w[j] = (uint32_t) carry;
+			carry >>= BC_NUM_BIN_BITS;
+		}
+
+		assert(!carry);
+	}
+}
+
+/**
+ * Converts the non-negative integer @a n to binary with divide and conquer: it
+ * is split into high and low words with a cached power of 2, and both are
+ * converted recursively.
+ * @param n      The number to convert.
+ * @param w      The return parameter; little-endian words. It must have room
+ *               for @a wlen words.
+ * @param wlen   The number of words in @a w. It must be enough to hold @a n.
+ * @param level  The index of the cached power of 2 to split with. If it is
+ *               less than 2, @a n is not split. All of the cached powers up to
+ *               it must exist.
+ */
+static void
+bc_num_toBinTree(BcNum* restrict n, uint32_t* restrict w, size_t wlen,
+                 size_t level)
+{
+	BcNum q, r;
+	size_t h;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// The low half has to be shorter than the whole.
+	while (level > 1 && ((size_t) 1) << (level - 1) >= wlen)
+	{
+		level -= 1;
+	}
+
+	if (level < 2 || n->len < BC_NUM_RADIX_LEN)
+	{
+		bc_num_toBinLimbs(n, w, wlen);
+		return;
+	}
+
+	// The number of words in the low half.
+	h = ((size_t) 1) << (level - 1);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&q, n->len);
+	bc_num_init(&r, n->len);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_divInt(n, bc_vec_item(&vm->bin_pows, level), &q, &r);
+
+	bc_num_toBinTree(&r, w, h, level - 1);
+	bc_num_toBinTree(&q, w + h, wlen - h, level - 1);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&r);
+	bc_num_free(&q);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Converts the non-negative integer @a n to binary. Because each limb is less
+ * than 2^BC_NUM_BIN_BITS, the result never has more words than @a n has limbs.
+ * @param n  The number to convert.
+ * @param w  The return parameter; little-endian words. It must have room for
+ *           as many words as @a n has limbs.
+ */
+static void
+bc_num_toBin(BcNum* restrict n, uint32_t* restrict w)
+{
+	size_t level;
+
+	if (n->len < BC_NUM_RADIX_LEN)
+	{
+		bc_num_toBinLimbs(n, w, n->len);
+		return;
+	}
+
+	// Find the first cached power that has more than half of the words. The
+	// words of a split are then in the low half and the quotient.
+	for (level = 1; (((size_t) 1) << level) < n->len; ++level)
+	{
+		continue;
+	}
+
+	bc_num_binPow(level);
+
+	bc_num_toBinTree(n, w, n->len, level);
+}
+
+/**
+ * Converts the non-negative integer @a n to binary like bc_num_toBin() and
+ * returns the number of bits in it, which is what the users of the bits need to
+ * know where to start.
+ * @param n  The number to convert. It must not be zero.
+ * @param w  The return parameter; little-endian words. It must have room for
+ *           as many words as @a n has limbs.
+ * @return   The number of bits in @a n, without leading zeroes.
+ */
+static size_t
+bc_num_toBinBits(BcNum* restrict n, uint32_t* restrict w)
+{
+	size_t wlen, bits;
+	uint32_t top;
+
+	assert(BC_NUM_NONZERO(n));
+
+	bc_num_toBin(n, w);
+
+	// Find the top word, and then the top bit in it.
+	for (wlen = n->len; !w[wlen - 1]; --wlen)
+	{
+		continue;
+	}
+
+	bits = (wlen - 1) * BC_NUM_BIN_BITS;
+
+	for (top = w[wlen - 1]; top; top >>= 1)
+	{
+		bits += 1;
+	}
+
+	return bits;
+}
+
+/**
+ * Converts @a wlen little-endian words of binary to a number with Horner's
+ * method, one word at a time from the top. This is quadratic, so it is only
+ * for small numbers.
+ * @param n     The return parameter. It must be initialized.
+ * @param w     The words to convert.
+ * @param wlen  The number of words.
+ */
+static void
+bc_num_fromBinLimbs(BcNum* restrict n, const uint32_t* restrict w, size_t wlen)
+{
+	size_t i, j, len;
+
+	// Every word needs at most this many limbs.
+	len = wlen * ((BC_NUM_BIN_BITS + 3 * BC_BASE_DIGS - 1) / (3 * BC_BASE_DIGS));
+
+	bc_num_expand(n, bc_vm_growSize(len, 1));
+	bc_num_zero(n);
+
+	for (i = wlen - 1; i < wlen; --i)
+	{
+		uint64_t carry = w[i];
+
+		for (j = 0; j < n->len; ++j)
+		{
+			carry += ((uint64_t) n->num[j]) << BC_NUM_BIN_BITS;
+			n->num[j] = (BcDig) (carry % BC_BASE_POW);
+			carry /= BC_BASE_POW;
+		}
+
+		while (carry)
+		{
+			n->num[n->len++] = (BcDig) (carry % BC_BASE_POW);
+			carry /= BC_BASE_POW;
+		}
+	}
+
+	bc_num_clean(n);
+}
+
+/**
+ * Converts @a wlen little-endian words of binary to a number with divide and
+ * conquer: the words are split at a cached power of 2, both parts are
+ * converted recursively, and then they are put back together with one
+ * multiplication.
+ * @param n      The return parameter. It must be initialized.
+ * @param w      The words to convert.
+ * @param wlen   The number of words.
+ * @param level  The index of the largest cached power of 2 that may be used to
+ *               split. All of the cached powers up to it must exist.
+ */
+static void
+bc_num_fromBinTree(BcNum* restrict n, const uint32_t* restrict w, size_t wlen,
+                   size_t level)
+{
+	BcNum hi, lo;
+	size_t h;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// The low part has to be shorter than the whole.
+	while (level > 1 && ((size_t) 1) << (level - 1) >= wlen)
+	{
+		level -= 1;
+	}
+
+	if (level < 2 || wlen < BC_NUM_RADIX_LEN)
+	{
+		bc_num_fromBinLimbs(n, w, wlen);
+		return;
+	}
+
+	// The number of words in the low part.
+	h = ((size_t) 1) << (level - 1);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&hi, BC_NUM_DEF_SIZE);
+	bc_num_init(&lo, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_fromBinTree(&hi, w + h, wlen - h, level);
+	bc_num_fromBinTree(&lo, w, h, level);
+
+	bc_num_mul(&hi, bc_vec_item(&vm->bin_pows, level), n, 0);
+	bc_num_add(n, &lo, n, 0);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&lo);
+	bc_num_free(&hi);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Converts @a wlen little-endian words of binary to a number.
+ * @param n     The return parameter. It must be initialized.
+ * @param w     The words to convert.
+ * @param wlen  The number of words.
+ */
+static void
+bc_num_fromBin(BcNum* restrict n, const uint32_t* restrict w, size_t wlen)
+{
+	size_t level;
+
+	// Leading zero words would only make more work.
+	while (wlen && !w[wlen - 1])
+	{
+		wlen -= 1;
+	}
+
+	if (wlen < BC_NUM_RADIX_LEN)
+	{
+		bc_num_fromBinLimbs(n, w, wlen);
+		return;
+	}
+
+	// Find the largest cached power with fewer words than wlen.
+	for (level = 1; (((size_t) 1) << level) < wlen; ++level)
+	{
+		continue;
+	}
+
+	bc_num_binPow(level);
+
+	bc_num_fromBinTree(n, w, wlen, level);
+}
+
+/**
+ * Packs little-endian words of binary into little-endian binary limbs.
+ * @param d     The return parameter; the limbs. It must have room for @a dlen
+ *              limbs.
+ * @param dlen  The number of limbs to return. The limbs above @a w are zero.
+ * @param w     The words to pack.
+ * @param wlen  The number of words.
+ */
+static void
+bc_num_binPack(BcBinDig* restrict d, size_t dlen, const uint32_t* restrict w,
+               size_t wlen)
+{
+	size_t i, j, k;
+
+	for (i = 0; i < dlen; ++i)
+	{
+		d[i] = 0;
+
+		for (j = 0, k = i * BC_NUM_BINDIG_WORDS;
+		     j < BC_NUM_BINDIG_WORDS && k < wlen; ++j, ++k)
+		{
+			d[i] |= ((BcBinDig) w[k]) << (j * BC_NUM_BIN_BITS);
+		}
+	}
+}
+
+/**
+ * Unpacks little-endian binary limbs into little-endian words of binary.
+ * @param w     The return parameter; the words. It must have room for
+ *              @a dlen * BC_NUM_BINDIG_WORDS words.
+ * @param d     The limbs to unpack.
+ * @param dlen  The number of limbs.
+ */
+static void
+bc_num_binUnpack(uint32_t* restrict w, const BcBinDig* restrict d, size_t dlen)
+{
+	size_t i, j;
+
+	for (i = 0; i < dlen; ++i)
+	{
+		for (j = 0; j < BC_NUM_BINDIG_WORDS; ++j)
+		{
+			w[i * BC_NUM_BINDIG_WORDS + j] =
+				(uint32_t) (d[i] >> (j * BC_NUM_BIN_BITS));
+		}
+	}
+}
+
+/**
+ * Returns the number of binary limbs that hold the binary form of a number
+ * with @a len limbs.
+ * @param len  The number of limbs.
+ * @return     The number of binary limbs.
+ */
+static size_t
+bc_num_binLen(size_t len)
+{
+	return (len + BC_NUM_BINDIG_WORDS - 1) / BC_NUM_BINDIG_WORDS;
+}
+
+/**
+ * Returns the number of bits in a digit of the power of 2 base @a base.
+ * @param base  The base. It must be a power of 2.
+ * @return      log2(@a base).
+ */
+static size_t
+bc_num_log2(BcBigDig base)
+{
+	size_t k;
+
+	assert(BC_NUM_BASE_POW2(base));
+
+	for (k = 0; (((BcBigDig) 1) << k) < base; ++k)
+	{
+		continue;
+	}
+
+	return k;
+}
+
+/**
+ * Parses the first @a len characters of @a val as an integer in base @a base,
+ * which must be a power of 2. The digits are put straight into binary, where
+ * each one is just a few bits, and then the binary is converted once.
+ * @param n     The number to parse into and return. Must be preallocated and
+ *              zero.
+ * @param val   The string to parse.
+ * @param len   The number of digits to parse.
+ * @param base  The base to parse as.
+ */
+static void
+bc_num_parseBin(BcNum* restrict n, const char* restrict val, size_t len,
+                BcBigDig base)
+{
+	uint32_t* w;
+	size_t i, j, bit, k, wlen;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	k = bc_num_log2(base);
+
+	// Digits can be bigger than the base if they are not clamped, so there is
+	// room for a few more bits on top.
+	wlen = bc_vm_growSize(len * k / BC_NUM_BIN_BITS, 2);
+
+	BC_SIG_LOCK;
+
+	w = bc_vm_malloc(bc_vm_arraySize(wlen, sizeof(uint32_t)));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// NOLINTNEXTLINE
+	memset(w, 0, wlen * sizeof(uint32_t));
+
+	for (i = 0, bit = 0; i < len; ++i, bit += k)
+	{
+		// The digits are added in, instead of or'ed in, because of unclamped
+		// digits.
+		uint64_t acc = ((uint64_t) bc_num_parseChar(val[len - 1 - i], base))
+		               << (bit % BC_NUM_BIN_BITS);
+
+		for (j = bit / BC_NUM_BIN_BITS; acc; ++j)
+		{
+			assert(j < wlen);
+			acc += w[j];
+			w[j] = (uint32_t) acc;
+			acc >>= BC_NUM_BIN_BITS;
+		}
+	}
+
+	bc_num_fromBin(n, w, wlen);
+
+err:
+	BC_SIG_MAYLOCK;
+	free(w);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Parses the first @a len characters of @a val as an integer in base @a base,
+ * one digit at a time, by multiplying by the base and adding the digit.
+ * @param n     The number to parse into and return. Must be preallocated and
+ *              zero.
+ * @param val   The string to parse.
+ * @param len   The number of digits to parse.
+ * @param base  The base to parse as.
+ */
+static void
+bc_num_parseDigits(BcNum* restrict n, const char* restrict val, size_t len,
+                   BcBigDig base)
+{
+	BcNum temp, mult;
+	BcBigDig v;
+	size_t i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&temp, BC_NUM_BIGDIG_LOG10);
+	bc_num_init(&mult, BC_NUM_BIGDIG_LOG10);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	for (i = 0; i < len; ++i)
+	{
+		// Convert the character to a digit.
+		v = bc_num_parseChar(val[i], base);
+
+		// Multiply the number.
+		bc_num_mulArray(n, base, &mult);
+
+		// Convert the digit to a number and add.
+		bc_num_bigdig2num(&temp, v);
+		bc_num_add(&mult, &temp, n, 0);
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&mult);
+	bc_num_free(&temp);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Parses the first @a len characters of @a val as an integer in base @a base
+ * with divide and conquer: the digits are split into a high part and a low
+ * part with a length that is a cached power of the base, and both are parsed
+ * recursively and put back together with one multiplication by that power.
+ * That takes near multiplication time instead of the quadratic time of
+ * bc_num_parseDigits(), which is only used on small pieces.
+ * @param n      The number to parse into and return. Must be preallocated and
+ *               zero.
+ * @param val    The string to parse.
+ * @param len    The number of digits to parse.
+ * @param base   The base to parse as.
+ * @param level  The index of the largest cached power of the base that may be
+ *               used to split. All of the cached powers up to it must exist.
+ */
+static void
+bc_num_parseTree(BcNum* restrict n, const char* restrict val, size_t len,
+                 BcBigDig base, size_t level)
+{
+	BcNum hi, lo;
+	size_t digs;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (len < vm->last_exp * BC_NUM_RADIX_LEN)
+	{
+		bc_num_parseDigits(n, val, len, base);
+		return;
+	}
+
+	// The low part has to be shorter than the whole.
+	while (level && (vm->last_exp << level) >= len)
+	{
+		level -= 1;
+	}
+
+	digs = vm->last_exp << level;
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&hi, BC_NUM_DEF_SIZE);
+	bc_num_init(&lo, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_parseTree(&hi, val, len - digs, base, level);
+	bc_num_parseTree(&lo, val + len - digs, digs, base, level);
+
+	bc_num_mul(&hi, bc_vec_item(&vm->pows, level), n, 0);
+	bc_num_add(n, &lo, n, 0);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&lo);
+	bc_num_free(&hi);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Parse a number in any base (besides decimal).
+ * @param n     The number to parse into and return. Must be preallocated.
+ * @param val   The string to parse.
+ * @param base  The base to parse as.
+ */
+static void
+bc_num_parseBase(BcNum* restrict n, const char* restrict val, BcBigDig base)
+{
+	BcNum temp, mult1, mult2, result1, result2;
+	BcNum* m1;
+	BcNum* m2;
+	BcNum* ptr;
+	char c = 0;
+	bool zero = true;
+	BcBigDig v;
+	size_t digs, level, len = strlen(val);
+	// This is volatile to quiet a warning on GCC about longjmp() clobbering.
+	volatile size_t i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// If zero, just return because the number should be virgin (already 0).
+	for (i = 0; zero && i < len; ++i)
+	{
+		zero = (val[i] == '.' || val[i] == '0');
+	}
+	if (zero) return;
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&temp, BC_NUM_BIGDIG_LOG10);
+	bc_num_init(&mult1, BC_NUM_BIGDIG_LOG10);
+
+	BC_SETJMP_LOCKED(vm, int_err);
+
+	BC_SIG_UNLOCK;
+
+	// We split parsing into parsing the integer and parsing the fractional
+	// part.
+
+	// Find the end of the integer part.
+	for (i = 0; i < len && val[i] != '.'; ++i)
+	{
+		continue;
+	}
+
+	// Parse the integer part. This is the easy part because we just multiply
+	// the number by the base, then add the digit. If it is big, we use divide
+	// and conquer.
+	bc_num_setBase(base);
+
+	if (BC_NUM_BASE_POW2(base)) bc_num_parseBin(n, val, i, base);
+	else if (i >= vm->last_exp * BC_NUM_RADIX_LEN)
+	{
+		// Find the largest cached power with fewer digits than the integer
+		// part, making sure that all of the powers up to it exist.
+		for (level = 0; (vm->last_exp << (level + 1)) < i; ++level)
+		{
+			continue;
+		}
+
+		bc_num_basePow(level);
+
+		bc_num_parseTree(n, val, i, base, level);
+	}
+	else bc_num_parseDigits(n, val, i, base);
+
+	// If this condition is true, then we are done. We still need to do cleanup
+	// though.
+	if (i == len && !val[i]) goto int_err;
+
+	// If we get here, we *must* be at the radix point.
+	assert(val[i] == '.');
+
+	BC_SIG_LOCK;
+
+	// Unset the jump to reset in for these new initializations.
+	BC_UNSETJMP(vm);
+
+	bc_num_init(&mult2, BC_NUM_BIGDIG_LOG10);
+	bc_num_init(&result1, BC_NUM_DEF_SIZE);
+	bc_num_init(&result2, BC_NUM_DEF_SIZE);
+	bc_num_one(&mult1);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// Pointers for easy switching.
+	m1 = &mult1;
+	m2 = &mult2;
+
+	// Parse the fractional part. This is the hard part.
+	for (i += 1, digs = 0; i < len && (c = val[i]); ++i, ++digs)
+	{
+		size_t rdx;
+
+		// Convert the character to a digit.
+		v = bc_num_parseChar(c, base);
+
+		// We keep growing result2 according to the base because the more digits
+		// after the radix, the more significant the digits close to the radix
+		// should be.
+		bc_num_mulArray(&result1, base, &result2);
+
+		// Convert the digit to a number.
+		bc_num_bigdig2num(&temp, v);
+
+		// Add the digit into the fraction part.
+		bc_num_add(&result2, &temp, &result1, 0);
+
+		// Keep growing m1 and m2 for use after the loop.
+		bc_num_mulArray(m1, base, m2);
+
+		rdx = BC_NUM_RDX_VAL(m2);
+
+		if (m2->len < rdx) m2->len = rdx;
+
+		// Switch.
+		ptr = m1;
+		m1 = m2;
+		m2 = ptr;
+	}
+
+	// This one cannot be a divide by 0 because mult starts out at 1, then is
+	// multiplied by base, and base cannot be 0, so mult cannot be 0. And this
+	// is the reason we keep growing m1 and m2; this division is what converts
+	// the parsed fractional part from an integer to a fractional part.
+	bc_num_div(&result1, m1, &result2, digs * 2);
+
+	// Pretruncate.
+	bc_num_truncate(&result2, digs);
+
+	// The final add of the integer part to the fractional part.
+	bc_num_add(n, &result2, n, digs);
+
+	// Basic cleanup.
+	if (BC_NUM_NONZERO(n))
+	{
+		if (n->scale < digs) bc_num_extend(n, digs - n->scale);
+	}
+	else bc_num_zero(n);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&result2);
+	bc_num_free(&result1);
+	bc_num_free(&mult2);
+int_err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&mult1);
+	bc_num_free(&temp);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Prints a backslash+newline combo if the number of characters needs it. This
+ * is really a convenience function.
+ */
+static inline void
+bc_num_printNewline(void)
+{
+#if !BC_ENABLE_LIBRARY
+	if (vm->nchars >= vm->line_len - 1 && vm->line_len)
+	{
+		bc_vm_putchar('\\', bc_flush_none);
+		bc_vm_putchar('\n', bc_flush_err);
+	}
+#endif // !BC_ENABLE_LIBRARY
+}
+
+/**
+ * Prints a character after a backslash+newline, if needed.
+ * @param c       The character to print.
+ * @param bslash  Whether to print a backslash+newline.
+ */
+static void
+bc_num_putchar(int c, bool bslash)
+{
+	if (c != '\n' && bslash) bc_num_printNewline();
+	bc_vm_putchar(c, bc_flush_save);
+}
+
+#if !BC_ENABLE_LIBRARY
+
+/**
+ * Prints a character for a number's digit. This is for printing for dc's P
+ * command. This function does not need to worry about radix points. This is a
+ * BcNumDigitOp.
+ * @param n       The "digit" to print.
+ * @param len     The "length" of the digit, or number of characters that will
+ *                need to be printed for the digit.
+ * @param rdx     True if a decimal (radix) point should be printed.
+ * @param bslash  True if a backslash+newline should be printed if the character
+ *                limit for the line is reached, false otherwise.
+ */
+static void
+bc_num_printChar(size_t n, size_t len, bool rdx, bool bslash)
+{
+	BC_UNUSED(rdx);
+	BC_UNUSED(len);
+	BC_UNUSED(bslash);
+	assert(len == 1);
+	bc_vm_putchar((uchar) n, bc_flush_save);
+}
+
+#endif // !BC_ENABLE_LIBRARY
+
+/**
+ * Prints a series of characters for large bases. This is for printing in bases
+ * above hexadecimal. This is a BcNumDigitOp.
+ * @param n       The "digit" to print.
+ * @param len     The "length" of the digit, or number of characters that will
+ *                need to be printed for the digit.
+ * @param rdx     True if a decimal (radix) point should be printed.
+ * @param bslash  True if a backslash+newline should be printed if the character
+ *                limit for the line is reached, false otherwise.
+ */
+static void
+bc_num_printDigits(size_t n, size_t len, bool rdx, bool bslash)
+{
+	size_t exp, pow;
+
+	// If needed, print the radix; otherwise, print a space to separate digits.
+	bc_num_putchar(rdx ? '.' : ' ', true);
+
+	// Calculate the exponent and power.
+	for (exp = 0, pow = 1; exp < len - 1; ++exp, pow *= BC_BASE)
+	{
+		continue;
+	}
+
+	// Print each character individually.
+	for (exp = 0; exp < len; pow /= BC_BASE, ++exp)
+	{
+		// The individual subdigit.
+		size_t dig = n / pow;
+
+		// Take the subdigit away.
+		n -= dig * pow;
+
+		// Print the subdigit.
+		bc_num_putchar(((uchar) dig) + '0', bslash || exp != len - 1);
+	}
+}
+
+/**
+ * Prints a character for a number's digit. This is for printing in bases for
+ * hexadecimal and below because they always print only one character at a time.
+ * This is a BcNumDigitOp.
+ * @param n       The "digit" to print.
+ * @param len     The "length" of the digit, or number of characters that will
+ *                need to be printed for the digit.
+ * @param rdx     True if a decimal (radix) point should be printed.
+ * @param bslash  True if a backslash+newline should be printed if the character
+ *                limit for the line is reached, false otherwise.
+ */
+static void
+bc_num_printHex(size_t n, size_t len, bool rdx, bool bslash)
+{
+	BC_UNUSED(len);
+	BC_UNUSED(bslash);
+
+	assert(len == 1);
+
+	if (rdx) bc_num_putchar('.', true);
+
+	bc_num_putchar(bc_num_hex_digits[n], bslash);
+}
+
+/**
+ * Prints a decimal number. This is specially written for optimization since
+ * this will be used the most and because bc's numbers are already in decimal.
+ * @param n        The number to print.
+ * @param newline  Whether to print backslash+newlines on long enough lines.
+ */
+static void
+bc_num_printDecimal(const BcNum* restrict n, bool newline)
+{
+	size_t i, j, rdx = BC_NUM_RDX_VAL(n);
+	bool zero = true;
+	size_t buffer[BC_BASE_DIGS];
+
+	// Print loop.
+	for (i = n->len - 1; i < n->len; --i)
+	{
+		BcDig n9 = n->num[i];
+		size_t temp;
+		bool irdx = (i == rdx - 1);
+
+		// Calculate the number of digits in the limb.
+		zero = (zero & !irdx);
+		temp = n->scale % BC_BASE_DIGS;
+		temp = i || !temp ? 0 : BC_BASE_DIGS - temp;
+
+		// NOLINTNEXTLINE
+		memset(buffer, 0, BC_BASE_DIGS * sizeof(size_t));
+
+		// Fill the buffer with individual digits.
+		for (j = 0; n9 && j < BC_BASE_DIGS; ++j)
+		{
+			buffer[j] = ((size_t) n9) % BC_BASE;
+			n9 /= BC_BASE;
+		}
+
+		// Print the digits in the buffer.
+		for (j = BC_BASE_DIGS - 1; j < BC_BASE_DIGS && j >= temp; --j)
+		{
+			// Figure out whether to print the decimal point.
+			bool print_rdx = (irdx & (j == BC_BASE_DIGS - 1));
+
+			// The zero variable helps us skip leading zero digits in the limb.
+			zero = (zero && buffer[j] == 0);
+
+			if (!zero)
+			{
+				// While the first three arguments should be self-explanatory,
+				// the last needs explaining. I don't want to print a newline
+				// when the last digit to be printed could take the place of the
+				// backslash rather than being pushed, as a single character, to
+				// the next line. That's what that last argument does for bc.
+				bc_num_printHex(buffer[j], 1, print_rdx,
+				                !newline || (j > temp || i != 0));
+			}
+		}
+	}
+}
+
+#if BC_ENABLE_EXTRA_MATH
+
+/**
+ * Prints a number in scientific or engineering format. When doing this, we are
+ * always printing in decimal.
+ * @param n        The number to print.
+ * @param eng      True if we are in engineering mode.
+ * @param newline  Whether to print backslash+newlines on long enough lines.
+ */
+static void
+bc_num_printExponent(const BcNum* restrict n, bool eng, bool newline)
+{
+	size_t places, mod, nrdx = BC_NUM_RDX_VAL(n);
+	bool neg = (n->len <= nrdx);
+	BcNum temp, exp;
+	BcDig digs[BC_NUM_BIGDIG_LOG10];
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	BC_SIG_LOCK;
+
+	bc_num_createCopy(&temp, n);
+
+	BC_SETJMP_LOCKED(vm, exit);
+
+	BC_SIG_UNLOCK;
+
+	// We need to calculate the exponents, and they change based on whether the
+	// number is all fractional or not, obviously.
+	if (neg)
+	{
+		// Figure out how many limbs after the decimal point is zero.
+		size_t i, idx = bc_num_nonZeroLen(n) - 1;
+
+		places = 1;
+
+		// Figure out how much in the last limb is zero.
+		for (i = BC_BASE_DIGS - 1; i < BC_BASE_DIGS; --i)
+		{
+			if (bc_num_pow10[i] > (BcBigDig) n->num[idx]) places += 1;
+			else break;
+		}
+
+		// Calculate the combination of zero limbs and zero digits in the last
+		// limb.
+		places += (nrdx - (idx + 1)) * BC_BASE_DIGS;
+		mod = places % 3;
+
+		// Calculate places if we are in engineering mode.
+		if (eng && mod != 0) places += 3 - mod;
+
+		// Shift the temp to the right place.
+		bc_num_shiftLeft(&temp, places);
+	}
+	else
+	{
+		// This is the number of digits that we are supposed to put behind the
+		// decimal point.
+		places = bc_num_intDigits(n) - 1;
+
+		// Calculate the true number based on whether engineering mode is
+		// activated.
+		mod = places % 3;
+		if (eng && mod != 0) places -= 3 - (3 - mod);
+
+		// Shift the temp to the right place.
+		bc_num_shiftRight(&temp, places);
+	}
+
+	// Print the shifted number.
+	bc_num_printDecimal(&temp, newline);
+
+	// Print the e.
+	bc_num_putchar('e', !newline);
+
+	// Need to explicitly print a zero exponent.
+	if (!places)
+	{
+		bc_num_printHex(0, 1, false, !newline);
+		goto exit;
+	}
+
+	// Need to print sign for the exponent.
+	if (neg) bc_num_putchar('-', true);
+
+	// Create a temporary for the exponent...
+	bc_num_setup(&exp, digs, BC_NUM_BIGDIG_LOG10);
+	bc_num_bigdig2num(&exp, (BcBigDig) places);
+
+	/// ..and print it.
+	bc_num_printDecimal(&exp, newline);
+
+exit:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&temp);
+	BC_LONGJMP_CONT(vm);
+}
+#endif // BC_ENABLE_EXTRA_MATH
+
+/**
+ * Takes a number with limbs with base BC_BASE_POW and converts the limb at the
+ * given index to base @a pow, where @a pow is obase^N.
+ * @param n    The number to convert.
+ * @param rem  BC_BASE_POW - @a pow.
+ * @param pow  The power of obase we will convert the number to.
+ * @param idx  The index of the number to start converting at. Doing the
+ *             conversion is O(n^2); we have to sweep through starting at the
+ *             least significant limb.
+ */
+static void
+bc_num_printFixup(BcNum* restrict n, BcBigDig rem, BcBigDig pow, size_t idx)
+{
+	size_t i, len = n->len - idx;
+	BcBigDig acc;
+	BcDig* a = n->num + idx;
+
+	// Ignore if there's just one limb left. This is the part that requires the
+	// extra loop after the one calling this function in bc_num_printPrepare().
+	if (len < 2) return;
+
+	// Loop through the remaining limbs and convert. We start at the second limb
+	// because we pull the value from the previous one as well.
+	for (i = len - 1; i > 0; --i)
+	{
+		// Get the limb and add it to the previous, along with multiplying by
+		// the remainder because that's the proper overflow. "acc" means
+		// "accumulator," by the way.
+		acc = ((BcBigDig) a[i]) * rem + ((BcBigDig) a[i - 1]);
+
+		// Store a value in base pow in the previous limb.
+		a[i - 1] = (BcDig) (acc % pow);
+
+		// Divide by the base and accumulate the remaining value in the limb.
+		acc /= pow;
+		acc += (BcBigDig) a[i];
+
+		// If the accumulator is greater than the base...
+		if (acc >= BC_BASE_POW)
+		{
+			// Do we need to grow?
+			if (i == len - 1)
+			{
+				// Grow.
+				len = bc_vm_growSize(len, 1);
+				bc_num_expand(n, bc_vm_growSize(len, idx));
+
+				// Update the pointer because it may have moved.
+				a = n->num + idx;
+
+				// Zero out the last limb.
+				a[len - 1] = 0;
+			}
+
+			// Overflow into the next limb since we are over the base.
+			a[i + 1] += acc / BC_BASE_POW;
+			acc %= BC_BASE_POW;
+		}
+
+		assert(acc < BC_BASE_POW);
+
+		// Set the limb.
+		a[i] = (BcDig) acc;
+	}
+
+	// We may have grown the number, so adjust the length.
+	n->len = len + idx;
+}
+
+/**
+ * Prepares a number for printing in a base that does not have BC_BASE_POW as a
+ * power. This basically converts the number from having limbs of base
+ * BC_BASE_POW to limbs of pow, where pow is obase^N.
+ * @param n    The number to prepare for printing.
+ * @param rem  The remainder of BC_BASE_POW when divided by a power of the base.
+ * @param pow  The power of the base.
+ */
+static void
+bc_num_printPrepare(BcNum* restrict n, BcBigDig rem, BcBigDig pow)
+{
+	size_t i;
+
+	// Loop from the least significant limb to the most significant limb and
+	// convert limbs in each pass.
+	for (i = 0; i < n->len; ++i)
+	{
+		bc_num_printFixup(n, rem, pow, i);
+	}
+
+	// bc_num_printFixup() does not do everything it is supposed to, so we do
+	// the last bit of cleanup here. That cleanup is to ensure that each limb
+	// is less than pow and to expand the number to fit new limbs as necessary.
+	for (i = 0; i < n->len; ++i)
+	{
+		assert(pow == ((BcBigDig) ((BcDig) pow)));
+
+		// If the limb needs fixing...
+		if (n->num[i] >= (BcDig) pow)
+		{
+			// Do we need to grow?
+			if (i + 1 == n->len)
+			{
+				// Grow the number.
+				n->len = bc_vm_growSize(n->len, 1);
+				bc_num_expand(n, n->len);
+
+				// Without this, we might use uninitialized data.
+				n->num[i + 1] = 0;
+			}
+
+			assert(pow < BC_BASE_POW);
+
+			// Overflow into the next limb.
+			n->num[i + 1] += n->num[i] / ((BcDig) pow);
+			n->num[i] %= (BcDig) pow;
+		}
+	}
+}
+
+/**
+ * Prints the digits of the integer part of a number that has already been
+ * converted to limbs of vm->last_pow by bc_num_printPrepare(), or that did not
+ * need it. The digits are put on a stack, which allows us to reverse them for
+ * printing.
+ * @param n       The converted number.
+ * @param base    The base to print in.
+ * @param pad     The number of digits to pad the output to with leading
+ *                zeroes. If this is 0, no leading zeroes are printed.
+ * @param len     The length of each digit, for bc_num_printDigits().
+ * @param print   The function to print digits with.
+ * @param bslash  What to tell @a print about a backslash for the last digit.
+ * @param stack   The stack to use. It must be empty.
+ */
+static void
+bc_num_printLimbs(const BcNum* restrict n, BcBigDig base, size_t pad,
+                  size_t len, BcNumDigitOp print, bool bslash,
+                  BcVec* restrict stack)
+{
+	BcBigDig dig = 0, acc, exp;
+	BcBigDig* ptr;
+	BcNumRecip r;
+	size_t i, j, total;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	exp = vm->last_exp;
+
+	bc_num_recipInit(&r, base);
+
+	// Fill the stack of digits for the integer part.
+	for (i = 0; i < n->len; ++i)
+	{
+		// Get the limb.
+		acc = (BcBigDig) n->num[i];
+
+		// Turn the limb into digits of base obase.
+		for (j = 0; j < exp && (i < n->len - 1 || acc != 0); ++j)
+		{
+			// This condition is true if we are not at the last digit.
+			if (j != exp - 1)
+			{
+				acc = bc_num_recipDiv(&r, acc, &dig);
+			}
+			else
+			{
+				dig = acc;
+				acc = 0;
+			}
+
+			assert(dig < base);
+
+			// Push the digit onto the stack.
+			bc_vec_push(stack, &dig);
+		}
+
+		assert(acc == 0);
+	}
+
+	assert(!pad || stack->len <= pad);
+
+	total = BC_MAX(pad, stack->len);
+
+	// Go through the stack backwards and print each digit, after the padding.
+	// The backslash argument is true for all but the last digit because there
+	// will be at least one more character after it.
+	for (i = 0; i < total; ++i)
+	{
+		if (i < total - stack->len) dig = 0;
+		else
+		{
+			ptr = bc_vec_item_rev(stack, i - (total - stack->len));
+			assert(ptr != NULL);
+			dig = *ptr;
+		}
+
+		print(dig, len, false, bslash || i < total - 1);
+	}
+
+	bc_vec_popAll(stack);
+}
+
+/**
+ * Prints the non-negative integer @a n in the base @a base, which must be a
+ * power of 2. @a n is converted to binary once, and then every digit is just a
+ * few bits of it.
+ * @param n       The integer to print.
+ * @param base    The base to print in.
+ * @param len     The length of each digit, for bc_num_printDigits().
+ * @param print   The function to print digits with.
+ * @param bslash  What to tell @a print about a backslash for the last digit.
+ */
+static void
+bc_num_printBin(BcNum* restrict n, BcBigDig base, size_t len,
+                BcNumDigitOp print, bool bslash)
+{
+	uint32_t* w;
+	size_t i, k, bits, ndigs;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (BC_NUM_ZERO(n)) return;
+
+	k = bc_num_log2(base);
+
+	BC_SIG_LOCK;
+
+	// One more word than needed, so that digits can always read two words.
+	w = bc_vm_malloc(bc_vm_arraySize(bc_vm_growSize(n->len, 1),
+	                                 sizeof(uint32_t)));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bits = bc_num_toBinBits(n, w);
+	w[n->len] = 0;
+
+	ndigs = (bits + k - 1) / k;
+
+	// Print the digits from the top.
+	for (i = ndigs - 1; i < ndigs; --i)
+	{
+		size_t bit = i * k, idx = bit / BC_NUM_BIN_BITS;
+		uint64_t v = w[idx] | (((uint64_t) w[idx + 1]) << BC_NUM_BIN_BITS);
+		BcBigDig dig = (BcBigDig) ((v >> (bit % BC_NUM_BIN_BITS)) & (base - 1));
+
+		print(dig, len, false, bslash || i);
+	}
+
+err:
+	BC_SIG_MAYLOCK;
+	free(w);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Prints the non-negative integer @a n with divide and conquer: @a n is split
+ * into high and low halves with a cached power of the base, and those are
+ * printed recursively, high first, so digits are printed as soon as they are
+ * found instead of after the whole conversion. Together with a fast division,
+ * that takes near multiplication time, instead of the quadratic time of
+ * bc_num_printPrepare() on the whole number, which is only used on small
+ * pieces.
+ * @param n       The integer to print. It must be less than the square of the
+ *                cached power of the base at index @a level - 1.
+ * @param level   One more than the index of the cached power of the base that
+ *                @a n is split with. If it is 0, @a n is not split.
+ * @param pad     The number of digits to pad the output to with leading
+ *                zeroes. If this is 0, no leading zeroes are printed.
+ * @param base    The base to print in.
+ * @param len     The length of each digit, for bc_num_printDigits().
+ * @param print   The function to print digits with.
+ * @param bslash  What to tell @a print about a backslash for the last digit.
+ * @param stack   The stack to use for bc_num_printLimbs(). It must be empty.
+ */
+static void
+bc_num_printTree(BcNum* restrict n, size_t level, size_t pad, BcBigDig base,
+                 size_t len, BcNumDigitOp print, bool bslash,
+                 BcVec* restrict stack)
+{
+	BcNum q, r;
+	size_t digs;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// Without padding, the first half cannot be zero, or the zeroes from the
+	// second half would be printed as leading zeroes.
+	while (!pad && level && bc_num_cmp(n, bc_vec_item(&vm->pows, level - 1)) < 0)
+	{
+		level -= 1;
+	}
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&r, n->len);
+
+	BC_SETJMP_LOCKED(vm, r_err);
+
+	if (!level || n->len < BC_NUM_RADIX_LEN)
+	{
+		BC_SIG_UNLOCK;
+
+		bc_num_copy(&r, n);
+
+		if (vm->last_rem != 0)
+		{
+			bc_num_printPrepare(&r, vm->last_rem, vm->last_pow);
+		}
+
+		bc_num_printLimbs(&r, base, pad, len, print, bslash, stack);
+
+		goto r_err;
+	}
+
+	bc_num_init(&q, n->len);
+
+	BC_UNSETJMP(vm);
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// The number of digits in the low half.
+	digs = vm->last_exp << (level - 1);
+
+	bc_num_divInt(n, bc_vec_item(&vm->pows, level - 1), &q, &r);
+
+	bc_num_printTree(&q, level - 1, pad > digs ? pad - digs : 0, base, len,
+	                 print, true, stack);
+	bc_num_printTree(&r, level - 1, digs, base, len, print, bslash, stack);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&q);
+r_err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&r);
+	BC_LONGJMP_CONT(vm);
+}
+
+static void
+bc_num_printNum(BcNum* restrict n, BcBigDig base, size_t len,
+                BcNumDigitOp print, bool newline)
+{
+	BcVec stack;
+	BcNum intp, fracp1, fracp2, digit, flen1, flen2;
+	BcNum* n1;
+	BcNum* n2;
+	BcNum* temp;
+	BcBigDig dig;
+	size_t level, nrdx, idigits;
+	bool radix;
+	BcDig digit_digs[BC_NUM_BIGDIG_LOG10 + 1];
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(base > 1);
+
+	// Easy case. Even with scale, we just print this.
+	if (BC_NUM_ZERO(n))
+	{
+		print(0, len, false, !newline);
+		return;
+	}
+
+	// This function uses an algorithm that Stefan Esser <se@freebsd.org> came
+	// up with to print the integer part of a number. What it does is convert
+	// intp into a number of the specified base, but it does it directly,
+	// instead of just doing a series of divisions and printing the remainders
+	// in reverse order.
+	//
+	// Let me explain in a bit more detail:
+	//
+	// The algorithm takes the current least significant limb (after intp has
+	// been converted to an integer) and the next to least significant limb, and
+	// it converts the least significant limb into one of the specified base,
+	// putting any overflow into the next to least significant limb. It iterates
+	// through the whole number, from least significant to most significant,
+	// doing this conversion. At the end of that iteration, the least
+	// significant limb is converted, but the others are not, so it iterates
+	// again, starting at the next to least significant limb. It keeps doing
+	// that conversion, skipping one more limb than the last time, until all
+	// limbs have been converted. Then it prints them in reverse order.
+	//
+	// That is the gist of the algorithm. It leaves out several things, such as
+	// the fact that limbs are not always converted into the specified base, but
+	// into something close, basically a power of the specified base. In
+	// Stefan's words, "You could consider BcDigs to be of base 10^BC_BASE_DIGS
+	// in the normal case and obase^N for the largest value of N that satisfies
+	// obase^N <= 10^BC_BASE_DIGS. [This means that] the result is not in base
+	// "obase", but in base "obase^N", which happens to be printable as a number
+	// of base "obase" without consideration for neighbouring BcDigs." This fact
+	// is what necessitates the existence of the loop later in this function.
+	//
+	// The conversion happens in bc_num_printPrepare() where the outer loop
+	// happens and bc_num_printFixup() where the inner loop, or actual
+	// conversion, happens. In other words, bc_num_printPrepare() is where the
+	// loop that starts at the least significant limb and goes to the most
+	// significant limb. Then, on every iteration of its loop, it calls
+	// bc_num_printFixup(), which has the inner loop of actually converting
+	// the limbs it passes into limbs of base obase^N rather than base
+	// BC_BASE_POW.
+
+	nrdx = BC_NUM_RDX_VAL(n);
+
+	BC_SIG_LOCK;
+
+	// The stack is what allows us to reverse the digits for printing.
+	bc_vec_init(&stack, sizeof(BcBigDig), BC_DTOR_NONE);
+	bc_num_init(&fracp1, nrdx);
+
+	// intp will be the "integer part" of the number, so copy it.
+	bc_num_createCopy(&intp, n);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// Make intp an integer.
+	bc_num_truncate(&intp, intp.scale);
+
+	// Get the fractional part out.
+	bc_num_sub(n, &intp, &fracp1, 0);
+
+	bc_num_setBase(base);
+
+	// If vm->last_rem is 0, then the base we are printing in is a divisor of
+	// BC_BASE_POW, which is the easy case because it means that BC_BASE_POW is
+	// a power of obase, and no conversion is needed. If it *is* 0, then we have
+	// the hard case, and we have to prepare the number for the base. If it is
+	// big, we use divide and conquer. And if the base is a power of 2, the
+	// digits are sliced out of binary.
+	if (BC_NUM_BASE_POW2(base))
+	{
+		bc_num_printBin(&intp, base, len, print, !newline || n->scale != 0);
+	}
+	else if (vm->last_rem != 0 && intp.len >= BC_NUM_RADIX_LEN)
+	{
+		// Find the first cached power that, squared, is above intp. That
+		// takes one squaring less than finding the first power above intp.
+		for (level = 0; 2 * bc_num_basePow(level)->len - 2 < intp.len; ++level)
+		{
+			continue;
+		}
+
+		bc_num_printTree(&intp, level + 1, 0, base, len, print,
+		                 !newline || n->scale != 0, &stack);
+	}
+	else
+	{
+		if (vm->last_rem != 0)
+		{
+			bc_num_printPrepare(&intp, vm->last_rem, vm->last_pow);
+		}
+
+		// While the first three arguments to print() should be
+		// self-explanatory, the last needs explaining. I don't want to print a
+		// backslash+newline when the last digit to be printed could take the
+		// place of the backslash rather than being pushed, as a single
+		// character, to the next line. That's what that last argument does for
+		// bc.
+		//
+		// First, it needs to check if newlines are completely disabled. If they
+		// are not disabled, it needs to check the next part.
+		//
+		// If the number has a scale, then because we are printing just the
+		// integer part, there will be at least two more characters (a radix
+		// point plus at least one digit). So if there is a scale, a backslash
+		// is necessary.
+		//
+		// Otherwise, the last digit does not need a backslash.
+		//
+		// The function that prints bases 17 and above will take care of not
+		// printing a backslash in the right case.
+		bc_num_printLimbs(&intp, base, 0, len, print,
+		                  !newline || n->scale != 0, &stack);
+	}
+
+	// We are done if there is no fractional part.
+	if (!n->scale) goto err;
+
+	BC_SIG_LOCK;
+
+	// Reset the jump because some locals are changing.
+	BC_UNSETJMP(vm);
+
+	bc_num_init(&fracp2, nrdx);
+	bc_num_setup(&digit, digit_digs, sizeof(digit_digs) / sizeof(BcDig));
+	bc_num_init(&flen1, BC_NUM_BIGDIG_LOG10);
+	bc_num_init(&flen2, BC_NUM_BIGDIG_LOG10);
+
+	BC_SETJMP_LOCKED(vm, frac_err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&flen1);
+
+	radix = true;
+
+	// Pointers for easy switching.
+	n1 = &flen1;
+	n2 = &flen2;
+
+	fracp2.scale = n->scale;
+	BC_NUM_RDX_SET_NP(fracp2, BC_NUM_RDX(fracp2.scale));
+
+	// As long as we have not reached the scale of the number, keep printing.
+	while ((idigits = bc_num_intDigits(n1)) <= n->scale)
+	{
+		// These numbers will keep growing.
+		bc_num_expand(&fracp2, fracp1.len + 1);
+		bc_num_mulArray(&fracp1, base, &fracp2);
+
+		nrdx = BC_NUM_RDX_VAL_NP(fracp2);
+
+		// Ensure an invariant.
+		if (fracp2.len < nrdx) fracp2.len = nrdx;
+
+		// fracp is guaranteed to be non-negative and small enough.
+		dig = bc_num_bigdig2(&fracp2);
+
+		// Convert the digit to a number and subtract it from the number.
+		bc_num_bigdig2num(&digit, dig);
+		bc_num_sub(&fracp2, &digit, &fracp1, 0);
+
+		// While the first three arguments should be self-explanatory, the last
+		// needs explaining. I don't want to print a newline when the last digit
+		// to be printed could take the place of the backslash rather than being
+		// pushed, as a single character, to the next line. That's what that
+		// last argument does for bc.
+		print(dig, len, radix, !newline || idigits != n->scale);
+
+		// Update the multipliers.
+		bc_num_mulArray(n1, base, n2);
+
+		radix = false;
+
+		// Switch.
+		temp = n1;
+		n1 = n2;
+		n2 = temp;
+	}
+
+frac_err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&flen2);
+	bc_num_free(&flen1);
+	bc_num_free(&fracp2);
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&fracp1);
+	bc_num_free(&intp);
+	bc_vec_free(&stack);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Prints a number in the specified base, or rather, figures out which function
+ * to call to print the number in the specified base and calls it.
+ * @param n        The number to print.
+ * @param base     The base to print in.
+ * @param newline  Whether to print backslash+newlines on long enough lines.
+ */
+static void
+bc_num_printBase(BcNum* restrict n, BcBigDig base, bool newline)
+{
+	size_t width;
+	BcNumDigitOp print;
+	bool neg = BC_NUM_NEG(n);
+
+	// Clear the sign because it makes the actual printing easier when we have
+	// to do math.
+	BC_NUM_NEG_CLR(n);
+
+	// Bases at hexadecimal and below are printed as one character, larger bases
+	// are printed as a series of digits separated by spaces.
+	if (base <= BC_NUM_MAX_POSIX_IBASE)
+	{
+		width = 1;
+		print = bc_num_printHex;
+	}
+	else
+	{
+		assert(base <= BC_BASE_POW);
+		width = bc_num_log10(base - 1);
+		print = bc_num_printDigits;
+	}
+
+	// Print.
+	bc_num_printNum(n, base, width, print, newline);
+
+	// Reset the sign.
+	n->rdx = BC_NUM_NEG_VAL(n, neg);
+}
+
+#if !BC_ENABLE_LIBRARY
+
+void
+bc_num_stream(BcNum* restrict n)
+{
+	bc_num_printNum(n, BC_NUM_STREAM_BASE, 1, bc_num_printChar, false);
+}
+
+#endif // !BC_ENABLE_LIBRARY
+
+void
+bc_num_setup(BcNum* restrict n, BcDig* restrict num, size_t cap)
+{
+	assert(n != NULL);
+	n->num = num;
+	n->cap = cap;
+	bc_num_zero(n);
+}
+
+void
+bc_num_init(BcNum* restrict n, size_t req)
+{
+	BcDig* num;
+
+	BC_SIG_ASSERT_LOCKED;
+
+	assert(n != NULL);
+
+	// BC_NUM_DEF_SIZE is set to be about the smallest allocation size that
+	// malloc() returns in practice, so just use it.
+	req = req >= BC_NUM_DEF_SIZE ? req : BC_NUM_DEF_SIZE;
+
+	// If we can't use a temp, allocate.
+	if (req != BC_NUM_DEF_SIZE) num = bc_vm_malloc(BC_NUM_SIZE(req));
+	else
+	{
+		num = bc_vm_getTemp() == NULL ? bc_vm_malloc(BC_NUM_SIZE(req)) :
+		                                bc_vm_takeTemp();
+	}
+
+	bc_num_setup(n, num, req);
+}
+
+void
+bc_num_clear(BcNum* restrict n)
+{
+	n->num = NULL;
+	n->cap = 0;
+}
+
+void
+bc_num_free(void* num)
+{
+	BcNum* n = (BcNum*) num;
+
+	BC_SIG_ASSERT_LOCKED;
+
+	assert(n != NULL);
+
+	if (n->cap == BC_NUM_DEF_SIZE) bc_vm_addTemp(n->num);
+	else free(n->num);
+}
+
+void
+bc_num_copy(BcNum* d, const BcNum* s)
+{
+	assert(d != NULL && s != NULL);
+
+	if (d == s) return;
+
+	bc_num_expand(d, s->len);
+	d->len = s->len;
+
+	// I can just copy directly here because the sign *and* rdx will be
+	// properly preserved.
+	d->rdx = s->rdx;
+	d->scale = s->scale;
+	// NOLINTNEXTLINE
+	memcpy(d->num, s->num, BC_NUM_SIZE(d->len));
+}
+
+void
+bc_num_createCopy(BcNum* d, const BcNum* s)
+{
+	BC_SIG_ASSERT_LOCKED;
+	bc_num_init(d, s->len);
+	bc_num_copy(d, s);
+}
+
+void
+bc_num_createFromBigdig(BcNum* restrict n, BcBigDig val)
+{
+	BC_SIG_ASSERT_LOCKED;
+	bc_num_init(n, BC_NUM_BIGDIG_LOG10);
+	bc_num_bigdig2num(n, val);
+}
+
+size_t
+bc_num_scale(const BcNum* restrict n)
+{
+	return n->scale;
+}
+
+size_t
+bc_num_len(const BcNum* restrict n)
+{
+	size_t len = n->len;
+
+	// Always return at least 1.
+	if (BC_NUM_ZERO(n)) return n->scale ? n->scale : 1;
+
+	// If this is true, there is no integer portion of the number.
+	if (BC_NUM_RDX_VAL(n) == len)
+	{
+		// We have to take into account the fact that some of the digits right
+		// after the decimal could be zero. If that is the case, we need to
+		// ignore them until we hit the first non-zero digit.
+
+		size_t zero, scale;
+
+		// The number of limbs with non-zero digits.
+		len = bc_num_nonZeroLen(n);
+
+		// Get the number of digits in the last limb.
+		scale = n->scale % BC_BASE_DIGS;
+		scale = scale ? scale : BC_BASE_DIGS;
+
+		// Get the number of zero digits.
+		zero = bc_num_zeroDigits(n->num + len - 1);
+
+		// Calculate the true length.
+		len = len * BC_BASE_DIGS - zero - (BC_BASE_DIGS - scale);
+	}
+	// Otherwise, count the number of int digits and return that plus the scale.
+	else len = bc_num_intDigits(n) + n->scale;
+
+	return len;
+}
+
+void
+bc_num_parse(BcNum* restrict n, const char* restrict val, BcBigDig base)
+{
+#if BC_DEBUG
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+#endif // BC_DEBUG
+
+	assert(n != NULL && val != NULL && base);
+	assert(base >= BC_NUM_MIN_BASE && base <= vm->maxes[BC_PROG_GLOBALS_IBASE]);
+	assert(bc_num_strValid(val));
+
+	// A one character number is *always* parsed as though the base was the
+	// maximum allowed ibase, per the bc spec.
+	if (!val[1])
+	{
+		BcBigDig dig = bc_num_parseChar(val[0], BC_NUM_MAX_LBASE);
+		bc_num_bigdig2num(n, dig);
+	}
+	else if (base == BC_BASE) bc_num_parseDecimal(n, val);
+	else bc_num_parseBase(n, val, base);
+
+	assert(BC_NUM_RDX_VALID(n));
+}
+
+void
+bc_num_print(BcNum* restrict n, BcBigDig base, bool newline)
+{
+	assert(n != NULL);
+	assert(BC_ENABLE_EXTRA_MATH || base >= BC_NUM_MIN_BASE);
+
+	// We may need a newline, just to start.
+	bc_num_printNewline();
+
+	if (BC_NUM_NONZERO(n))
+	{
+#if BC_ENABLE_LIBRARY
+		BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+		// Print the sign.
+		if (BC_NUM_NEG(n)) bc_num_putchar('-', true);
+
+		// Print the leading zero if necessary. We don't print when using
+		// scientific or engineering modes.
+		if (BC_Z && BC_NUM_RDX_VAL(n) == n->len && base != 0 && base != 1)
+		{
+			bc_num_printHex(0, 1, false, !newline);
+		}
+	}
+
+	// Short-circuit 0.
+	if (BC_NUM_ZERO(n)) bc_num_printHex(0, 1, false, !newline);
+	else if (base == BC_BASE) bc_num_printDecimal(n, newline);
+#if BC_ENABLE_EXTRA_MATH
+	else if (base == 0 || base == 1)
+	{
+		bc_num_printExponent(n, base != 0, newline);
+	}
+#endif // BC_ENABLE_EXTRA_MATH
+	else bc_num_printBase(n, base, newline);
+
+	if (newline) bc_num_putchar('\n', false);
+}
+
+BcBigDig
+bc_num_bigdig2(const BcNum* restrict n)
+{
+#if BC_DEBUG
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+#endif // BC_DEBUG
+
+	// This function returns no errors because it's guaranteed to succeed if
+	// its preconditions are met. Those preconditions include both n needs to
+	// be non-NULL, n being non-negative, and n being less than vm->max. If all
+	// of that is true, then we can just convert without worrying about negative
+	// errors or overflow.
+
+	BcBigDig r = 0;
+	size_t nrdx = BC_NUM_RDX_VAL(n);
+
+	assert(n != NULL);
+	assert(!BC_NUM_NEG(n));
+	assert(bc_num_cmp(n, &vm->max) < 0);
+	assert(n->len - nrdx <= 3);
+
+	// There is a small speed win from unrolling the loop here, and since it
+	// only adds 53 bytes, I decided that it was worth it.
+	switch (n->len - nrdx)
+	{
+		case 3:
+		{
+			r = (BcBigDig) n->num[nrdx + 2];
+
+			// Fallthrough.
+			BC_FALLTHROUGH
+		}
+
+		case 2:
+		{
+			r = r * BC_BASE_POW + (BcBigDig) n->num[nrdx + 1];
+
+			// Fallthrough.
+			BC_FALLTHROUGH
+		}
+
+		case 1:
+		{
+			r = r * BC_BASE_POW + (BcBigDig) n->num[nrdx];
+		}
+	}
+
+	return r;
+}
+
+BcBigDig
+bc_num_bigdig(const BcNum* restrict n)
+{
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(n != NULL);
+
+	// This error checking is extremely important, and if you do not have a
+	// guarantee that converting a number will always succeed in a particular
+	// case, you *must* call this function to get these error checks. This
+	// includes all instances of numbers inputted by the user or calculated by
+	// the user. Otherwise, you can call the faster bc_num_bigdig2().
+	if (BC_ERR(BC_NUM_NEG(n))) bc_err(BC_ERR_MATH_NEGATIVE);
+	if (BC_ERR(bc_num_cmp(n, &vm->max) >= 0)) bc_err(BC_ERR_MATH_OVERFLOW);
+
+	return bc_num_bigdig2(n);
+}
+
+void
+bc_num_bigdig2num(BcNum* restrict n, BcBigDig val)
+{
+	BcDig* ptr;
+	size_t i;
+
+	assert(n != NULL);
+
+	bc_num_zero(n);
+
+	// Already 0.
+	if (!val) return;
+
+	// Expand first. This is the only way this function can fail, and it's a
+	// fatal error.
+	bc_num_expand(n, BC_NUM_BIGDIG_LOG10);
+
+	// The conversion is easy because numbers are laid out in little-endian
+	// order.
+	for (ptr = n->num, i = 0; val; ++i, val /= BC_BASE_POW)
+	{
+		ptr[i] = val % BC_BASE_POW;
+	}
+
+	n->len = i;
+}
+
+#if BC_ENABLE_EXTRA_MATH
+
+void
+bc_num_rng(const BcNum* restrict n, BcRNG* rng)
+{
+	BcNum temp, temp2, intn, frac;
+	BcRand state1, state2, inc1, inc2;
+	size_t nrdx = BC_NUM_RDX_VAL(n);
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// This function holds the secret of how I interpret a seed number for the
+	// PRNG. Well, it's actually in the development manual
+	// (manuals/development.md#pseudo-random-number-generator), so look there
+	// before you try to understand this.
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&temp, n->len);
+	bc_num_init(&temp2, n->len);
+	bc_num_init(&frac, nrdx);
+	bc_num_init(&intn, bc_num_int(n));
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	assert(BC_NUM_RDX_VALID_NP(vm->max));
+
+	// NOLINTNEXTLINE
+	memcpy(frac.num, n->num, BC_NUM_SIZE(nrdx));
+	frac.len = nrdx;
+	BC_NUM_RDX_SET_NP(frac, nrdx);
+	frac.scale = n->scale;
+
+	assert(BC_NUM_RDX_VALID_NP(frac));
+	assert(BC_NUM_RDX_VALID_NP(vm->max2));
+
+	// Multiply the fraction and truncate so that it's an integer. The
+	// truncation is what clamps it, by the way.
+	bc_num_mul(&frac, &vm->max2, &temp, 0);
+	bc_num_truncate(&temp, temp.scale);
+	bc_num_copy(&frac, &temp);
+
+	// Get the integer.
+	// NOLINTNEXTLINE
+	memcpy(intn.num, n->num + nrdx, BC_NUM_SIZE(bc_num_int(n)));
+	intn.len = bc_num_int(n);
+
+	// This assert is here because it has to be true. It is also here to justify
+	// some optimizations.
+	assert(BC_NUM_NONZERO(&vm->max));
+
+	// If there *was* a fractional part...
+	if (BC_NUM_NONZERO(&frac))
+	{
+		// This divmod splits frac into the two state parts.
+		bc_num_divmod(&frac, &vm->max, &temp, &temp2, 0);
+
+		// frac is guaranteed to be smaller than vm->max * vm->max (pow).
+		// This means that when dividing frac by vm->max, as above, the
+		// quotient and remainder are both guaranteed to be less than vm->max,
+		// which means we can use bc_num_bigdig2() here and not worry about
+		// overflow.
+		state1 = (BcRand) bc_num_bigdig2(&temp2);
+		state2 = (BcRand) bc_num_bigdig2(&temp);
+	}
+	else state1 = state2 = 0;
+
+	// If there *was* an integer part...
+	if (BC_NUM_NONZERO(&intn))
+	{
+		// This divmod splits intn into the two inc parts.
+		bc_num_divmod(&intn, &vm->max, &temp, &temp2, 0);
+
+		// Because temp2 is the mod of vm->max, from above, it is guaranteed
+		// to be small enough to use bc_num_bigdig2().
+		inc1 = (BcRand) bc_num_bigdig2(&temp2);
+
+		// Clamp the second inc part.
+		if (bc_num_cmp(&temp, &vm->max) >= 0)
+		{
+			bc_num_copy(&temp2, &temp);
+			bc_num_mod(&temp2, &vm->max, &temp, 0);
+		}
+
+		// The if statement above ensures that temp is less than vm->max, which
+		// means that we can use bc_num_bigdig2() here.
+		inc2 = (BcRand) bc_num_bigdig2(&temp);
+	}
+	else inc1 = inc2 = 0;
+
+	bc_rand_seed(rng, state1, state2, inc1, inc2);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&intn);
+	bc_num_free(&frac);
+	bc_num_free(&temp2);
+	bc_num_free(&temp);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_createFromRNG(BcNum* restrict n, BcRNG* rng)
+{
+	BcRand s1, s2, i1, i2;
+	BcNum conv, temp1, temp2, temp3;
+	BcDig temp1_num[BC_RAND_NUM_SIZE], temp2_num[BC_RAND_NUM_SIZE];
+	BcDig conv_num[BC_NUM_BIGDIG_LOG10];
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&temp3, 2 * BC_RAND_NUM_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_setup(&temp1, temp1_num, sizeof(temp1_num) / sizeof(BcDig));
+	bc_num_setup(&temp2, temp2_num, sizeof(temp2_num) / sizeof(BcDig));
+	bc_num_setup(&conv, conv_num, sizeof(conv_num) / sizeof(BcDig));
+
+	// This assert is here because it has to be true. It is also here to justify
+	// the assumption that vm->max is not zero.
+	assert(BC_NUM_NONZERO(&vm->max));
+
+	// Because this is true, we can just ignore math errors that would happen
+	// otherwise.
+	assert(BC_NUM_NONZERO(&vm->max2));
+
+	bc_rand_getRands(rng, &s1, &s2, &i1, &i2);
+
+	// Put the second piece of state into a number.
+	bc_num_bigdig2num(&conv, (BcBigDig) s2);
+
+	assert(BC_NUM_RDX_VALID_NP(conv));
+
+	// Multiply by max to make room for the first piece of state.
+	bc_num_mul(&conv, &vm->max, &temp1, 0);
+
+	// Add in the first piece of state.
+	bc_num_bigdig2num(&conv, (BcBigDig) s1);
+	bc_num_add(&conv, &temp1, &temp2, 0);
+
+	// Divide to make it an entirely fractional part.
+	bc_num_div(&temp2, &vm->max2, &temp3, BC_RAND_STATE_BITS);
+
+	// Now start on the increment parts. It's the same process without the
+	// divide, so put the second piece of increment into a number.
+	bc_num_bigdig2num(&conv, (BcBigDig) i2);
+
+	assert(BC_NUM_RDX_VALID_NP(conv));
+
+	// Multiply by max to make room for the first piece of increment.
+	bc_num_mul(&conv, &vm->max, &temp1, 0);
+
+	// Add in the first piece of increment.
+	bc_num_bigdig2num(&conv, (BcBigDig) i1);
+	bc_num_add(&conv, &temp1, &temp2, 0);
+
+	// Now add the two together.
+	bc_num_add(&temp2, &temp3, n, 0);
+
+	assert(BC_NUM_RDX_VALID(n));
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&temp3);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_irand(BcNum* restrict a, BcNum* restrict b, BcRNG* restrict rng)
+{
+	BcNum atemp;
+	size_t i;
+
+	assert(a != b);
+
+	if (BC_ERR(BC_NUM_NEG(a))) bc_err(BC_ERR_MATH_NEGATIVE);
+
+	// If either of these are true, then the numbers are integers.
+	if (BC_NUM_ZERO(a) || BC_NUM_ONE(a)) return;
+
+#if BC_GCC
+	// This is here in GCC to quiet the "maybe-uninitialized" warning.
+	atemp.num = NULL;
+	atemp.len = 0;
+#endif // BC_GCC
+
+	if (BC_ERR(bc_num_nonInt(a, &atemp))) bc_err(BC_ERR_MATH_NON_INTEGER);
+
+	assert(atemp.num != NULL);
+	assert(atemp.len);
+
+	if (atemp.len > 2)
+	{
+		size_t len;
+
+		len = atemp.len - 2;
+
+		// Just generate a random number for each limb.
+		for (i = 0; i < len; i += 2)
+		{
+			BcRand dig;
+
+			dig = bc_rand_bounded(rng, BC_BASE_RAND_POW);
+
+			b->num[i] = (BcDig) (dig % BC_BASE_POW);
+			b->num[i + 1] = (BcDig) (dig / BC_BASE_POW);
+		}
+	}
+	else
+	{
+		// We need this set.
+		i = 0;
+	}
+
+	// This will be true if there's one full limb after the two limb groups.
+	if (i == atemp.len - 2)
+	{
+		// Increment this for easy use.
+		i += 1;
+
+		// If the last digit is not one, we need to set a bound for it
+		// explicitly. Since there's still an empty limb, we need to fill that.
+		if (atemp.num[i] != 1)
+		{
+			BcRand dig;
+			BcRand bound;
+
+			// Set the bound to the bound of the last limb times the amount
+			// needed to fill the second-to-last limb as well.
+			bound = ((BcRand) atemp.num[i]) * BC_BASE_POW;
+
+			dig = bc_rand_bounded(rng, bound);
+
+			// Fill the last two.
+			b->num[i - 1] = (BcDig) (dig % BC_BASE_POW);
+			b->num[i] = (BcDig) (dig / BC_BASE_POW);
+
+			// Ensure that the length will be correct. If the last limb is zero,
+			// then the length needs to be one less than the bound.
+			b->len = atemp.len - (b->num[i] == 0);
+		}
+		// Here the last limb *is* one, which means the last limb does *not*
+		// need to be filled. Also, the length needs to be one less because the
+		// last limb is 0.
+		else
+		{
+			b->num[i - 1] = (BcDig) bc_rand_bounded(rng, BC_BASE_POW);
+			b->len = atemp.len - 1;
+		}
+	}
+	// Here, there is only one limb to fill.
+	else
+	{
+		// See above for how this works.
+		if (atemp.num[i] != 1)
+		{
+			b->num[i] = (BcDig) bc_rand_bounded(rng, (BcRand) atemp.num[i]);
+			b->len = atemp.len - (b->num[i] == 0);
+		}
+		else b->len = atemp.len - 1;
+	}
+
+	bc_num_clean(b);
+
+	assert(BC_NUM_RDX_VALID(b));
+}
+#endif // BC_ENABLE_EXTRA_MATH
+
+size_t
+bc_num_addReq(const BcNum* a, const BcNum* b, size_t scale)
+{
+	size_t aint, bint, ardx, brdx;
+
+	// Addition and subtraction require the max of the length of the two numbers
+	// plus 1.
+
+	BC_UNUSED(scale);
+
+	ardx = BC_NUM_RDX_VAL(a);
+	aint = bc_num_int(a);
+	assert(aint <= a->len && ardx <= a->len);
+
+	brdx = BC_NUM_RDX_VAL(b);
+	bint = bc_num_int(b);
+	assert(bint <= b->len && brdx <= b->len);
+
+	ardx = BC_MAX(ardx, brdx);
+	aint = BC_MAX(aint, bint);
+
+	return bc_vm_growSize(bc_vm_growSize(ardx, aint), 1);
+}
+
+size_t
+bc_num_mulReq(const BcNum* a, const BcNum* b, size_t scale)
+{
+	size_t max, rdx;
+
+	// Multiplication requires the sum of the lengths of the numbers.
+
+	rdx = bc_vm_growSize(BC_NUM_RDX_VAL(a), BC_NUM_RDX_VAL(b));
+
+	max = BC_NUM_RDX(scale);
+
+	max = bc_vm_growSize(BC_MAX(max, rdx), 1);
+	rdx = bc_vm_growSize(bc_vm_growSize(bc_num_int(a), bc_num_int(b)), max);
+
+	return rdx;
+}
+
+size_t
+bc_num_divReq(const BcNum* a, const BcNum* b, size_t scale)
+{
+	size_t max, rdx;
+
+	// Division requires the length of the dividend plus the scale.
+
+	rdx = bc_vm_growSize(BC_NUM_RDX_VAL(a), BC_NUM_RDX_VAL(b));
+
+	max = BC_NUM_RDX(scale);
+
+	max = bc_vm_growSize(BC_MAX(max, rdx), 1);
+	rdx = bc_vm_growSize(bc_num_int(a), max);
+
+	return rdx;
+}
+
+size_t
+bc_num_powReq(const BcNum* a, const BcNum* b, size_t scale)
+{
+	BC_UNUSED(scale);
+	return bc_vm_growSize(bc_vm_growSize(a->len, b->len), 1);
+}
+
+#if BC_ENABLE_EXTRA_MATH
+size_t
+bc_num_placesReq(const BcNum* a, const BcNum* b, size_t scale)
+{
+	BC_UNUSED(scale);
+	return a->len + b->len - BC_NUM_RDX_VAL(a) - BC_NUM_RDX_VAL(b);
+}
+#endif // BC_ENABLE_EXTRA_MATH
+
+void
+bc_num_add(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, false, bc_num_as, bc_num_addReq(a, b, scale));
+}
+
+void
+bc_num_sub(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, true, bc_num_as, bc_num_addReq(a, b, scale));
+}
+
+void
+bc_num_mul(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_m, bc_num_mulReq(a, b, scale));
+}
+
+void
+bc_num_div(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_d, bc_num_divReq(a, b, scale));
+}
+
+void
+bc_num_mod(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_rem, bc_num_divReq(a, b, scale));
+}
+
+void
+bc_num_pow(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_p, bc_num_powReq(a, b, scale));
+}
+
+#if BC_ENABLE_EXTRA_MATH
+void
+bc_num_places(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_place, bc_num_placesReq(a, b, scale));
+}
+
+void
+bc_num_lshift(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_left, bc_num_placesReq(a, b, scale));
+}
+
+void
+bc_num_rshift(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	assert(BC_NUM_RDX_VALID(a));
+	assert(BC_NUM_RDX_VALID(b));
+	bc_num_binary(a, b, c, scale, bc_num_right, bc_num_placesReq(a, b, scale));
+}
+#endif // BC_ENABLE_EXTRA_MATH
+
+/**
+ * Returns the integer square root of a BcBigDig.
+ * @param n  The number to take the square root of.
+ * @return   The largest integer whose square is not bigger than @a n.
+ */
+static BcBigDig
+bc_num_sqrtDig(BcBigDig n)
+{
+	BcBigDig x, y;
+
+	if (n < 2) return n;
+
+	// Newton's method on integers, starting above the root. It goes down until
+	// it gets to the root.
+	x = n;
+	y = n / 2 + 1;
+
+	while (y < x)
+	{
+		x = y;
+		y = (x + n / x) / 2;
+	}
+
+	return x;
+}
+
+/**
+ * Computes the integer square root of @a n with Newton's method, doubling the
+ * precision each time. The root of the top few limbs of @a n is exact, and each
+ * step takes the root of the top limbs of @a n with about twice as many limbs
+ * as the last. Starting from the last root, plus 1 and shifted into place, is
+ * always above the new root, and it is correct to about half of the limbs, so
+ * one Newton step, which stays above the root, is almost always enough to end
+ * up at the root or 1 above it. A squaring tells which. In the rare case that
+ * it is neither, Newton continues from there, which still works because it
+ * never goes below the root. The divisions and squarings are done at the
+ * length of the current step, so the last step does most of the work.
+ * @param n  The number to take the square root of. It must be a positive
+ *           integer.
+ * @param r  The return parameter. It must be initialized.
+ */
+static void
+bc_num_isqrt(const BcNum* restrict n, BcNum* restrict r)
+{
+	BcNum num1, num2, q, t, sq, v, one;
+	BcNum* x0;
+	BcNum* x1;
+	BcNum* temp;
+	BcDig one_digs[1];
+	size_t shifts[sizeof(size_t) * CHAR_BIT];
+	size_t i, len, depth = 0;
+	BcBigDig top, rem;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(BC_NUM_NONZERO(n) && !BC_NUM_NEG(n) && !BC_NUM_RDX_VAL(n));
+
+	// Figure out the steps on the way down. The shift of each step is small
+	// enough that the root of the rest is correct to more than half of the
+	// root's limbs.
+	for (len = n->len; len > 2; len -= 2 * shifts[depth++])
+	{
+		assert(depth < sizeof(shifts) / sizeof(size_t));
+		shifts[depth] = len >= 7 ? (len - 3) / 4 : 1;
+	}
+
+	// The top limbs fit in a BcBigDig.
+	top = (BcBigDig) n->num[n->len - 1];
+	if (len == 2) top = top * BC_BASE_POW + (BcBigDig) n->num[n->len - 2];
+
+	bc_num_bigdig2num(r, bc_num_sqrtDig(top));
+
+	if (!depth) return;
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&num1, n->len);
+	bc_num_init(&num2, n->len);
+	bc_num_init(&q, n->len);
+	bc_num_init(&t, n->len);
+	bc_num_init(&sq, bc_vm_growSize(n->len, 2));
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_one(&one);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_copy(&num1, r);
+
+	// Pointers for easy switching.
+	x0 = &num1;
+	x1 = &num2;
+
+	for (i = depth - 1; i < depth; --i)
+	{
+		len += 2 * shifts[i];
+
+		// The top limbs of n for this step.
+		bc_num_view(n, n->len - len, len, &v);
+
+		// Start just above the root.
+		bc_num_add(x0, &one, x1, 0);
+		bc_num_shiftLeft(x1, shifts[i] * BC_BASE_DIGS);
+
+		while (true)
+		{
+			// This is the Newton step, x0 = (x1 + v / x1) / 2.
+			bc_num_div(&v, x1, &q, 0);
+			bc_num_add(x1, &q, &t, 0);
+			bc_num_expand(x0, t.len);
+			bc_num_divArray(&t, 2, x0, &rem);
+
+			bc_num_mul(x0, x0, &sq, 0);
+			if (bc_num_cmp(&sq, &v) <= 0) break;
+
+			// It is almost certainly 1 above the root, and then x0 - 1 is the
+			// root. (x0 - 1)^2 = x0^2 - x0 - (x0 - 1).
+			bc_num_sub(x0, &one, x1, 0);
+			bc_num_sub(&sq, x0, &t, 0);
+			bc_num_sub(&t, x1, &sq, 0);
+
+			if (bc_num_cmp(&sq, &v) <= 0)
+			{
+				temp = x0;
+				x0 = x1;
+				x1 = temp;
+				break;
+			}
+		}
+	}
+
+	bc_num_copy(r, x0);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&sq);
+	bc_num_free(&t);
+	bc_num_free(&q);
+	bc_num_free(&num2);
+	bc_num_free(&num1);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Square root into a result that has already been initialized. The math
+ * library kernels need this because they take square roots into their own
+ * temporaries.
+ * @param a      The parameter.
+ * @param b      The return value. It must be initialized.
+ * @param scale  The current scale.
+ */
+static void
+bc_num_sqrtTo(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum n;
+	// realscale is meant to quiet a warning on GCC about longjmp() clobbering.
+	// This one is real.
+	size_t len, places, realscale;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && a != b);
+	assert(!BC_NUM_NEG(a));
+
+	// We want to calculate to a's scale if it is bigger so that the result will
+	// truncate properly.
+	if (a->scale > scale) realscale = a->scale;
+	else realscale = scale;
+
+	assert(a != NULL && b != NULL && a != b);
+	assert(a->num != NULL && b->num != NULL);
+
+	// Easy case.
+	if (BC_NUM_ZERO(a))
+	{
+		bc_num_setToZero(b, realscale);
+		return;
+	}
+
+	// Another easy case.
+	if (BC_NUM_ONE(a))
+	{
+		bc_num_one(b);
+		bc_num_extend(b, realscale);
+		return;
+	}
+
+	// An integer with no scale is the integer square root.
+	if (!realscale)
+	{
+		bc_num_isqrt(a, b);
+		return;
+	}
+
+	// Otherwise, the result is the integer square root of a * 10^(2 * scale),
+	// shifted back by scale places. Because realscale is at least a's scale,
+	// the shift leaves an integer.
+	places = bc_vm_growSize(realscale, realscale);
+	len = bc_vm_growSize(a->len, BC_NUM_RDX(places));
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&n, len);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_copy(&n, a);
+	bc_num_shiftLeft(&n, places);
+
+	assert(!n.scale && !BC_NUM_RDX_VAL_NP(n));
+
+	bc_num_isqrt(&n, b);
+	bc_num_shiftRight(b, realscale);
+
+	assert(!BC_NUM_NEG(b) || BC_NUM_NONZERO(b));
+	assert(BC_NUM_RDX_VALID(b));
+	assert(BC_NUM_RDX_VAL(b) <= b->len || !b->len);
+	assert(!b->len || b->num[b->len - 1] || BC_NUM_RDX_VAL(b) == b->len);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&n);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_sqrt(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	size_t len, rdx, req;
+
+	assert(a != NULL && b != NULL && a != b);
+
+	if (BC_ERR(BC_NUM_NEG(a))) bc_err(BC_ERR_MATH_NEGATIVE);
+
+	// Set parameters for the result.
+	len = bc_vm_growSize(bc_num_intDigits(a), 1);
+	rdx = BC_NUM_RDX(BC_MAX(scale, a->scale));
+
+	// Square root needs half of the length of the parameter.
+	req = bc_vm_growSize(BC_MAX(rdx, BC_NUM_RDX_VAL(a)), len >> 1);
+	req = bc_vm_growSize(req, 1);
+
+	BC_SIG_LOCK;
+
+	// Unlike the binary operators, this function is the only single parameter
+	// function and is expected to initialize the result. This means that it
+	// expects that b is *NOT* preallocated. We allocate it here.
+	bc_num_init(b, req);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_sqrtTo(a, b, scale);
+}
+
+/**
+ * Swaps two numbers, along with the limbs that each one owns.
+ * @param a  The first number.
+ * @param b  The second number.
+ */
+static void
+bc_num_swap(BcNum* restrict a, BcNum* restrict b)
+{
+	BcNum temp;
+
+	BC_SIG_ASSERT_LOCKED;
+
+	// NOLINTNEXTLINE
+	memcpy(&temp, a, sizeof(BcNum));
+	// NOLINTNEXTLINE
+	memcpy(a, b, sizeof(BcNum));
+	// NOLINTNEXTLINE
+	memcpy(b, &temp, sizeof(BcNum));
+}
+
+/**
+ * Applies a binary operator in place, the way bc's assignment operators (like
+ * *=) do, except that the old value is recycled as the next scratch number
+ * instead of being freed. This is used by the math library kernels below.
+ * @param a      The first operand and the destination.
+ * @param b      The second operand.
+ * @param t      A scratch number; it gets the old value of @a a.
+ * @param scale  The current scale.
+ * @param op     The operator.
+ */
+static void
+bc_num_opAssign(BcNum* a, BcNum* b, BcNum* t, size_t scale, BcNumBinaryOp op)
+{
+	op(a, b, t, scale);
+
+	BC_SIG_LOCK;
+
+	bc_num_swap(a, t);
+
+	BC_SIG_UNLOCK;
+}
+
+/**
+ * Negates a number unless it is zero, which bc never makes negative.
+ * @param n  The number to negate.
+ */
+static void
+bc_num_negate(BcNum* n)
+{
+	if (BC_NUM_NONZERO(n)) BC_NUM_NEG_TGL(n);
+}
+
+void
+bc_num_exp(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum x, r, p, f, v, t, c, one, two;
+	BcDig one_digs[1];
+	BcBigDig i;
+	size_t sc, d = 0;
+	bool neg;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && a != b);
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_init(&two, BC_NUM_DEF_SIZE);
+	bc_num_createCopy(&x, a);
+	bc_num_init(&r, BC_NUM_DEF_SIZE);
+	bc_num_init(&p, BC_NUM_DEF_SIZE);
+	bc_num_init(&f, BC_NUM_DEF_SIZE);
+	bc_num_init(&v, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&c, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+	bc_num_bigdig2num(&two, 2);
+
+	neg = BC_NUM_NEG_NP(x);
+	BC_NUM_NEG_CLR_NP(x);
+
+	// e itself comes from the constant cache.
+	if (!neg && !bc_num_cmp(&x, &one))
+	{
+		bc_num_const(BC_NUM_CONST_E, b, scale);
+		goto err;
+	}
+
+	// The working scale is 6 + scale + .44 * x; the last term makes up for the
+	// digits lost in the squarings at the end.
+	bc_num_parse(&c, ".44", BC_BASE);
+	bc_num_mul(&c, &x, &t, scale);
+	bc_num_bigdig2num(&c, (BcBigDig) scale + 6);
+	bc_num_add(&c, &t, &r, scale);
+
+	// Halve x until it is at most 1, remembering how often to square.
+	sc = bc_vm_growSize(x.scale, 1);
+
+	while (bc_num_cmp(&x, &one) > 0)
+	{
+		d += 1;
+		bc_num_opAssign(&x, &two, &t, sc, bc_num_div);
+		sc = bc_vm_growSize(sc, 1);
+	}
+
+	sc = (size_t) bc_num_bigdig(&r);
+
+	// The Taylor series, with the power and factorial kept separately.
+	bc_num_add(&x, &one, &r, sc);
+	bc_num_copy(&p, &x);
+	bc_num_one(&f);
+	bc_num_one(&v);
+
+	for (i = 2; BC_NUM_NONZERO(&v); ++i)
+	{
+		bc_num_opAssign(&p, &x, &t, sc, bc_num_mul);
+		bc_num_bigdig2num(&c, i);
+		bc_num_opAssign(&f, &c, &t, sc, bc_num_mul);
+		bc_num_div(&p, &f, &v, sc);
+		bc_num_opAssign(&r, &v, &t, sc, bc_num_add);
+	}
+
+	for (; d; --d)
+	{
+		bc_num_opAssign(&r, &r, &t, sc, bc_num_mul);
+	}
+
+	if (neg) bc_num_div(&one, &r, b, scale);
+	else bc_num_div(&r, &one, b, scale);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&c);
+	bc_num_free(&t);
+	bc_num_free(&v);
+	bc_num_free(&f);
+	bc_num_free(&p);
+	bc_num_free(&r);
+	bc_num_free(&x);
+	bc_num_free(&two);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_ln(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum x, r, p, u, q, v, t, c, half, one, two;
+	BcDig one_digs[1];
+	BcBigDig i;
+	size_t sc;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && a != b);
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_init(&two, BC_NUM_DEF_SIZE);
+	bc_num_createCopy(&x, a);
+	bc_num_init(&r, BC_NUM_DEF_SIZE);
+	bc_num_init(&p, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&q, BC_NUM_DEF_SIZE);
+	bc_num_init(&v, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&c, BC_NUM_DEF_SIZE);
+	bc_num_init(&half, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+	bc_num_bigdig2num(&two, 2);
+
+	// The library returns 1 - 10^scale for nonpositive numbers.
+	if (BC_NUM_NEG_NP(x) || BC_NUM_ZERO(&x))
+	{
+		bc_num_one(&t);
+		bc_num_shiftLeft(&t, scale);
+		bc_num_sub(&one, &t, &r, scale);
+		bc_num_div(&r, &one, b, scale);
+		goto err;
+	}
+
+	// The logarithms of 2 and 10 come from the constant cache.
+	if (!bc_num_cmp(&x, &two))
+	{
+		bc_num_const(BC_NUM_CONST_LN2, b, scale);
+		goto err;
+	}
+
+	bc_num_bigdig2num(&t, BC_BASE);
+
+	if (!bc_num_cmp(&x, &t))
+	{
+		bc_num_const(BC_NUM_CONST_LN10, b, scale);
+		goto err;
+	}
+
+	sc = bc_vm_growSize(scale, 6);
+
+	// Take square roots until x is in (.5, 2); every one doubles p.
+	bc_num_copy(&p, &two);
+	bc_num_parse(&half, ".5", BC_BASE);
+
+	while (bc_num_cmp(&x, &two) >= 0)
+	{
+		bc_num_opAssign(&p, &two, &t, sc, bc_num_mul);
+		bc_num_sqrtTo(&x, &t, sc);
+		bc_num_copy(&x, &t);
+	}
+
+	while (bc_num_cmp(&x, &half) <= 0)
+	{
+		bc_num_opAssign(&p, &two, &t, sc, bc_num_mul);
+		bc_num_sqrtTo(&x, &t, sc);
+		bc_num_copy(&x, &t);
+	}
+
+	// The series for ln((1 + a) / (1 - a)), with a = (x - 1) / (x + 1).
+	bc_num_sub(&x, &one, &t, sc);
+	bc_num_add(&x, &one, &v, sc);
+	bc_num_div(&t, &v, &r, sc);
+	bc_num_copy(&u, &r);
+	bc_num_mul(&u, &u, &q, sc);
+	bc_num_one(&v);
+
+	for (i = 3; BC_NUM_NONZERO(&v); i += 2)
+	{
+		bc_num_opAssign(&u, &q, &t, sc, bc_num_mul);
+		bc_num_bigdig2num(&c, i);
+		bc_num_div(&u, &c, &v, sc);
+		bc_num_opAssign(&r, &v, &t, sc, bc_num_add);
+	}
+
+	bc_num_opAssign(&r, &p, &t, sc, bc_num_mul);
+
+	bc_num_div(&r, &one, b, scale);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&half);
+	bc_num_free(&c);
+	bc_num_free(&t);
+	bc_num_free(&v);
+	bc_num_free(&q);
+	bc_num_free(&u);
+	bc_num_free(&p);
+	bc_num_free(&r);
+	bc_num_free(&x);
+	bc_num_free(&two);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_sin(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum x, r, pi4, u, q, t, w, c, one;
+	BcDig one_digs[1];
+	BcBigDig i;
+	size_t sc;
+	bool neg;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && a != b);
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_createCopy(&x, a);
+	bc_num_init(&r, BC_NUM_DEF_SIZE);
+	bc_num_init(&pi4, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&q, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&w, BC_NUM_DEF_SIZE);
+	bc_num_init(&c, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+
+	// Sine is odd, so work on the absolute value.
+	neg = BC_NUM_NEG_NP(x);
+	BC_NUM_NEG_CLR_NP(x);
+
+	// Reduce x modulo pi / 2 with pi / 4 to 1.1 * scale + 2 places. q is
+	// rounded so that x ends up in [-pi / 4, pi / 4] after the subtraction.
+	sc = bc_vm_growSize(scale + scale / 10, 2);
+
+	bc_num_const(BC_NUM_CONST_PI, &t, bc_vm_growSize(sc, 1));
+	bc_num_bigdig2num(&c, 4);
+	bc_num_div(&t, &c, &pi4, sc);
+
+	bc_num_div(&x, &pi4, &t, 0);
+	bc_num_bigdig2num(&c, 2);
+	bc_num_add(&t, &c, &u, 0);
+	bc_num_bigdig2num(&c, 4);
+	bc_num_div(&u, &c, &q, 0);
+
+	bc_num_mul(&c, &q, &t, 0);
+	bc_num_mul(&t, &pi4, &u, 0);
+	bc_num_opAssign(&x, &u, &t, 0, bc_num_sub);
+
+	// Odd quarter turns flip the sign. q is an integer and limbs are even
+	// powers of ten, so the parity is in the lowest limb.
+	if (BC_NUM_NONZERO(&q) && (q.num[0] & 1)) bc_num_negate(&x);
+
+	sc = bc_vm_growSize(scale, 2);
+
+	// The Taylor series, with each term computed from the last.
+	bc_num_copy(&r, &x);
+	bc_num_copy(&u, &x);
+	bc_num_mul(&x, &x, &q, sc);
+	bc_num_negate(&q);
+
+	for (i = 3; BC_NUM_NONZERO(&u); i += 2)
+	{
+		bc_num_bigdig2num(&c, i * (i - 1));
+		bc_num_div(&q, &c, &t, sc);
+		bc_num_opAssign(&u, &t, &w, sc, bc_num_mul);
+		bc_num_opAssign(&r, &u, &w, sc, bc_num_add);
+	}
+
+	bc_num_div(&r, &one, b, scale);
+
+	if (neg) bc_num_negate(b);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&c);
+	bc_num_free(&w);
+	bc_num_free(&t);
+	bc_num_free(&q);
+	bc_num_free(&u);
+	bc_num_free(&pi4);
+	bc_num_free(&r);
+	bc_num_free(&x);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_cos(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum t, u, x;
+	size_t sc;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && a != b);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&x, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// cos(x) = sin(pi / 2 + x), to 1.2 * scale places. Like the library's
+	// 2 * a(1), pi / 2 is twice pi / 4 at that scale.
+	sc = scale + scale / 5;
+
+	bc_num_const(BC_NUM_CONST_PI, &t, bc_vm_growSize(sc, 1));
+	bc_num_bigdig2num(&x, 4);
+	bc_num_div(&t, &x, &u, sc);
+	bc_num_add(&u, &u, &t, sc);
+	bc_num_add(&t, a, &u, sc);
+	bc_num_sin(&u, &x, sc);
+
+	bc_num_one(&t);
+	bc_num_div(&x, &t, b, scale);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&x);
+	bc_num_free(&u);
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_atan(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum x, n, at, r, u, f, t, w, c, fifth, one;
+	BcDig one_digs[1];
+	BcBigDig i, m = 0;
+	size_t sc;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a != NULL && b != NULL && a != b);
+
+	BC_SIG_LOCK;
+
+	bc_num_setup(&one, one_digs, sizeof(one_digs) / sizeof(BcDig));
+	bc_num_createCopy(&x, a);
+	bc_num_init(&n, BC_NUM_DEF_SIZE);
+	bc_num_init(&at, BC_NUM_DEF_SIZE);
+	bc_num_init(&r, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&f, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&w, BC_NUM_DEF_SIZE);
+	bc_num_init(&c, BC_NUM_DEF_SIZE);
+	bc_num_init(&fifth, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_one(&one);
+
+	// Arctangent is odd; n is the sign to divide by at the end.
+	bc_num_one(&n);
+
+	if (BC_NUM_NEG_NP(x))
+	{
+		BC_NUM_NEG_CLR_NP(x);
+		bc_num_negate(&n);
+	}
+
+	bc_num_parse(&fifth, ".2", BC_BASE);
+
+	// The two arguments the other kernels need are precomputed to 64 places.
+	if (scale < 65)
+	{
+		if (!bc_num_cmp(&x, &one))
+		{
+			bc_num_parse(&t, bc_num_atan1, BC_BASE);
+			bc_num_div(&t, &n, b, scale);
+			goto err;
+		}
+
+		if (!bc_num_cmp(&x, &fifth))
+		{
+			bc_num_parse(&t, bc_num_atan_fifth, BC_BASE);
+			bc_num_div(&t, &n, b, scale);
+			goto err;
+		}
+	}
+
+	// Reduce x to at most .2 with the addition formula, which needs atan(.2).
+	if (bc_num_cmp(&x, &fifth) > 0)
+	{
+		bc_num_atan(&fifth, &at, bc_vm_growSize(scale, 5));
+	}
+
+	sc = bc_vm_growSize(scale, 3);
+
+	while (bc_num_cmp(&x, &fifth) > 0)
+	{
+		m += 1;
+		bc_num_sub(&x, &fifth, &t, sc);
+		bc_num_mul(&fifth, &x, &u, sc);
+		bc_num_add(&one, &u, &w, sc);
+		bc_num_div(&t, &w, &x, sc);
+	}
+
+	// The Taylor series, with each power computed from the last.
+	bc_num_copy(&r, &x);
+	bc_num_copy(&u, &x);
+	bc_num_mul(&x, &x, &f, sc);
+	bc_num_negate(&f);
+	bc_num_one(&t);
+
+	for (i = 3; BC_NUM_NONZERO(&t); i += 2)
+	{
+		bc_num_opAssign(&u, &f, &w, sc, bc_num_mul);
+		bc_num_bigdig2num(&c, i);
+		bc_num_div(&u, &c, &t, sc);
+		bc_num_opAssign(&r, &t, &w, sc, bc_num_add);
+	}
+
+	bc_num_bigdig2num(&c, m);
+	bc_num_mul(&c, &at, &u, scale);
+	bc_num_add(&u, &r, &t, scale);
+	bc_num_div(&t, &n, b, scale);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&fifth);
+	bc_num_free(&c);
+	bc_num_free(&w);
+	bc_num_free(&t);
+	bc_num_free(&f);
+	bc_num_free(&u);
+	bc_num_free(&r);
+	bc_num_free(&at);
+	bc_num_free(&n);
+	bc_num_free(&x);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Computes one term of a series for binary splitting: the ratio p / q of the
+ * term to the last one, and t, which is the ratio times the term's own factor
+ * (if it has one). See bc_num_bsplit() for what the series are.
+ * @param s  The series.
+ * @param x  The argument for BC_NUM_SERIES_ATANH.
+ * @param n  The index of the term.
+ * @param p  The return parameter for the numerator of the ratio.
+ * @param q  The return parameter for the denominator of the ratio.
+ * @param t  The return parameter for the term factor times @a p.
+ */
+static void
+bc_num_bsLeaf(BcNumSeries s, BcBigDig x, size_t n, BcNum* restrict p,
+              BcNum* restrict q, BcNum* restrict t)
+{
+	BcNum f, g;
+	BcBigDig k = (BcBigDig) n;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// The term n of the series for e is 1 / (n + 1)!.
+	if (s == BC_NUM_SERIES_E)
+	{
+		bc_num_one(p);
+		bc_num_bigdig2num(q, k + 1);
+		bc_num_one(t);
+		return;
+	}
+
+	// The term n of the series for atanh(1 / x) is 1 / ((2n + 1) x^(2n + 1)),
+	// so the ratio to the last one is (2n - 1) / ((2n + 1) x^2).
+	if (s == BC_NUM_SERIES_ATANH)
+	{
+		bc_num_bigdig2num(p, n ? 2 * k - 1 : 1);
+		bc_num_bigdig2num(q, n ? (2 * k + 1) * x * x : x);
+		bc_num_copy(t, p);
+		return;
+	}
+
+	assert(s == BC_NUM_SERIES_CHUDNOVSKY);
+
+	if (!n)
+	{
+		bc_num_one(p);
+		bc_num_one(q);
+		bc_num_bigdig2num(t, 13591409);
+		return;
+	}
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&f, BC_NUM_DEF_SIZE);
+	bc_num_init(&g, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// The ratio is -(6k - 5)(2k - 1)(6k - 1) / (k^3 * 640320^3 / 24), and the
+	// term factor is 13591409 + 545140134k. The pieces are multiplied as
+	// numbers because their products overflow a 32-bit BcBigDig.
+	bc_num_bigdig2num(&f, 6 * k - 5);
+	bc_num_bigdig2num(&g, 2 * k - 1);
+	bc_num_mul(&f, &g, t, 0);
+	bc_num_bigdig2num(&f, 6 * k - 1);
+	bc_num_mul(t, &f, p, 0);
+	bc_num_negate(p);
+
+	bc_num_bigdig2num(&f, k);
+	bc_num_mul(&f, &f, &g, 0);
+	bc_num_mul(&g, &f, t, 0);
+	bc_num_parse(&f, "10939058860032000", BC_BASE);
+	bc_num_mul(t, &f, q, 0);
+
+	bc_num_bigdig2num(&f, k);
+	bc_num_bigdig2num(&g, 545140134);
+	bc_num_mul(&f, &g, t, 0);
+	bc_num_bigdig2num(&f, 13591409);
+	bc_num_add(t, &f, &g, 0);
+	bc_num_mul(p, &g, t, 0);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&g);
+	bc_num_free(&f);
+	BC_LONGJMP_CONT(vm);
+}
+
+/**
+ * Sums the terms [a, b) of a series by binary splitting. Each term is the last
+ * one times a ratio p / q, and possibly times a factor of its own; this returns
+ * the product of the p's, the product of the q's, and t such that the sum is
+ * t / q. Splitting keeps the numbers balanced, so the fast multiplication
+ * algorithms do almost all of the work.
+ * @param s      The series.
+ * @param x      The argument for BC_NUM_SERIES_ATANH.
+ * @param a      The first term.
+ * @param b      One past the last term.
+ * @param p      The return parameter for the product of the p's.
+ * @param q      The return parameter for the product of the q's.
+ * @param t      The return parameter for the numerator of the sum.
+ * @param needp  True if @a p is needed. Only the left halves need it.
+ */
+static void
+bc_num_bsplit(BcNumSeries s, BcBigDig x, size_t a, size_t b, BcNum* restrict p,
+              BcNum* restrict q, BcNum* restrict t, bool needp)
+{
+	BcNum p2, q2, t2, temp;
+	size_t m;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(a < b);
+
+	if (b - a == 1)
 	{
-		BC_SIG_UNLOCK;
-		bc_num_expand(c, req);
+		bc_num_bsLeaf(s, x, a, p, q, t);
+		return;
 	}
 
-	// It is okay for a and b to be the same. If a binary operator function does
-	// need them to be different, the binary operator function is responsible
-	// for that.
+	m = a + (b - a) / 2;
 
-	// Call the actual binary operator function.
-	op(ptr_a, ptr_b, c, scale);
+	bc_num_bsplit(s, x, a, m, p, q, t, true);
 
-	assert(!BC_NUM_NEG(c) || BC_NUM_NONZERO(c));
-	assert(BC_NUM_RDX_VAL(c) <= c->len || !c->len);
-	assert(BC_NUM_RDX_VALID(c));
-	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
+	BC_SIG_LOCK;
+
+	bc_num_init(&p2, BC_NUM_DEF_SIZE);
+	bc_num_init(&q2, BC_NUM_DEF_SIZE);
+	bc_num_init(&t2, BC_NUM_DEF_SIZE);
+	bc_num_init(&temp, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_bsplit(s, x, m, b, &p2, &q2, &t2, needp);
+
+	// t = t1 * q2 + p1 * t2, and the products are just products.
+	bc_num_mul(t, &q2, &temp, 0);
+	bc_num_mul(p, &t2, t, 0);
+	bc_num_opAssign(t, &temp, &t2, 0, bc_num_add);
+	bc_num_opAssign(q, &q2, &temp, 0, bc_num_mul);
+
+	if (needp) bc_num_opAssign(p, &p2, &temp, 0, bc_num_mul);
 
 err:
-	// Cleanup only needed if we initialized c to a new number.
-	if (c == a || c == b)
-	{
-		BC_SIG_MAYLOCK;
-		bc_num_free(&num2);
-		BC_LONGJMP_CONT(vm);
-	}
+	BC_SIG_MAYLOCK;
+	bc_num_free(&temp);
+	bc_num_free(&t2);
+	bc_num_free(&q2);
+	bc_num_free(&p2);
+	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Tests a number string for validity. This function has a history; I originally
- * wrote it because I did not trust my parser. Over time, however, I came to
- * trust it, so I was able to relegate this function to debug builds only, and I
- * used it in assert()'s. But then I created the library, and well, I can't
- * trust users, so I reused this for yelling at users.
- * @param val  The string to check to see if it's a valid number string.
- * @return     True if the string is a valid number string, false otherwise.
+ * Sums a series by binary splitting to @a scale places.
+ * @param s      The series.
+ * @param x      The argument for BC_NUM_SERIES_ATANH.
+ * @param terms  The number of terms to sum.
+ * @param r      The return parameter. It must be initialized.
+ * @param scale  The scale to sum to.
  */
-bool
-bc_num_strValid(const char* restrict val)
+static void
+bc_num_series(BcNumSeries s, BcBigDig x, size_t terms, BcNum* restrict r,
+              size_t scale)
 {
-	bool radix = false;
-	size_t i, len = strlen(val);
+	BcNum p, q, t;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// Notice that I don't check if there is a negative sign. That is not part
-	// of a valid number, except in the library. The library-specific code takes
-	// care of that part.
+	BC_SIG_LOCK;
 
-	// Nothing in the string is okay.
-	if (!len) return true;
+	bc_num_init(&p, BC_NUM_DEF_SIZE);
+	bc_num_init(&q, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
 
-	// Loop through the characters.
-	for (i = 0; i < len; ++i)
-	{
-		BcDig c = val[i];
+	BC_SETJMP_LOCKED(vm, err);
 
-		// If we have found a radix point...
-		if (c == '.')
-		{
-			// We don't allow two radices.
-			if (radix) return false;
+	BC_SIG_UNLOCK;
 
-			radix = true;
-			continue;
-		}
+	bc_num_bsplit(s, x, 0, terms, &p, &q, &t, false);
 
-		// We only allow digits and uppercase letters.
-		if (!(isdigit(c) || isupper(c))) return false;
-	}
+	// Chudnovsky sums to a multiple of 1 / pi, so it is the other way around.
+	if (s == BC_NUM_SERIES_CHUDNOVSKY) bc_num_div(&q, &t, r, scale);
+	else bc_num_div(&t, &q, r, scale);
 
-	return true;
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&t);
+	bc_num_free(&q);
+	bc_num_free(&p);
+	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Parses one character and returns the digit that corresponds to that
- * character according to the base.
- * @param c     The character to parse.
- * @param base  The base.
- * @return      The character as a digit.
+ * Computes a constant from scratch, to at least @a scale places. The result is
+ * truncated to exactly @a scale places.
+ * @param c      The constant.
+ * @param r      The return parameter. It must be initialized.
+ * @param scale  The scale to compute to.
  */
-static BcBigDig
-bc_num_parseChar(char c, size_t base)
+static void
+bc_num_constCompute(BcNumConst c, BcNum* restrict r, size_t scale)
 {
-	assert(isupper(c) || isdigit(c));
-
-	// If a letter...
-	if (isupper(c))
-	{
+	BcNum t, u;
+	size_t n, lg, next, digits, places;
 #if BC_ENABLE_LIBRARY
-		BcVm* vm = bcl_getspecific();
+	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-		// This returns the digit that directly corresponds with the letter.
-		c = BC_NUM_NUM_LETTER(c);
+	places = bc_vm_growSize(scale, BC_NUM_CONST_GUARD);
 
-		// If the digit is greater than the base, we clamp.
-		if (BC_DIGIT_CLAMP)
+	BC_SIG_LOCK;
+
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	switch (c)
+	{
+		case BC_NUM_CONST_PI:
 		{
-			c = ((size_t) c) >= base ? (char) base - 1 : c;
+			// pi = 426880 * sqrt(10005) / sum, and every term of the sum is
+			// worth more than 14 digits.
+			bc_num_series(BC_NUM_SERIES_CHUDNOVSKY, 0, places / 14 + 2, &t,
+			              places);
+			bc_num_bigdig2num(&u, 10005);
+			bc_num_sqrtTo(&u, r, places);
+			bc_num_opAssign(&t, r, &u, places, bc_num_mul);
+			bc_num_bigdig2num(&u, 426880);
+			bc_num_mul(&t, &u, r, places);
+			break;
+		}
+
+		case BC_NUM_CONST_E:
+		{
+			// The sum of floor(log10(k)) is a lower bound on the digits of n!,
+			// so this finds enough terms.
+			for (n = 1, lg = 0, next = BC_BASE, digits = 0; digits <= places;
+			     ++n)
+			{
+				if (n == next)
+				{
+					lg += 1;
+					next *= BC_BASE;
+				}
+
+				digits += lg;
+			}
+
+			bc_num_series(BC_NUM_SERIES_E, 0, n, &t, places);
+			bc_num_add(&t, &vm->one, r, places);
+			break;
+		}
+
+		case BC_NUM_CONST_LN2:
+		{
+			// ln(2) = 2 * atanh(1 / 3), and every term is worth more than .95
+			// digits.
+			bc_num_series(BC_NUM_SERIES_ATANH, 3, places + places / 20 + 2, &t,
+			              places);
+			bc_num_add(&t, &t, r, places);
+			break;
+		}
+
+		case BC_NUM_CONST_LN10:
+		{
+			// ln(10) = 3 * ln(2) + 2 * atanh(1 / 9), and every term of the
+			// latter is worth more than 1.9 digits.
+			bc_num_series(BC_NUM_SERIES_ATANH, 9, places / 2 + places / 20 + 2,
+			              &u, places);
+			bc_num_add(&u, &u, r, places);
+			bc_num_const(BC_NUM_CONST_LN2, &u, places);
+			bc_num_opAssign(r, &u, &t, places, bc_num_add);
+			bc_num_opAssign(r, &u, &t, places, bc_num_add);
+			bc_num_opAssign(r, &u, &t, places, bc_num_add);
+			break;
+		}
+
+		case BC_NUM_CONST_NUM:
+		{
+#if BC_DEBUG
+			// This is not a constant.
+			abort();
+#endif // BC_DEBUG
 		}
 	}
-	// Straight convert the digit to a number.
-	else c -= '0';
 
-	return (BcBigDig) (uchar) c;
+	bc_num_truncate(r, r->scale - scale);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&u);
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Parses a string as a decimal number. This is separate because it's going to
- * be the most used, and it can be heavily optimized for decimal only.
- * @param n    The number to parse into and return. Must be preallocated.
- * @param val  The string to parse.
+ * Computes a constant to @a scale places and replaces the cached one with it.
+ * The cache only changes once the new constant is complete.
+ * @param c      The constant.
+ * @param scale  The scale to compute to.
  */
 static void
-bc_num_parseDecimal(BcNum* restrict n, const char* restrict val)
+bc_num_constUpdate(BcNumConst c, size_t scale)
 {
-	size_t len, i, temp, mod;
-	const char* ptr;
-	bool zero = true, rdx;
+	BcNum t;
+	size_t places;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	// Eat leading zeroes.
-	for (i = 0; val[i] == '0'; ++i)
-	{
-		continue;
-	}
+	BC_SIG_LOCK;
 
-	val += i;
-	assert(!val[0] || isalnum(val[0]) || val[0] == '.');
+	// All of the constants have one integer limb. Allocating the result up
+	// front makes scales that cannot fit in memory fail before any work.
+	places = bc_vm_growSize(scale, BC_NUM_CONST_GUARD);
+	bc_num_init(&t, bc_vm_growSize(BC_NUM_RDX(places), 1));
 
-	// All 0's. We can just return, since this procedure expects a virgin
-	// (already 0) BcNum.
-	if (!val[0]) return;
+	BC_SETJMP_LOCKED(vm, err);
 
-	// The length of the string is the length of the number, except it might be
-	// one bigger because of a decimal point.
-	len = strlen(val);
+	BC_SIG_UNLOCK;
 
-	// Find the location of the decimal point.
-	ptr = strchr(val, '.');
-	rdx = (ptr != NULL);
+	bc_num_constCompute(c, &t, scale);
 
-	// We eat leading zeroes again. These leading zeroes are different because
-	// they will come after the decimal point if they exist, and since that's
-	// the case, they must be preserved.
-	for (i = 0; i < len && (zero = (val[i] == '0' || val[i] == '.')); ++i)
+	BC_SIG_LOCK;
+
+	// The old constant ends up in t, to be freed.
+	bc_num_swap(&vm->consts[c], &t);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
+}
+
+void
+bc_num_const(BcNumConst c, BcNum* restrict r, size_t scale)
+{
+	BcNum* cached;
+	size_t places;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	assert(c < BC_NUM_CONST_NUM);
+
+	cached = &vm->consts[c];
+
+	// A cached constant serves every scale up to its own by truncation. If it
+	// is not good enough, compute a better one with room to grow, so that
+	// slowly growing scales do not recompute it every time.
+	if (BC_NUM_ZERO(cached) || cached->scale < scale)
 	{
-		continue;
+		places = BC_NUM_ZERO(cached) ? 0 : cached->scale + cached->scale / 2;
+		bc_num_constUpdate(c, BC_MAX(places, scale));
 	}
 
-	// Set the scale of the number based on the location of the decimal point.
-	// The casts to uintptr_t is to ensure that bc does not hit undefined
-	// behavior when doing math on the values.
-	n->scale = (size_t) (rdx *
-	                     (((uintptr_t) (val + len)) - (((uintptr_t) ptr) + 1)));
+	bc_num_copy(r, cached);
+	bc_num_truncate(r, r->scale - scale);
+}
 
-	// Set rdx.
-	BC_NUM_RDX_SET(n, BC_NUM_RDX(n->scale));
+#if BC_ENABLE_EXTRA_MATH
+void
+bc_num_pi(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum n;
 
-	// Calculate length. First, the length of the integer, then the number of
-	// digits in the last limb, then the length.
-	i = len - (ptr == val ? 0 : i) - rdx;
-	temp = BC_NUM_ROUND_POW(i);
-	mod = n->scale % BC_BASE_DIGS;
-	i = mod ? BC_BASE_DIGS - mod : 0;
-	n->len = ((temp + i) / BC_BASE_DIGS);
+	BC_UNUSED(scale);
+
+	// The library takes the absolute value of the argument and truncates it,
+	// so a shallow copy without the sign is all the conversion needs.
+	// NOLINTNEXTLINE
+	memcpy(&n, a, sizeof(BcNum));
+	BC_NUM_NEG_CLR_NP(n);
+
+	bc_num_const(BC_NUM_CONST_PI, b, (size_t) bc_num_bigdig(&n));
+}
+
+/**
+ * Returns the width in bits that a bitwise function of the extended math
+ * library works in, which it takes as a number of bytes.
+ * @param n  The number of bytes.
+ * @return   The number of bits.
+ */
+static size_t
+bc_num_bitWidth(const BcNum* restrict n)
+{
+	BcNum v;
+	BcBigDig bytes;
+
+	bc_num_intView(n, &v);
+
+	bytes = bc_num_bigdig(&v);
+
+	// The width must fit in a BcBigDig for rotations.
+	if (BC_ERR(bytes > BC_NUM_BIGDIG_MAX / 8)) bc_err(BC_ERR_MATH_OVERFLOW);
+
+	return (size_t) (bytes * 8);
+}
+
+/**
+ * Returns the amount of a rotation, reduced modulo the width, like the library
+ * does.
+ * @param p     The amount to rotate by.
+ * @param bits  The width to rotate in.
+ * @return      @a p modulo @a bits.
+ */
+static size_t
+bc_num_bitRot(const BcNum* restrict p, size_t bits)
+{
+	BcNum v, b, r;
+	size_t rot = 0;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (BC_ERR(!bits)) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+
+	bc_num_intView(p, &v);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&b, BC_NUM_DEF_SIZE);
+	bc_num_init(&r, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_bigdig2num(&b, (BcBigDig) bits);
+	bc_num_mod(&v, &b, &r, 0);
+
+	rot = (size_t) bc_num_bigdig2(&r);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&r);
+	bc_num_free(&b);
+	BC_LONGJMP_CONT(vm);
+
+	return rot;
+}
+
+/**
+ * Converts the absolute value of the integer part of @a n to binary limbs, the
+ * way the bitwise functions of the extended math library see their operands.
+ * @param n     The number to convert.
+ * @param d     The return parameter; little-endian binary limbs. It must have
+ *              room for @a dlen limbs, which must be enough for the integer
+ *              part of @a n.
+ * @param dlen  The number of limbs to return. The limbs above @a n are zero.
+ * @param w     Scratch space with room for as many words as the integer part
+ *              of @a n has limbs.
+ */
+static void
+bc_num_bitsGet(const BcNum* restrict n, BcBinDig* restrict d, size_t dlen,
+               uint32_t* restrict w)
+{
+	BcNum v;
+
+	bc_num_intView(n, &v);
+
+	assert(bc_num_binLen(v.len) <= dlen);
 
-	// Expand and zero. The plus extra is in case the lack of clamping causes
-	// the number to overflow the original bounds.
-	bc_num_expand(n, n->len + !BC_DIGIT_CLAMP);
-	// NOLINTNEXTLINE
-	memset(n->num, 0, BC_NUM_SIZE(n->len + !BC_DIGIT_CLAMP));
+	bc_num_toBin(&v, w);
+	bc_num_binPack(d, dlen, w, v.len);
+}
 
-	if (zero)
-	{
-		// I think I can set rdx directly to zero here because n should be a
-		// new number with sign set to false.
-		n->len = n->rdx = 0;
-	}
-	else
-	{
-		// There is actually stuff to parse if we make it here. Yay...
-		BcBigDig exp, pow;
+/**
+ * Converts binary limbs to a number for the bitwise functions.
+ * @param c     The return parameter. It must be initialized.
+ * @param d     The limbs to convert.
+ * @param dlen  The number of limbs.
+ * @param w     Scratch space with room for @a dlen * BC_NUM_BINDIG_WORDS
+ *              words.
+ */
+static void
+bc_num_bitsSet(BcNum* restrict c, const BcBinDig* restrict d, size_t dlen,
+               uint32_t* restrict w)
+{
+	bc_num_binUnpack(w, d, dlen);
+	bc_num_fromBin(c, w, dlen * BC_NUM_BINDIG_WORDS);
+}
 
-		assert(i <= BC_NUM_BIGDIG_MAX);
+/**
+ * Clears the bits of @a d from bit @a bits on, in the top limb.
+ * @param d     The limbs.
+ * @param bits  The number of bits to keep.
+ */
+static void
+bc_num_bitsMask(BcBinDig* restrict d, size_t bits)
+{
+	size_t k = bits % BC_NUM_BINDIG_BITS;
 
-		// The exponent and power.
-		exp = (BcBigDig) i;
-		pow = bc_num_pow10[exp];
+	if (k) d[bits / BC_NUM_BINDIG_BITS] &= (((BcBinDig) 1) << k) - 1;
+}
 
-		// Parse loop. We parse backwards because numbers are stored little
-		// endian.
-		for (i = len - 1; i < len; --i, ++exp)
+/**
+ * Ors @a d, shifted left by @a s bits, into @a r. Bits that are shifted past
+ * the end of @a r are dropped.
+ * @param r     The limbs to or into.
+ * @param rlen  The number of limbs in @a r.
+ * @param d     The limbs to shift.
+ * @param dlen  The number of limbs in @a d.
+ * @param s     The number of bits to shift by.
+ */
+static void
+bc_num_bitsShl(BcBinDig* restrict r, size_t rlen, const BcBinDig* restrict d,
+               size_t dlen, size_t s)
+{
+	size_t i, q = s / BC_NUM_BINDIG_BITS, k = s % BC_NUM_BINDIG_BITS;
+
+	for (i = 0; i < dlen && i + q < rlen; ++i)
+	{
+		BcBinProd v = ((BcBinProd) d[i]) << k;
+
+		r[i + q] |= (BcBinDig) v;
+		if (i + q + 1 < rlen)
 		{
-			char c = val[i];
+			r[i + q + 1] |= (BcBinDig) (v >> BC_NUM_BINDIG_BITS);
+		}
+	}
+}
 
-			// Skip the decimal point.
-			if (c == '.') exp -= 1;
-			else
-			{
-				// The index of the limb.
-				size_t idx = exp / BC_BASE_DIGS;
-				BcBigDig dig;
+/**
+ * Ors @a d, shifted right by @a s bits, into @a r.
+ * @param r     The limbs to or into.
+ * @param rlen  The number of limbs in @a r.
+ * @param d     The limbs to shift.
+ * @param dlen  The number of limbs in @a d.
+ * @param s     The number of bits to shift by.
+ */
+static void
+bc_num_bitsShr(BcBinDig* restrict r, size_t rlen, const BcBinDig* restrict d,
+               size_t dlen, size_t s)
+{
+	size_t i, q = s / BC_NUM_BINDIG_BITS, k = s % BC_NUM_BINDIG_BITS;
 
-				if (isupper(c))
-				{
-					// Clamp for the base.
-					if (!BC_DIGIT_CLAMP) c = BC_NUM_NUM_LETTER(c);
-					else c = 9;
-				}
-				else c -= '0';
+	for (i = q; i < dlen && i - q < rlen; ++i)
+	{
+		// The top half goes into limb i - q and the bottom into the one below.
+		BcBinProd v = (((BcBinProd) d[i]) << BC_NUM_BINDIG_BITS) >> k;
 
-				// Add the digit to the limb. This takes care of overflow from
-				// lack of clamping.
-				dig = ((BcBigDig) n->num[idx]) + ((BcBigDig) c) * pow;
-				if (dig >= BC_BASE_POW)
-				{
-					// We cannot go over BC_BASE_POW with clamping.
-					assert(!BC_DIGIT_CLAMP);
+		r[i - q] |= (BcBinDig) (v >> BC_NUM_BINDIG_BITS);
+		if (i > q) r[i - q - 1] |= (BcBinDig) v;
+	}
+}
 
-					n->num[idx + 1] = (BcDig) (dig / BC_BASE_POW);
-					n->num[idx] = (BcDig) (dig % BC_BASE_POW);
-					assert(n->num[idx] >= 0 && n->num[idx] < BC_BASE_POW);
-					assert(n->num[idx + 1] >= 0 &&
-					       n->num[idx + 1] < BC_BASE_POW);
-				}
-				else
-				{
-					n->num[idx] = (BcDig) dig;
-					assert(n->num[idx] >= 0 && n->num[idx] < BC_BASE_POW);
-				}
+/**
+ * Reverses the bits of a binary limb.
+ * @param v  The limb to reverse.
+ * @return   @a v with its bits in reverse order.
+ */
+static BcBinDig
+bc_num_bitsRev(BcBinDig v)
+{
+	BcBinDig m = ~((BcBinDig) 0);
+	size_t s;
 
-				// Adjust the power and exponent.
-				if ((exp + 1) % BC_BASE_DIGS == 0) pow = 1;
-				else pow *= BC_BASE;
-			}
-		}
+	// Swap the halves of smaller and smaller pieces. The mask has ones in the
+	// bottom half of every piece.
+	for (s = BC_NUM_BINDIG_BITS / 2; s; s >>= 1)
+	{
+		m ^= m << s;
+		v = ((v >> s) & m) | ((v & m) << s);
 	}
 
-	// Make sure to add one to the length if needed from lack of clamping.
-	n->len += (!BC_DIGIT_CLAMP && n->num[n->len] != 0);
+	return v;
 }
 
 /**
- * Parse a number in any base (besides decimal).
- * @param n     The number to parse into and return. Must be preallocated.
- * @param val   The string to parse.
- * @param base  The base to parse as.
+ * Does an and, or, or xor of the binary forms of @a a and @a b, the way the
+ * extended math library does: on absolute values, truncated.
+ * @param a   The first operand.
+ * @param b   The second operand.
+ * @param c   The return parameter. It must be initialized.
+ * @param op  The operation.
  */
 static void
-bc_num_parseBase(BcNum* restrict n, const char* restrict val, BcBigDig base)
+bc_num_bitLogic(const BcNum* a, const BcNum* b, BcNum* restrict c,
+                BcNumBitOp op)
 {
-	BcNum temp, mult1, mult2, result1, result2;
-	BcNum* m1;
-	BcNum* m2;
-	BcNum* ptr;
-	char c = 0;
-	bool zero = true;
-	BcBigDig v;
-	size_t digs, len = strlen(val);
-	// This is volatile to quiet a warning on GCC about longjmp() clobbering.
-	volatile size_t i;
+	BcBinDig* d;
+	BcBinDig* x;
+	uint32_t* w;
+	size_t i, dlen;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	// If zero, just return because the number should be virgin (already 0).
-	for (i = 0; zero && i < len; ++i)
-	{
-		zero = (val[i] == '.' || val[i] == '0');
-	}
-	if (zero) return;
+	assert(c != a && c != b);
+
+	dlen = bc_num_binLen(BC_MAX(bc_num_int(a), bc_num_int(b)));
 
 	BC_SIG_LOCK;
 
-	bc_num_init(&temp, BC_NUM_BIGDIG_LOG10);
-	bc_num_init(&mult1, BC_NUM_BIGDIG_LOG10);
+	// Both operands and the scratch words for conversion go in one allocation,
+	// which is never empty.
+	d = bc_vm_malloc(bc_vm_arraySize(bc_vm_growSize(dlen, 1),
+	                                 3 * sizeof(BcBinDig)));
 
-	BC_SETJMP_LOCKED(vm, int_err);
+	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	// We split parsing into parsing the integer and parsing the fractional
-	// part.
+	x = d + dlen;
+	w = (uint32_t*) (x + dlen);
 
-	// Parse the integer part. This is the easy part because we just multiply
-	// the number by the base, then add the digit.
-	for (i = 0; i < len && (c = val[i]) && c != '.'; ++i)
+	bc_num_bitsGet(a, d, dlen, w);
+	bc_num_bitsGet(b, x, dlen, w);
+
+	switch (op)
 	{
-		// Convert the character to a digit.
-		v = bc_num_parseChar(c, base);
+		case BC_NUM_BIT_AND:
+		{
+			for (i = 0; i < dlen; ++i)
+			{
+				d[i] &= x[i];
+			}
 
-		// Multiply the number.
-		bc_num_mulArray(n, base, &mult1);
+			break;
+		}
 
-		// Convert the digit to a number and add.
-		bc_num_bigdig2num(&temp, v);
-		bc_num_add(&mult1, &temp, n, 0);
+		case BC_NUM_BIT_OR:
+		{
+			for (i = 0; i < dlen; ++i)
+			{
+				d[i] |= x[i];
+			}
+
+			break;
+		}
+
+		case BC_NUM_BIT_XOR:
+		{
+			for (i = 0; i < dlen; ++i)
+			{
+				d[i] ^= x[i];
+			}
+
+			break;
+		}
+
+		default:
+		{
+#if BC_DEBUG
+			// These are not operations on two operands.
+			abort();
+#endif // BC_DEBUG
+			break;
+		}
 	}
 
-	// If this condition is true, then we are done. We still need to do cleanup
-	// though.
-	if (i == len && !val[i]) goto int_err;
+	bc_num_bitsSet(c, d, dlen, w);
 
-	// If we get here, we *must* be at the radix point.
-	assert(val[i] == '.');
+err:
+	BC_SIG_MAYLOCK;
+	free(d);
+	BC_LONGJMP_CONT(vm);
+}
 
-	BC_SIG_LOCK;
+/**
+ * Does a not, a reversal, or a rotation of the binary form of @a a in a fixed
+ * width, the way the extended math library does: on the absolute value,
+ * truncated, and reduced modulo the width first.
+ * @param a   The operand.
+ * @param n   The width in bytes.
+ * @param p   The amount to rotate by, or NULL if @a op is not a rotation.
+ * @param c   The return parameter. It must be initialized.
+ * @param op  The operation.
+ */
+static void
+bc_num_bitWidthOp(const BcNum* a, const BcNum* n, const BcNum* p,
+                  BcNum* restrict c, BcNumBitOp op)
+{
+	BcBinDig* d;
+	BcBinDig* r;
+	BcBinDig* res;
+	uint32_t* w;
+	size_t i, bits, rot = 0, rlen, dlen;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// Unset the jump to reset in for these new initializations.
-	BC_UNSETJMP(vm);
+	assert(c != a && c != n && c != p);
 
-	bc_num_init(&mult2, BC_NUM_BIGDIG_LOG10);
-	bc_num_init(&result1, BC_NUM_DEF_SIZE);
-	bc_num_init(&result2, BC_NUM_DEF_SIZE);
-	bc_num_one(&mult1);
+	bits = bc_num_bitWidth(n);
+
+	if (p != NULL) rot = bc_num_bitRot(p, bits);
+
+	rlen = (bits + BC_NUM_BINDIG_BITS - 1) / BC_NUM_BINDIG_BITS;
+	dlen = BC_MAX(rlen, bc_num_binLen(bc_num_int(a)));
+
+	BC_SIG_LOCK;
+
+	// The operand, the result, and the scratch words for conversion go in one
+	// allocation, which is never empty.
+	d = bc_vm_malloc(bc_vm_arraySize(bc_vm_growSize(2 * dlen, rlen + 1),
+	                                 sizeof(BcBinDig)));
 
 	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	// Pointers for easy switching.
-	m1 = &mult1;
-	m2 = &mult2;
-
-	// Parse the fractional part. This is the hard part.
-	for (i += 1, digs = 0; i < len && (c = val[i]); ++i, ++digs)
-	{
-		size_t rdx;
+	r = d + dlen;
+	res = r;
+	w = (uint32_t*) (r + rlen);
 
-		// Convert the character to a digit.
-		v = bc_num_parseChar(c, base);
+	bc_num_bitsGet(a, d, dlen, w);
+	bc_num_bitsMask(d, bits);
 
-		// We keep growing result2 according to the base because the more digits
-		// after the radix, the more significant the digits close to the radix
-		// should be.
-		bc_num_mulArray(&result1, base, &result2);
+	// NOLINTNEXTLINE
+	memset(r, 0, rlen * sizeof(BcBinDig));
 
-		// Convert the digit to a number.
-		bc_num_bigdig2num(&temp, v);
+	// A rotation to the right is a rotation to the left by the rest.
+	if (op == BC_NUM_BIT_ROR && rot) rot = bits - rot;
 
-		// Add the digit into the fraction part.
-		bc_num_add(&result2, &temp, &result1, 0);
+	switch (op)
+	{
+		case BC_NUM_BIT_NOT:
+		{
+			for (i = 0; i < rlen; ++i)
+			{
+				r[i] = ~d[i];
+			}
 
-		// Keep growing m1 and m2 for use after the loop.
-		bc_num_mulArray(m1, base, m2);
+			bc_num_bitsMask(r, bits);
 
-		rdx = BC_NUM_RDX_VAL(m2);
+			break;
+		}
 
-		if (m2->len < rdx) m2->len = rdx;
+		case BC_NUM_BIT_REV:
+		{
+			// Reversing the limbs and their bits reverses all of the limbs;
+			// the reversal of the width is then at the top.
+			for (i = 0; i < rlen; ++i)
+			{
+				r[rlen - 1 - i] = bc_num_bitsRev(d[i]);
+			}
 
-		// Switch.
-		ptr = m1;
-		m1 = m2;
-		m2 = ptr;
-	}
+			// NOLINTNEXTLINE
+			memset(d, 0, rlen * sizeof(BcBinDig));
+			bc_num_bitsShr(d, rlen, r, rlen, rlen * BC_NUM_BINDIG_BITS - bits);
+			res = d;
 
-	// This one cannot be a divide by 0 because mult starts out at 1, then is
-	// multiplied by base, and base cannot be 0, so mult cannot be 0. And this
-	// is the reason we keep growing m1 and m2; this division is what converts
-	// the parsed fractional part from an integer to a fractional part.
-	bc_num_div(&result1, m1, &result2, digs * 2);
+			break;
+		}
 
-	// Pretruncate.
-	bc_num_truncate(&result2, digs);
+		case BC_NUM_BIT_ROL:
+		case BC_NUM_BIT_ROR:
+		{
+			bc_num_bitsShl(r, rlen, d, rlen, rot);
+			bc_num_bitsShr(r, rlen, d, rlen, bits - rot);
+			bc_num_bitsMask(r, bits);
 
-	// The final add of the integer part to the fractional part.
-	bc_num_add(n, &result2, n, digs);
+			break;
+		}
 
-	// Basic cleanup.
-	if (BC_NUM_NONZERO(n))
-	{
-		if (n->scale < digs) bc_num_extend(n, digs - n->scale);
+		default:
+		{
+#if BC_DEBUG
+			// These are not operations on one operand.
+			abort();
+#endif // BC_DEBUG
+			break;
+		}
 	}
-	else bc_num_zero(n);
+
+	bc_num_bitsSet(c, res, rlen, w);
 
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&result2);
-	bc_num_free(&result1);
-	bc_num_free(&mult2);
-int_err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&mult1);
-	bc_num_free(&temp);
+	free(d);
 	BC_LONGJMP_CONT(vm);
 }
 
-/**
- * Prints a backslash+newline combo if the number of characters needs it. This
- * is really a convenience function.
- */
-static inline void
-bc_num_printNewline(void)
+void
+bc_num_band(BcNum* a, BcNum* b, BcNum* c, size_t scale)
 {
-#if !BC_ENABLE_LIBRARY
-	if (vm->nchars >= vm->line_len - 1 && vm->line_len)
-	{
-		bc_vm_putchar('\\', bc_flush_none);
-		bc_vm_putchar('\n', bc_flush_err);
-	}
-#endif // !BC_ENABLE_LIBRARY
+	BC_UNUSED(scale);
+	bc_num_bitLogic(a, b, c, BC_NUM_BIT_AND);
 }
 
-/**
- * Prints a character after a backslash+newline, if needed.
- * @param c       The character to print.
- * @param bslash  Whether to print a backslash+newline.
- */
-static void
-bc_num_putchar(int c, bool bslash)
+void
+bc_num_bor(BcNum* a, BcNum* b, BcNum* c, size_t scale)
 {
-	if (c != '\n' && bslash) bc_num_printNewline();
-	bc_vm_putchar(c, bc_flush_save);
+	BC_UNUSED(scale);
+	bc_num_bitLogic(a, b, c, BC_NUM_BIT_OR);
 }
 
-#if !BC_ENABLE_LIBRARY
-
-/**
- * Prints a character for a number's digit. This is for printing for dc's P
- * command. This function does not need to worry about radix points. This is a
- * BcNumDigitOp.
- * @param n       The "digit" to print.
- * @param len     The "length" of the digit, or number of characters that will
- *                need to be printed for the digit.
- * @param rdx     True if a decimal (radix) point should be printed.
- * @param bslash  True if a backslash+newline should be printed if the character
- *                limit for the line is reached, false otherwise.
- */
-static void
-bc_num_printChar(size_t n, size_t len, bool rdx, bool bslash)
+void
+bc_num_bxor(BcNum* a, BcNum* b, BcNum* c, size_t scale)
 {
-	BC_UNUSED(rdx);
-	BC_UNUSED(len);
-	BC_UNUSED(bslash);
-	assert(len == 1);
-	bc_vm_putchar((uchar) n, bc_flush_save);
+	BC_UNUSED(scale);
+	bc_num_bitLogic(a, b, c, BC_NUM_BIT_XOR);
 }
 
-#endif // !BC_ENABLE_LIBRARY
-
-/**
- * Prints a series of characters for large bases. This is for printing in bases
- * above hexadecimal. This is a BcNumDigitOp.
- * @param n       The "digit" to print.
- * @param len     The "length" of the digit, or number of characters that will
- *                need to be printed for the digit.
- * @param rdx     True if a decimal (radix) point should be printed.
- * @param bslash  True if a backslash+newline should be printed if the character
- *                limit for the line is reached, false otherwise.
- */
-static void
-bc_num_printDigits(size_t n, size_t len, bool rdx, bool bslash)
+void
+bc_num_bnotn(BcNum* a, BcNum* b, BcNum* c, size_t scale)
 {
-	size_t exp, pow;
-
-	// If needed, print the radix; otherwise, print a space to separate digits.
-	bc_num_putchar(rdx ? '.' : ' ', true);
-
-	// Calculate the exponent and power.
-	for (exp = 0, pow = 1; exp < len - 1; ++exp, pow *= BC_BASE)
-	{
-		continue;
-	}
+	BC_UNUSED(scale);
+	bc_num_bitWidthOp(a, b, NULL, c, BC_NUM_BIT_NOT);
+}
 
-	// Print each character individually.
-	for (exp = 0; exp < len; pow /= BC_BASE, ++exp)
-	{
-		// The individual subdigit.
-		size_t dig = n / pow;
+void
+bc_num_brevn(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	BC_UNUSED(scale);
+	bc_num_bitWidthOp(a, b, NULL, c, BC_NUM_BIT_REV);
+}
 
-		// Take the subdigit away.
-		n -= dig * pow;
+void
+bc_num_broln(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d, size_t scale)
+{
+	BC_UNUSED(scale);
+	bc_num_bitWidthOp(a, c, b, d, BC_NUM_BIT_ROL);
+}
 
-		// Print the subdigit.
-		bc_num_putchar(((uchar) dig) + '0', bslash || exp != len - 1);
-	}
+void
+bc_num_brorn(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d, size_t scale)
+{
+	BC_UNUSED(scale);
+	bc_num_bitWidthOp(a, c, b, d, BC_NUM_BIT_ROR);
 }
 
 /**
- * Prints a character for a number's digit. This is for printing in bases for
- * hexadecimal and below because they always print only one character at a time.
- * This is a BcNumDigitOp.
- * @param n       The "digit" to print.
- * @param len     The "length" of the digit, or number of characters that will
- *                need to be printed for the digit.
- * @param rdx     True if a decimal (radix) point should be printed.
- * @param bslash  True if a backslash+newline should be printed if the character
- *                limit for the line is reached, false otherwise.
+ * Multiplies a factor into the last word of a list of factors for
+ * bc_num_prodTree(), or starts a new word with it if it does not fit. Packing
+ * factors into words makes the leaves of the tree as big as they can be.
+ * @param v  The list of words.
+ * @param x  The factor. It must not be zero.
  */
 static void
-bc_num_printHex(size_t n, size_t len, bool rdx, bool bslash)
+bc_num_prodPush(BcVec* restrict v, BcBigDig x)
 {
-	BC_UNUSED(len);
-	BC_UNUSED(bslash);
+	assert(x != 0);
 
-	assert(len == 1);
+	if (v->len)
+	{
+		BcBigDig* acc = bc_vec_top(v);
 
-	if (rdx) bc_num_putchar('.', true);
+		if (*acc <= BC_NUM_BIGDIG_MAX / x)
+		{
+			*acc *= x;
+			return;
+		}
+	}
 
-	bc_num_putchar(bc_num_hex_digits[n], bslash);
+	bc_vec_push(v, &x);
 }
 
 /**
- * Prints a decimal number. This is specially written for optimization since
- * this will be used the most and because bc's numbers are already in decimal.
- * @param n        The number to print.
- * @param newline  Whether to print backslash+newlines on long enough lines.
+ * Multiplies @a len words together with a balanced product tree, so that the
+ * fast multiplication algorithms always get operands of about the same size.
+ * @param w    The words.
+ * @param len  The number of words.
+ * @param r    The return parameter. It must be initialized.
  */
 static void
-bc_num_printDecimal(const BcNum* restrict n, bool newline)
+bc_num_prodTree(const BcBigDig* restrict w, size_t len, BcNum* restrict r)
 {
-	size_t i, j, rdx = BC_NUM_RDX_VAL(n);
-	bool zero = true;
-	size_t buffer[BC_BASE_DIGS];
+	BcNum lo, hi;
+	size_t h;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// Print loop.
-	for (i = n->len - 1; i < n->len; --i)
+	if (len < 2)
 	{
-		BcDig n9 = n->num[i];
-		size_t temp;
-		bool irdx = (i == rdx - 1);
+		if (len) bc_num_bigdig2num(r, w[0]);
+		else bc_num_one(r);
+		return;
+	}
 
-		// Calculate the number of digits in the limb.
-		zero = (zero & !irdx);
-		temp = n->scale % BC_BASE_DIGS;
-		temp = i || !temp ? 0 : BC_BASE_DIGS - temp;
+	h = len / 2;
 
-		// NOLINTNEXTLINE
-		memset(buffer, 0, BC_BASE_DIGS * sizeof(size_t));
+	BC_SIG_LOCK;
 
-		// Fill the buffer with individual digits.
-		for (j = 0; n9 && j < BC_BASE_DIGS; ++j)
-		{
-			buffer[j] = ((size_t) n9) % BC_BASE;
-			n9 /= BC_BASE;
-		}
+	bc_num_init(&lo, BC_NUM_DEF_SIZE);
+	bc_num_init(&hi, BC_NUM_DEF_SIZE);
 
-		// Print the digits in the buffer.
-		for (j = BC_BASE_DIGS - 1; j < BC_BASE_DIGS && j >= temp; --j)
-		{
-			// Figure out whether to print the decimal point.
-			bool print_rdx = (irdx & (j == BC_BASE_DIGS - 1));
+	BC_SETJMP_LOCKED(vm, err);
 
-			// The zero variable helps us skip leading zero digits in the limb.
-			zero = (zero && buffer[j] == 0);
+	BC_SIG_UNLOCK;
 
-			if (!zero)
-			{
-				// While the first three arguments should be self-explanatory,
-				// the last needs explaining. I don't want to print a newline
-				// when the last digit to be printed could take the place of the
-				// backslash rather than being pushed, as a single character, to
-				// the next line. That's what that last argument does for bc.
-				bc_num_printHex(buffer[j], 1, print_rdx,
-				                !newline || (j > temp || i != 0));
-			}
-		}
-	}
-}
+	bc_num_prodTree(w, h, &lo);
+	bc_num_prodTree(w + h, len - h, &hi);
 
-#if BC_ENABLE_EXTRA_MATH
+	bc_num_mul(&lo, &hi, r, 0);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&hi);
+	bc_num_free(&lo);
+	BC_LONGJMP_CONT(vm);
+}
 
 /**
- * Prints a number in scientific or engineering format. When doing this, we are
- * always printing in decimal.
- * @param n        The number to print.
- * @param eng      True if we are in engineering mode.
- * @param newline  Whether to print backslash+newlines on long enough lines.
+ * Multiplies the integers in (@a m, @a n] together.
+ * @param m  One less than the first integer.
+ * @param n  The last integer.
+ * @param r  The return parameter. It must be initialized.
  */
 static void
-bc_num_printExponent(const BcNum* restrict n, bool eng, bool newline)
+bc_num_rangeProd(BcBigDig m, BcBigDig n, BcNum* restrict r)
 {
-	size_t places, mod, nrdx = BC_NUM_RDX_VAL(n);
-	bool neg = (n->len <= nrdx);
-	BcNum temp, exp;
-	BcDig digs[BC_NUM_BIGDIG_LOG10];
+	BcVec v;
+	BcBigDig x;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
 	BC_SIG_LOCK;
 
-	bc_num_createCopy(&temp, n);
+	bc_vec_init(&v, sizeof(BcBigDig), BC_DTOR_NONE);
 
-	BC_SETJMP_LOCKED(vm, exit);
+	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	// We need to calculate the exponents, and they change based on whether the
-	// number is all fractional or not, obviously.
-	if (neg)
+	for (x = n; x > m; --x)
 	{
-		// Figure out how many limbs after the decimal point is zero.
-		size_t i, idx = bc_num_nonZeroLen(n) - 1;
-
-		places = 1;
-
-		// Figure out how much in the last limb is zero.
-		for (i = BC_BASE_DIGS - 1; i < BC_BASE_DIGS; --i)
-		{
-			if (bc_num_pow10[i] > (BcBigDig) n->num[idx]) places += 1;
-			else break;
-		}
-
-		// Calculate the combination of zero limbs and zero digits in the last
-		// limb.
-		places += (nrdx - (idx + 1)) * BC_BASE_DIGS;
-		mod = places % 3;
-
-		// Calculate places if we are in engineering mode.
-		if (eng && mod != 0) places += 3 - mod;
-
-		// Shift the temp to the right place.
-		bc_num_shiftLeft(&temp, places);
+		bc_num_prodPush(&v, x);
 	}
-	else
-	{
-		// This is the number of digits that we are supposed to put behind the
-		// decimal point.
-		places = bc_num_intDigits(n) - 1;
-
-		// Calculate the true number based on whether engineering mode is
-		// activated.
-		mod = places % 3;
-		if (eng && mod != 0) places -= 3 - (3 - mod);
 
-		// Shift the temp to the right place.
-		bc_num_shiftRight(&temp, places);
-	}
+	bc_num_prodTree((BcBigDig*) v.v, v.len, r);
 
-	// Print the shifted number.
-	bc_num_printDecimal(&temp, newline);
+err:
+	BC_SIG_MAYLOCK;
+	bc_vec_free(&v);
+	BC_LONGJMP_CONT(vm);
+}
 
-	// Print the e.
-	bc_num_putchar('e', !newline);
+/**
+ * Returns the power of the prime @a p in the swing factorial of @a m, which is
+ * m! / (floor(m / 2)!)^2. The exponent has a bit for every power of @a p up to
+ * @a m: whether m divided by that power is odd.
+ * @param m  The number whose swing factorial it is.
+ * @param p  The prime.
+ * @return   The power of @a p, which is at most @a m.
+ */
+static BcBigDig
+bc_num_swingPow(BcBigDig m, BcBigDig p)
+{
+	BcBigDig q = m, pe = 1;
 
-	// Need to explicitly print a zero exponent.
-	if (!places)
+	while ((q /= p))
 	{
-		bc_num_printHex(0, 1, false, !newline);
-		goto exit;
+		if (q & 1) pe *= p;
 	}
 
-	// Need to print sign for the exponent.
-	if (neg) bc_num_putchar('-', true);
+	return pe;
+}
 
-	// Create a temporary for the exponent...
-	bc_num_setup(&exp, digs, BC_NUM_BIGDIG_LOG10);
-	bc_num_bigdig2num(&exp, (BcBigDig) places);
+/**
+ * Sieves the odd primes up to @a n.
+ * @param sieve  The return parameter. Index i is for 2 * i + 1, and it is
+ *               zero if that is prime. It must have room for n / 2 + 1 bytes.
+ * @param n      The number to sieve up to.
+ */
+static void
+bc_num_sieve(uchar* restrict sieve, BcBigDig n)
+{
+	size_t i, j, len = (size_t) (n / 2 + 1);
+	BcBigDig p;
 
-	/// ..and print it.
-	bc_num_printDecimal(&exp, newline);
+	// NOLINTNEXTLINE
+	memset(sieve, 0, len);
 
-exit:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&temp);
-	BC_LONGJMP_CONT(vm);
-}
-#endif // BC_ENABLE_EXTRA_MATH
+	for (i = 1, p = 3; p <= n / p; ++i, p += 2)
+	{
+		if (sieve[i]) continue;
 
-/**
- * Takes a number with limbs with base BC_BASE_POW and converts the limb at the
- * given index to base @a pow, where @a pow is obase^N.
- * @param n    The number to convert.
- * @param rem  BC_BASE_POW - @a pow.
- * @param pow  The power of obase we will convert the number to.
- * @param idx  The index of the number to start converting at. Doing the
- *             conversion is O(n^2); we have to sweep through starting at the
- *             least significant limb.
+		for (j = (size_t) (p * p / 2); j < len; j += (size_t) p)
+		{
+			sieve[j] = 1;
+		}
+	}
+}
+
+/**
+ * Computes @a n! with the prime swing algorithm:
+ * n! = (floor(n / 2)!)^2 * swing(n), and the swing factorial of a number is
+ * built from its prime factorization, which is cheap to find. This does a few
+ * big squarings and product trees of primes instead of a product of all of
+ * the numbers up to @a n.
+ * @param n  The number.
+ * @param r  The return parameter. It must be initialized.
  */
 static void
-bc_num_printFixup(BcNum* restrict n, BcBigDig rem, BcBigDig pow, size_t idx)
+bc_num_factorial(BcBigDig n, BcNum* restrict r)
 {
-	size_t i, len = n->len - idx;
-	BcBigDig acc;
-	BcDig* a = n->num + idx;
+	uchar* sieve;
+	BcVec v;
+	BcNum s, t;
+	BcBigDig m, p;
+	size_t i, k = 0;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// Ignore if there's just one limb left. This is the part that requires the
-	// extra loop after the one calling this function in bc_num_printPrepare().
-	if (len < 2) return;
+	BC_SIG_LOCK;
 
-	// Loop through the remaining limbs and convert. We start at the second limb
-	// because we pull the value from the previous one as well.
-	for (i = len - 1; i > 0; --i)
+	sieve = bc_vm_malloc(bc_vm_growSize((size_t) (n / 2), 1));
+	bc_vec_init(&v, sizeof(BcBigDig), BC_DTOR_NONE);
+	bc_num_init(&s, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_sieve(sieve, n);
+
+	for (m = n; m; m >>= 1)
 	{
-		// Get the limb and add it to the previous, along with multiplying by
-		// the remainder because that's the proper overflow. "acc" means
-		// "accumulator," by the way.
-		acc = ((BcBigDig) a[i]) * rem + ((BcBigDig) a[i - 1]);
+		k += 1;
+	}
 
-		// Store a value in base pow in the previous limb.
-		a[i - 1] = (BcDig) (acc % pow);
+	bc_num_one(r);
 
-		// Divide by the base and accumulate the remaining value in the limb.
-		acc /= pow;
-		acc += (BcBigDig) a[i];
+	// Unroll the recursion from the top bit of n down.
+	while (k--)
+	{
+		m = n >> k;
 
-		// If the accumulator is greater than the base...
-		if (acc >= BC_BASE_POW)
-		{
-			// Do we need to grow?
-			if (i == len - 1)
-			{
-				// Grow.
-				len = bc_vm_growSize(len, 1);
-				bc_num_expand(n, bc_vm_growSize(len, idx));
+		bc_vec_popAll(&v);
 
-				// Update the pointer because it may have moved.
-				a = n->num + idx;
+		if (m >= 2) bc_num_prodPush(&v, bc_num_swingPow(m, 2));
 
-				// Zero out the last limb.
-				a[len - 1] = 0;
-			}
+		for (i = 1, p = 3; p <= m; ++i, p += 2)
+		{
+			BcBigDig pe;
 
-			// Overflow into the next limb since we are over the base.
-			a[i + 1] += acc / BC_BASE_POW;
-			acc %= BC_BASE_POW;
+			if (sieve[i]) continue;
+
+			pe = bc_num_swingPow(m, p);
+			if (pe > 1) bc_num_prodPush(&v, pe);
 		}
 
-		assert(acc < BC_BASE_POW);
+		bc_num_prodTree((BcBigDig*) v.v, v.len, &s);
 
-		// Set the limb.
-		a[i] = (BcDig) acc;
+		bc_num_mul(r, r, &t, 0);
+		bc_num_mul(&t, &s, r, 0);
 	}
 
-	// We may have grown the number, so adjust the length.
-	n->len = len + idx;
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&t);
+	bc_num_free(&s);
+	bc_vec_free(&v);
+	free(sieve);
+	BC_LONGJMP_CONT(vm);
 }
 
 /**
- * Prepares a number for printing in a base that does not have BC_BASE_POW as a
- * power. This basically converts the number from having limbs of base
- * BC_BASE_POW to limbs of pow, where pow is obase^N.
- * @param n    The number to prepare for printing.
- * @param rem  The remainder of BC_BASE_POW when divided by a power of the base.
- * @param pow  The power of the base.
+ * Returns the power of the prime @a p in the binomial coefficient of @a n and
+ * @a k. By Kummer's theorem, the exponent is the number of carries when adding
+ * @a k and @a n - @a k in base @a p, and every carry is a power of @a p up to
+ * @a n that divides n less often than it divides the two parts together.
+ * @param n  The number of items.
+ * @param k  The number of items to choose. It must be at most @a n.
+ * @param p  The prime.
+ * @return   The power of @a p, which is at most @a n.
+ */
+static BcBigDig
+bc_num_binomialPow(BcBigDig n, BcBigDig k, BcBigDig p)
+{
+	BcBigDig q = n, a = k, b = n - k, pe = 1;
+
+	while ((q /= p))
+	{
+		a /= p;
+		b /= p;
+
+		if (q != a + b) pe *= p;
+	}
+
+	return pe;
+}
+
+/**
+ * Computes the binomial coefficient of @a n and @a k from its prime
+ * factorization. There is no division, and the products are never bigger than
+ * the result.
+ * @param n  The number of items.
+ * @param k  The number of items to choose. It must be at most @a n.
+ * @param r  The return parameter. It must be initialized.
  */
 static void
-bc_num_printPrepare(BcNum* restrict n, BcBigDig rem, BcBigDig pow)
+bc_num_binomial(BcBigDig n, BcBigDig k, BcNum* restrict r)
 {
+	uchar* sieve;
+	BcVec v;
+	BcBigDig p, pe;
 	size_t i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// Loop from the least significant limb to the most significant limb and
-	// convert limbs in each pass.
-	for (i = 0; i < n->len; ++i)
+	BC_SIG_LOCK;
+
+	sieve = bc_vm_malloc(bc_vm_growSize((size_t) (n / 2), 1));
+	bc_vec_init(&v, sizeof(BcBigDig), BC_DTOR_NONE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_sieve(sieve, n);
+
+	if (n >= 2)
 	{
-		bc_num_printFixup(n, rem, pow, i);
+		pe = bc_num_binomialPow(n, k, 2);
+		if (pe > 1) bc_num_prodPush(&v, pe);
 	}
 
-	// bc_num_printFixup() does not do everything it is supposed to, so we do
-	// the last bit of cleanup here. That cleanup is to ensure that each limb
-	// is less than pow and to expand the number to fit new limbs as necessary.
-	for (i = 0; i < n->len; ++i)
+	for (i = 1, p = 3; p <= n; ++i, p += 2)
 	{
-		assert(pow == ((BcBigDig) ((BcDig) pow)));
+		if (sieve[i]) continue;
 
-		// If the limb needs fixing...
-		if (n->num[i] >= (BcDig) pow)
-		{
-			// Do we need to grow?
-			if (i + 1 == n->len)
-			{
-				// Grow the number.
-				n->len = bc_vm_growSize(n->len, 1);
-				bc_num_expand(n, n->len);
+		pe = bc_num_binomialPow(n, k, p);
+		if (pe > 1) bc_num_prodPush(&v, pe);
+	}
 
-				// Without this, we might use uninitialized data.
-				n->num[i + 1] = 0;
-			}
+	bc_num_prodTree((BcBigDig*) v.v, v.len, r);
 
-			assert(pow < BC_BASE_POW);
+err:
+	BC_SIG_MAYLOCK;
+	bc_vec_free(&v);
+	free(sieve);
+	BC_LONGJMP_CONT(vm);
+}
 
-			// Overflow into the next limb.
-			n->num[i + 1] += n->num[i] / ((BcDig) pow);
-			n->num[i] %= (BcDig) pow;
-		}
+void
+bc_num_fact(BcNum* restrict a, BcNum* restrict b, size_t scale)
+{
+	BcNum v;
+
+	BC_UNUSED(scale);
+
+	bc_num_intView(a, &v);
+
+	bc_num_factorial(bc_num_bigdig(&v), b);
+}
+
+void
+bc_num_perm(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	BcNum v;
+	BcBigDig n, k, m;
+
+	BC_UNUSED(scale);
+
+	// Like the library, this compares before taking the absolute values.
+	if (bc_num_cmp(b, a) > 0)
+	{
+		bc_num_zero(c);
+		return;
 	}
+
+	bc_num_intView(a, &v);
+	n = bc_num_bigdig(&v);
+	bc_num_intView(b, &v);
+	k = bc_num_bigdig(&v);
+
+	// The library computes n! / |n - k|!, truncated. That is the product of
+	// the numbers after |n - k|, or zero if there are none.
+	m = n > k ? n - k : k - n;
+
+	if (m > n) bc_num_zero(c);
+	else bc_num_rangeProd(m, n, c);
 }
 
-static void
-bc_num_printNum(BcNum* restrict n, BcBigDig base, size_t len,
-                BcNumDigitOp print, bool newline)
+void
+bc_num_comb(BcNum* a, BcNum* b, BcNum* c, size_t scale)
 {
-	BcVec stack;
-	BcNum intp, fracp1, fracp2, digit, flen1, flen2;
-	BcNum* n1;
-	BcNum* n2;
-	BcNum* temp;
-	BcBigDig dig = 0, acc, exp;
-	BcBigDig* ptr;
-	size_t i, j, nrdx, idigits;
-	bool radix;
-	BcDig digit_digs[BC_NUM_BIGDIG_LOG10 + 1];
+	BcNum v, t, u;
+	BcBigDig n, r, k;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	assert(base > 1);
+	BC_UNUSED(scale);
 
-	// Easy case. Even with scale, we just print this.
-	if (BC_NUM_ZERO(n))
+	// Like the library, this compares before taking the absolute values.
+	if (bc_num_cmp(b, a) > 0)
 	{
-		print(0, len, false, !newline);
+		bc_num_zero(c);
 		return;
 	}
 
-	// This function uses an algorithm that Stefan Esser <se@freebsd.org> came
-	// up with to print the integer part of a number. What it does is convert
-	// intp into a number of the specified base, but it does it directly,
-	// instead of just doing a series of divisions and printing the remainders
-	// in reverse order.
-	//
-	// Let me explain in a bit more detail:
-	//
-	// The algorithm takes the current least significant limb (after intp has
-	// been converted to an integer) and the next to least significant limb, and
-	// it converts the least significant limb into one of the specified base,
-	// putting any overflow into the next to least significant limb. It iterates
-	// through the whole number, from least significant to most significant,
-	// doing this conversion. At the end of that iteration, the least
-	// significant limb is converted, but the others are not, so it iterates
-	// again, starting at the next to least significant limb. It keeps doing
-	// that conversion, skipping one more limb than the last time, until all
-	// limbs have been converted. Then it prints them in reverse order.
-	//
-	// That is the gist of the algorithm. It leaves out several things, such as
-	// the fact that limbs are not always converted into the specified base, but
-	// into something close, basically a power of the specified base. In
-	// Stefan's words, "You could consider BcDigs to be of base 10^BC_BASE_DIGS
-	// in the normal case and obase^N for the largest value of N that satisfies
-	// obase^N <= 10^BC_BASE_DIGS. [This means that] the result is not in base
-	// "obase", but in base "obase^N", which happens to be printable as a number
-	// of base "obase" without consideration for neighbouring BcDigs." This fact
-	// is what necessitates the existence of the loop later in this function.
-	//
-	// The conversion happens in bc_num_printPrepare() where the outer loop
-	// happens and bc_num_printFixup() where the inner loop, or actual
-	// conversion, happens. In other words, bc_num_printPrepare() is where the
-	// loop that starts at the least significant limb and goes to the most
-	// significant limb. Then, on every iteration of its loop, it calls
-	// bc_num_printFixup(), which has the inner loop of actually converting
-	// the limbs it passes into limbs of base obase^N rather than base
-	// BC_BASE_POW.
+	bc_num_intView(a, &v);
+	n = bc_num_bigdig(&v);
+	bc_num_intView(b, &v);
+	r = bc_num_bigdig(&v);
 
-	nrdx = BC_NUM_RDX_VAL(n);
+	// The library computes n! / (r! * |n - r|!), truncated, which is zero when
+	// r is bigger than n.
+	if (r > n)
+	{
+		bc_num_zero(c);
+		return;
+	}
 
-	BC_SIG_LOCK;
+	k = BC_MIN(r, n - r);
 
-	// The stack is what allows us to reverse the digits for printing.
-	bc_vec_init(&stack, sizeof(BcBigDig), BC_DTOR_NONE);
-	bc_num_init(&fracp1, nrdx);
+	// The factorization needs a sieve up to n, so when the other side is much
+	// smaller, it is cheaper to divide its factorial out of a short product.
+	if (n / BC_NUM_COMB_SIEVE_RATIO <= k)
+	{
+		bc_num_binomial(n, k, c);
+		return;
+	}
 
-	// intp will be the "integer part" of the number, so copy it.
-	bc_num_createCopy(&intp, n);
+	BC_SIG_LOCK;
+
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
 
 	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	// Make intp an integer.
-	bc_num_truncate(&intp, intp.scale);
+	// The division is exact.
+	bc_num_rangeProd(n - k, n, &t);
+	bc_num_factorial(k, &u);
+	bc_num_div(&t, &u, c, 0);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&u);
+	bc_num_free(&t);
+	BC_LONGJMP_CONT(vm);
+}
+#endif // BC_ENABLE_EXTRA_MATH
+
+void
+bc_num_divmod(BcNum* a, BcNum* b, BcNum* c, BcNum* d, size_t scale)
+{
+	size_t ts, len;
+	BcNum *ptr_a, num2;
+	// This is volatile to quiet a warning on GCC about clobbering with
+	// longjmp().
+	volatile bool init = false;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	// The bulk of this function is just doing what bc_num_binary() does for the
+	// binary operators. However, it assumes that only c and a can be equal.
+
+	// Set up the parameters.
+	ts = BC_MAX(scale + b->scale, a->scale);
+	len = bc_num_mulReq(a, b, ts);
+
+	assert(a != NULL && b != NULL && c != NULL && d != NULL);
+	assert(c != d && a != d && b != d && b != c);
+
+	// Initialize or expand as necessary.
+	if (c == a)
+	{
+		// NOLINTNEXTLINE
+		memcpy(&num2, c, sizeof(BcNum));
+		ptr_a = &num2;
+
+		BC_SIG_LOCK;
+
+		bc_num_init(c, len);
+
+		init = true;
 
-	// Get the fractional part out.
-	bc_num_sub(n, &intp, &fracp1, 0);
+		BC_SETJMP_LOCKED(vm, err);
 
-	// If the base is not the same as the last base used for printing, we need
-	// to update the cached exponent and power. Yes, we cache the values of the
-	// exponent and power. That is to prevent us from calculating them every
-	// time because printing will probably happen multiple times on the same
-	// base.
-	if (base != vm->last_base)
+		BC_SIG_UNLOCK;
+	}
+	else
 	{
-		vm->last_pow = 1;
-		vm->last_exp = 0;
+		ptr_a = a;
+		bc_num_expand(c, len);
+	}
 
-		// Calculate the exponent and power.
-		while (vm->last_pow * base <= BC_BASE_POW)
-		{
-			vm->last_pow *= base;
-			vm->last_exp += 1;
-		}
+	// Do the quick version if possible.
+	if (BC_NUM_NONZERO(a) && !BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b) &&
+	    b->len == 1 && !scale)
+	{
+		BcBigDig rem;
 
-		// Also, the remainder and base itself.
-		vm->last_rem = BC_BASE_POW - vm->last_pow;
-		vm->last_base = base;
+		bc_num_divArray(ptr_a, (BcBigDig) b->num[0], c, &rem);
+
+		assert(rem < BC_BASE_POW);
+
+		d->num[0] = (BcDig) rem;
+		d->len = (rem != 0);
 	}
+	// Do the slow method.
+	else bc_num_r(ptr_a, b, c, d, scale, ts);
 
-	exp = vm->last_exp;
+	assert(!BC_NUM_NEG(c) || BC_NUM_NONZERO(c));
+	assert(BC_NUM_RDX_VALID(c));
+	assert(BC_NUM_RDX_VAL(c) <= c->len || !c->len);
+	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
+	assert(!BC_NUM_NEG(d) || BC_NUM_NONZERO(d));
+	assert(BC_NUM_RDX_VALID(d));
+	assert(BC_NUM_RDX_VAL(d) <= d->len || !d->len);
+	assert(!d->len || d->num[d->len - 1] || BC_NUM_RDX_VAL(d) == d->len);
 
-	// If vm->last_rem is 0, then the base we are printing in is a divisor of
-	// BC_BASE_POW, which is the easy case because it means that BC_BASE_POW is
-	// a power of obase, and no conversion is needed. If it *is* 0, then we have
-	// the hard case, and we have to prepare the number for the base.
-	if (vm->last_rem != 0)
+err:
+	// Only cleanup if we initialized.
+	if (init)
 	{
-		bc_num_printPrepare(&intp, vm->last_rem, vm->last_pow);
+		BC_SIG_MAYLOCK;
+		bc_num_free(&num2);
+		BC_LONGJMP_CONT(vm);
 	}
+}
 
-	// After the conversion comes the surprisingly easy part. From here on out,
-	// this is basically naive code that I wrote, adjusted for the larger bases.
+/**
+ * Returns -1/@a m0 modulo BC_BASE_POW, which is what Montgomery reduction needs
+ * from the bottom limb of the modulus. @a m0 must be coprime to BC_BASE_POW.
+ * @param m0  The bottom limb of the modulus.
+ * @return    The negated inverse of @a m0.
+ */
+static BcBigDig
+bc_num_montInv(BcBigDig m0)
+{
+	int64_t r0 = BC_BASE_POW, r1 = (int64_t) m0, t0 = 0, t1 = 1, q, x;
 
-	// Fill the stack of digits for the integer part.
-	for (i = 0; i < intp.len; ++i)
+	// This is the extended Euclidean algorithm. Everything is small.
+	while (r1)
 	{
-		// Get the limb.
-		acc = (BcBigDig) intp.num[i];
+		q = r0 / r1;
 
-		// Turn the limb into digits of base obase.
-		for (j = 0; j < exp && (i < intp.len - 1 || acc != 0); ++j)
-		{
-			// This condition is true if we are not at the last digit.
-			if (j != exp - 1)
-			{
-				dig = acc % base;
-				acc /= base;
-			}
-			else
-			{
-				dig = acc;
-				acc = 0;
-			}
+		x = r0 - q * r1;
+		r0 = r1;
+		r1 = x;
 
-			assert(dig < base);
+		x = t0 - q * t1;
+		t0 = t1;
+		t1 = x;
+	}
 
-			// Push the digit onto the stack.
-			bc_vec_push(&stack, &dig);
-		}
+	assert(r0 == 1);
 
-		assert(acc == 0);
-	}
+	if (t0 < 0) t0 += BC_BASE_POW;
 
-	// Go through the stack backwards and print each digit.
-	for (i = 0; i < stack.len; ++i)
-	{
-		ptr = bc_vec_item_rev(&stack, i);
+	return (BcBigDig) (BC_BASE_POW - t0);
+}
 
-		assert(ptr != NULL);
+/**
+ * Sets up the data for reducing modulo @a m in @a mod. It does not touch
+ * @a mod->m.
+ * @param m    The modulus. It must be a positive integer.
+ * @param mod  The modulus data. @a mod->c must be initialized.
+ */
+static void
+bc_num_modInit(BcNum* m, BcNumMod* restrict mod)
+{
+	BcNum p, q, r;
+	BcBigDig m0;
+	size_t len;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-		// While the first three arguments should be self-explanatory, the last
-		// needs explaining. I don't want to print a backslash+newline when the
-		// last digit to be printed could take the place of the backslash rather
-		// than being pushed, as a single character, to the next line. That's
-		// what that last argument does for bc.
-		//
-		// First, it needs to check if newlines are completely disabled. If they
-		// are not disabled, it needs to check the next part.
-		//
-		// If the number has a scale, then because we are printing just the
-		// integer part, there will be at least two more characters (a radix
-		// point plus at least one digit). So if there is a scale, a backslash
-		// is necessary.
-		//
-		// Finally, the last condition checks to see if we are at the end of the
-		// stack. If we are *not* (i.e., the index is not one less than the
-		// stack length), then a backslash is necessary because there is at
-		// least one more character for at least one more digit). Otherwise, if
-		// the index is equal to one less than the stack length, we want to
-		// disable backslash printing.
-		//
-		// The function that prints bases 17 and above will take care of not
-		// printing a backslash in the right case.
-		print(*ptr, len, false,
-		      !newline || (n->scale != 0 || i < stack.len - 1));
+	assert(BC_NUM_NONZERO(m) && !BC_NUM_NEG(m) && !BC_NUM_RDX_VAL(m));
+
+	m0 = (BcBigDig) m->num[0];
+
+	// Montgomery reduction needs the inverse of the modulus modulo the limb
+	// base, and it is quadratic, so it is only for small moduli.
+	if (m->len < BC_NUM_BARRETT_LEN && (m0 & 1) && m0 % 5)
+	{
+		mod->minv = bc_num_montInv(m0);
 	}
+	else mod->minv = 0;
 
-	// We are done if there is no fractional part.
-	if (!n->scale) goto err;
+	// Division does not need anything.
+	if (!mod->minv && m->len < BC_NUM_BARRETT_LEN) return;
 
-	BC_SIG_LOCK;
+	len = bc_vm_growSize(bc_vm_growSize(m->len, m->len), 1);
 
-	// Reset the jump because some locals are changing.
-	BC_UNSETJMP(vm);
+	BC_SIG_LOCK;
 
-	bc_num_init(&fracp2, nrdx);
-	bc_num_setup(&digit, digit_digs, sizeof(digit_digs) / sizeof(BcDig));
-	bc_num_init(&flen1, BC_NUM_BIGDIG_LOG10);
-	bc_num_init(&flen2, BC_NUM_BIGDIG_LOG10);
+	bc_num_init(&p, len);
+	bc_num_init(&q, len);
+	bc_num_init(&r, m->len);
 
-	BC_SETJMP_LOCKED(vm, frac_err);
+	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	bc_num_one(&flen1);
+	// Both constants come from dividing BC_BASE_POW^(2*m.len) by the modulus.
+	// NOLINTNEXTLINE
+	memset(p.num, 0, BC_NUM_SIZE(len - 1));
+	p.num[len - 1] = 1;
+	p.len = len;
 
-	radix = true;
+	bc_num_divInt(&p, m, &q, &r);
 
-	// Pointers for easy switching.
-	n1 = &flen1;
-	n2 = &flen2;
+	bc_num_copy(&mod->c, mod->minv ? &r : &q);
 
-	fracp2.scale = n->scale;
-	BC_NUM_RDX_SET_NP(fracp2, BC_NUM_RDX(fracp2.scale));
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&r);
+	bc_num_free(&q);
+	bc_num_free(&p);
+	BC_LONGJMP_CONT(vm);
+}
 
-	// As long as we have not reached the scale of the number, keep printing.
-	while ((idigits = bc_num_intDigits(n1)) <= n->scale)
+/**
+ * Returns the data for reducing modulo @a m. The data for the last modulus is
+ * cached in the VM, so repeated work with the same modulus only does the setup
+ * once.
+ * @param m  The modulus. It must be a positive integer.
+ * @return   The modulus data for @a m.
+ */
+static BcNumMod*
+bc_num_modGet(BcNum* m)
+{
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	if (bc_num_cmp(&vm->mod.m, m))
 	{
-		// These numbers will keep growing.
-		bc_num_expand(&fracp2, fracp1.len + 1);
-		bc_num_mulArray(&fracp1, base, &fracp2);
+		// The old modulus is thrown out first, so that data that was
+		// interrupted is never matched.
+		bc_num_zero(&vm->mod.m);
 
-		nrdx = BC_NUM_RDX_VAL_NP(fracp2);
+		bc_num_modInit(m, &vm->mod);
 
-		// Ensure an invariant.
-		if (fracp2.len < nrdx) fracp2.len = nrdx;
+		bc_num_copy(&vm->mod.m, m);
+	}
 
-		// fracp is guaranteed to be non-negative and small enough.
-		dig = bc_num_bigdig2(&fracp2);
+	return &vm->mod;
+}
 
-		// Convert the digit to a number and subtract it from the number.
-		bc_num_bigdig2num(&digit, dig);
-		bc_num_sub(&fracp2, &digit, &fracp1, 0);
+/**
+ * Reduces the non-negative integer @a x, which must be less than
+ * @a m * BC_BASE_POW^(m->len), with Montgomery reduction in place. In other
+ * words, @a x is set to @a x / BC_BASE_POW^(m->len) modulo @a m. This is one
+ * fused pass per limb of the modulus, which is much cheaper than dividing.
+ * @param x     The number to reduce.
+ * @param m     The modulus. It must be coprime to BC_BASE_POW.
+ * @param minv  -1/@a m modulo BC_BASE_POW.
+ */
+static void
+bc_num_redc(BcNum* restrict x, const BcNum* restrict m, BcBigDig minv)
+{
+	size_t i, j, n = m->len, len;
+	BcDig* a;
 
-		// While the first three arguments should be self-explanatory, the last
-		// needs explaining. I don't want to print a newline when the last digit
-		// to be printed could take the place of the backslash rather than being
-		// pushed, as a single character, to the next line. That's what that
-		// last argument does for bc.
-		print(dig, len, radix, !newline || idigits != n->scale);
+	assert(x->len <= 2 * n && !BC_NUM_NEG(x) && !BC_NUM_RDX_VAL(x));
 
-		// Update the multipliers.
-		bc_num_mulArray(n1, base, n2);
+	// The sum never needs more than one extra limb.
+	len = bc_vm_growSize(bc_vm_growSize(n, n), 1);
 
-		radix = false;
+	bc_num_expand(x, len);
 
-		// Switch.
-		temp = n1;
-		n1 = n2;
-		n2 = temp;
+	a = x->num;
+
+	// NOLINTNEXTLINE
+	memset(a + x->len, 0, BC_NUM_SIZE(len - x->len));
+
+	// Add the multiple of the modulus that clears the bottom limb, one limb at
+	// a time. None of these overflow because each limb and the carry are less
+	// than BC_BASE_POW.
+	for (i = 0; i < n; ++i)
+	{
+		BcBigDig u = ((BcBigDig) a[i] * minv) % BC_BASE_POW;
+		BcBigDig carry = 0;
+
+		for (j = 0; j < n; ++j)
+		{
+			BcBigDig t = (BcBigDig) a[i + j] + u * (BcBigDig) m->num[j] + carry;
+
+			a[i + j] = (BcDig) (t % BC_BASE_POW);
+			carry = t / BC_BASE_POW;
+		}
+
+		for (j = i + n; carry; ++j)
+		{
+			BcBigDig t = (BcBigDig) a[j] + carry;
+
+			a[j] = (BcDig) (t % BC_BASE_POW);
+			carry = t / BC_BASE_POW;
+		}
 	}
 
-frac_err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&flen2);
-	bc_num_free(&flen1);
-	bc_num_free(&fracp2);
-err:
-	BC_SIG_MAYLOCK;
-	bc_num_free(&fracp1);
-	bc_num_free(&intp);
-	bc_vec_free(&stack);
-	BC_LONGJMP_CONT(vm);
+	// Now the bottom limbs are all zero, so divide by shifting.
+	// NOLINTNEXTLINE
+	memmove(a, a + n, BC_NUM_SIZE(n + 1));
+
+	x->len = n + 1;
+	bc_num_clean(x);
+
+	// The result is less than twice the modulus.
+	if (bc_num_cmp(x, m) >= 0)
+	{
+		bc_num_subArrays(x->num, m->num, n);
+		bc_num_clean(x);
+	}
 }
 
 /**
- * Prints a number in the specified base, or rather, figures out which function
- * to call to print the number in the specified base and calls it.
- * @param n        The number to print.
- * @param base     The base to print in.
- * @param newline  Whether to print backslash+newlines on long enough lines.
+ * Reduces the non-negative integer @a x modulo @a m in place with Barrett
+ * reduction. @a x must be less than BC_BASE_POW^(2 * m->len). The quotient
+ * that @a mu gives is never too big and at most two too small, so at most two
+ * subtractions fix up the remainder.
+ * @param x   The number to reduce.
+ * @param m   The modulus. It must be a positive integer.
+ * @param mu  floor(BC_BASE_POW^(2 * m->len) / @a m).
+ * @param s   A scratch number. It must be initialized.
+ * @param u   Another scratch number. It must be initialized.
  */
 static void
-bc_num_printBase(BcNum* restrict n, BcBigDig base, bool newline)
+bc_num_barrett(BcNum* restrict x, BcNum* m, BcNum* mu, BcNum* restrict s,
+               BcNum* restrict u)
 {
-	size_t width;
-	BcNumDigitOp print;
-	bool neg = BC_NUM_NEG(n);
+	BcNum q;
+	size_t n = m->len;
 
-	// Clear the sign because it makes the actual printing easier when we have
-	// to do math.
-	BC_NUM_NEG_CLR(n);
+	assert(x->len <= 2 * n && !BC_NUM_NEG(x) && !BC_NUM_RDX_VAL(x));
 
-	// Bases at hexadecimal and below are printed as one character, larger bases
-	// are printed as a series of digits separated by spaces.
-	if (base <= BC_NUM_MAX_POSIX_IBASE)
-	{
-		width = 1;
-		print = bc_num_printHex;
-	}
-	else
-	{
-		assert(base <= BC_BASE_POW);
-		width = bc_num_log10(base - 1);
-		print = bc_num_printDigits;
-	}
+	if (bc_num_cmp(x, m) < 0) return;
 
-	// Print.
-	bc_num_printNum(n, base, width, print, newline);
+	// This is the quotient estimate, floor(floor(x / β^(n-1)) * mu / β^(n+1)).
+	bc_num_view(x, n - 1, x->len, &q);
+	bc_num_mul(&q, mu, s, 0);
+	bc_num_view(s, n + 1, s->len, &q);
+	bc_num_mul(&q, m, u, 0);
 
-	// Reset the sign.
-	n->rdx = BC_NUM_NEG_VAL(n, neg);
-}
+	assert(bc_num_cmp(u, x) <= 0);
 
-#if !BC_ENABLE_LIBRARY
+	bc_num_subArrays(x->num, u->num, u->len);
+	bc_num_clean(x);
 
-void
-bc_num_stream(BcNum* restrict n)
-{
-	bc_num_printNum(n, BC_NUM_STREAM_BASE, 1, bc_num_printChar, false);
+	while (bc_num_cmp(x, m) >= 0)
+	{
+		bc_num_subArrays(x->num, m->num, m->len);
+		bc_num_clean(x);
+	}
 }
 
-#endif // !BC_ENABLE_LIBRARY
-
-void
-bc_num_setup(BcNum* restrict n, BcDig* restrict num, size_t cap)
+/**
+ * Reduces the product @a x of two reduced numbers in place with whatever
+ * reduction @a mod is set up for. With Montgomery reduction, @a x and the
+ * result are in Montgomery form.
+ * @param x    The number to reduce.
+ * @param mod  The modulus data.
+ * @param s    A scratch number. It must be initialized.
+ * @param u    Another scratch number. It must be initialized.
+ */
+static void
+bc_num_modReduce(BcNum* restrict x, BcNumMod* mod, BcNum* restrict s,
+                 BcNum* restrict u)
 {
-	assert(n != NULL);
-	n->num = num;
-	n->cap = cap;
-	bc_num_zero(n);
+	if (mod->minv) bc_num_redc(x, &mod->m, mod->minv);
+	else if (mod->m.len >= BC_NUM_BARRETT_LEN)
+	{
+		bc_num_barrett(x, &mod->m, &mod->c, s, u);
+	}
+	else if (bc_num_cmp(x, &mod->m) >= 0)
+	{
+		bc_num_divInt(x, &mod->m, s, u);
+		bc_num_copy(x, u);
+	}
 }
 
-void
-bc_num_init(BcNum* restrict n, size_t req)
+/**
+ * Returns the number of bits to use for the windows of modular exponentiation
+ * with an exponent of @a bits bits. Bigger windows mean fewer multiplications
+ * during the scan, but more precomputed powers.
+ * @param bits  The number of bits in the exponent.
+ * @return      The window size in bits.
+ */
+static size_t
+bc_num_modexpWindow(size_t bits)
 {
-	BcDig* num;
-
-	BC_SIG_ASSERT_LOCKED;
-
-	assert(n != NULL);
-
-	// BC_NUM_DEF_SIZE is set to be about the smallest allocation size that
-	// malloc() returns in practice, so just use it.
-	req = req >= BC_NUM_DEF_SIZE ? req : BC_NUM_DEF_SIZE;
+	static const size_t limits[] = { 7, 36, 140, 450, 1303, 3529 };
+	size_t k;
 
-	// If we can't use a temp, allocate.
-	if (req != BC_NUM_DEF_SIZE) num = bc_vm_malloc(BC_NUM_SIZE(req));
-	else
+	for (k = 0; k < sizeof(limits) / sizeof(size_t) && bits > limits[k]; ++k)
 	{
-		num = bc_vm_getTemp() == NULL ? bc_vm_malloc(BC_NUM_SIZE(req)) :
-		                                bc_vm_takeTemp();
+		continue;
 	}
 
-	bc_num_setup(n, num, req);
+	return k + 1;
 }
 
-void
-bc_num_clear(BcNum* restrict n)
+/**
+ * Returns bit @a i of the little-endian binary words @a w.
+ * @param w  The words.
+ * @param i  The index of the bit.
+ * @return   The bit.
+ */
+static size_t
+bc_num_bit(const uint32_t* w, size_t i)
 {
-	n->num = NULL;
-	n->cap = 0;
+	return (w[i / BC_NUM_BIN_BITS] >> (i % BC_NUM_BIN_BITS)) & 1;
 }
 
-void
-bc_num_free(void* num)
+/**
+ * Finds the window of the exponent of modular exponentiation whose top bit is
+ * bit @a i, for a scan from the top. A window that is not just a zero bit ends
+ * in a one bit, so it picks one of the precomputed odd powers.
+ * @param w  The bits of the exponent.
+ * @param i  The index of the top bit of the window.
+ * @param k  The window size in bits.
+ * @param l  The return parameter for the index of the bottom bit.
+ * @return   The value of the window, or 0 if bit @a i is 0, in which case the
+ *           window is just that bit.
+ */
+static size_t
+bc_num_modexpWin(const uint32_t* w, size_t i, size_t k, size_t* l)
 {
-	BcNum* n = (BcNum*) num;
+	size_t j, val;
 
-	BC_SIG_ASSERT_LOCKED;
+	*l = i;
 
-	assert(n != NULL);
+	if (!bc_num_bit(w, i)) return 0;
 
-	if (n->cap == BC_NUM_DEF_SIZE) bc_vm_addTemp(n->num);
-	else free(n->num);
+	*l = i >= k - 1 ? i - (k - 1) : 0;
+
+	while (!bc_num_bit(w, *l))
+	{
+		*l += 1;
+	}
+
+	for (val = 0, j = i + 1; j > *l; --j)
+	{
+		val = (val << 1) | bc_num_bit(w, j - 1);
+	}
+
+	return val;
 }
 
-void
-bc_num_copy(BcNum* d, const BcNum* s)
+/**
+ * Does modular exponentiation for a one-limb modulus with native integers. Two
+ * limbs, and therefore the product of two residues, always fit in a BcBigDig.
+ * @param a     The base. It must be a non-negative integer.
+ * @param w     The bits of the exponent.
+ * @param bits  The number of bits in the exponent.
+ * @param m     The modulus.
+ * @return      @a a^e mod @a m, where e is the exponent.
+ */
+static BcBigDig
+bc_num_modexpDig(const BcNum* restrict a, const uint32_t* restrict w,
+                 size_t bits, BcBigDig m)
 {
-	assert(d != NULL && s != NULL);
+	BcBigDig x = 0, y = 1;
+	size_t i;
 
-	if (d == s) return;
+	for (i = a->len - 1; i < a->len; --i)
+	{
+		x = (x * BC_BASE_POW + (BcBigDig) a->num[i]) % m;
+	}
 
-	bc_num_expand(d, s->len);
-	d->len = s->len;
+	for (i = bits - 1; i < bits; --i)
+	{
+		y = (y * y) % m;
+		if (bc_num_bit(w, i)) y = (y * x) % m;
+	}
 
-	// I can just copy directly here because the sign *and* rdx will be
-	// properly preserved.
-	d->rdx = s->rdx;
-	d->scale = s->scale;
-	// NOLINTNEXTLINE
-	memcpy(d->num, s->num, BC_NUM_SIZE(d->len));
+	return y;
 }
 
-void
-bc_num_createCopy(BcNum* d, const BcNum* s)
-{
-	BC_SIG_ASSERT_LOCKED;
-	bc_num_init(d, s->len);
-	bc_num_copy(d, s);
-}
+#if BC_NUM_BINARY
 
-void
-bc_num_createFromBigdig(BcNum* restrict n, BcBigDig val)
+/**
+ * Returns -1/@a m0 modulo 2^BC_NUM_BINDIG_BITS, for Montgomery reduction in
+ * binary.
+ * @param m0  The bottom limb of the modulus. It must be odd.
+ * @return    -1/@a m0 modulo 2^BC_NUM_BINDIG_BITS.
+ */
+static BcBinDig
+bc_num_binMinv(BcBinDig m0)
 {
-	BC_SIG_ASSERT_LOCKED;
-	bc_num_init(n, BC_NUM_BIGDIG_LOG10);
-	bc_num_bigdig2num(n, val);
-}
+	// An odd number is its own inverse modulo 8, and every Newton step doubles
+	// the number of correct bits.
+	BcBinDig x = m0;
+	size_t i;
 
-size_t
-bc_num_scale(const BcNum* restrict n)
-{
-	return n->scale;
+	assert(m0 & 1);
+
+	for (i = 3; i < BC_NUM_BINDIG_BITS; i *= 2)
+	{
+		x *= 2 - m0 * x;
+	}
+
+	return ((BcBinDig) 0) - x;
 }
 
-size_t
-bc_num_len(const BcNum* restrict n)
+/**
+ * Multiplies @a a and @a b, which are in Montgomery form in binary, and reduces
+ * the product in the same pass, so the result is in Montgomery form too. This
+ * is the coarsely integrated operand scanning method; it is quadratic, but
+ * every step is a native product of two binary limbs.
+ * @param r     The return parameter; @a n limbs. It may be @a a or @a b.
+ * @param a     The first operand; @a n limbs, less than @a m.
+ * @param b     The second operand; @a n limbs, less than @a m.
+ * @param m     The modulus; @a n limbs. It must be odd.
+ * @param n     The number of limbs.
+ * @param minv  -1/m modulo 2^BC_NUM_BINDIG_BITS.
+ * @param t     Scratch space with room for @a n + 2 limbs.
+ */
+static void
+bc_num_binMontMul(BcBinDig* r, const BcBinDig* a, const BcBinDig* b,
+                  const BcBinDig* restrict m, size_t n, BcBinDig minv,
+                  BcBinDig* restrict t)
 {
-	size_t len = n->len;
+	BcBinProd p;
+	BcBinDig u, carry, x, y;
+	size_t i, j;
 
-	// Always return at least 1.
-	if (BC_NUM_ZERO(n)) return n->scale ? n->scale : 1;
+	// NOLINTNEXTLINE
+	memset(t, 0, (n + 2) * sizeof(BcBinDig));
 
-	// If this is true, there is no integer portion of the number.
-	if (BC_NUM_RDX_VAL(n) == len)
+	for (i = 0; i < n; ++i)
 	{
-		// We have to take into account the fact that some of the digits right
-		// after the decimal could be zero. If that is the case, we need to
-		// ignore them until we hit the first non-zero digit.
+		for (carry = 0, j = 0; j < n; ++j)
+		{
+			p = ((BcBinProd) a[j]) * b[i] + t[j] + carry;
+			t[j] = (BcBinDig) p;
+			carry = (BcBinDig) (p >> BC_NUM_BINDIG_BITS);
+		}
 
-		size_t zero, scale;
+		p = ((BcBinProd) t[n]) + carry;
+		t[n] = (BcBinDig) p;
+		t[n + 1] = (BcBinDig) (p >> BC_NUM_BINDIG_BITS);
 
-		// The number of limbs with non-zero digits.
-		len = bc_num_nonZeroLen(n);
+		// Adding u * m clears the bottom limb, which is then shifted out.
+		u = t[0] * minv;
+		p = ((BcBinProd) u) * m[0] + t[0];
+		carry = (BcBinDig) (p >> BC_NUM_BINDIG_BITS);
 
-		// Get the number of digits in the last limb.
-		scale = n->scale % BC_BASE_DIGS;
-		scale = scale ? scale : BC_BASE_DIGS;
+		for (j = 1; j < n; ++j)
+		{
+			p = ((BcBinProd) u) * m[j] + t[j] + carry;
+			t[j - 1] = (BcBinDig) p;
+			carry = (BcBinDig) (p >> BC_NUM_BINDIG_BITS);
+		}
 
-		// Get the number of zero digits.
-		zero = bc_num_zeroDigits(n->num + len - 1);
+		p = ((BcBinProd) t[n]) + carry;
+		t[n - 1] = (BcBinDig) p;
+		t[n] = t[n + 1] + (BcBinDig) (p >> BC_NUM_BINDIG_BITS);
+	}
 
-		// Calculate the true length.
-		len = len * BC_BASE_DIGS - zero - (BC_BASE_DIGS - scale);
+	// The result is less than 2 * m, so one subtraction is enough to reduce it.
+	for (j = n - 1; !t[n] && j < n && t[j] == m[j]; --j)
+	{
+		continue;
 	}
-	// Otherwise, count the number of int digits and return that plus the scale.
-	else len = bc_num_intDigits(n) + n->scale;
 
-	return len;
+	if (t[n] || j >= n || t[j] > m[j])
+	{
+		for (carry = 0, j = 0; j < n; ++j)
+		{
+			x = t[j];
+			y = m[j] + carry;
+			carry = (y < carry) | (x < y);
+			r[j] = x - y;
+		}
+	}
+	// NOLINTNEXTLINE
+	else memcpy(r, t, n * sizeof(BcBinDig));
 }
 
-void
-bc_num_parse(BcNum* restrict n, const char* restrict val, BcBigDig base)
+/**
+ * Does modular exponentiation for an odd modulus in binary limbs with
+ * Montgomery reduction. Only the base and the modulus are converted to binary,
+ * and only the result is converted back.
+ * @param a     The base. It must be a non-negative integer less than @a m.
+ * @param m     The modulus. It must be an odd positive integer.
+ * @param w     The bits of the exponent.
+ * @param bits  The number of bits in the exponent.
+ * @param d     The return parameter. It must be initialized.
+ */
+static void
+bc_num_modexpBin(BcNum* restrict a, BcNum* restrict m,
+                 const uint32_t* restrict w, size_t bits, BcNum* restrict d)
 {
-#if BC_DEBUG
+	BcNum x, y;
+	BcBinDig* mb;
+	BcBinDig* pows;
+	BcBinDig* r;
+	BcBinDig* t;
+	BcBinDig* u;
+	uint32_t* ws;
+	BcBinDig minv;
+	size_t i, j, l, k, n, val, len, wlen;
+	bool started;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
-#endif // BC_DEBUG
 
-	assert(n != NULL && val != NULL && base);
-	assert(base >= BC_NUM_MIN_BASE && base <= vm->maxes[BC_PROG_GLOBALS_IBASE]);
-	assert(bc_num_strValid(val));
+	k = bc_num_modexpWindow(bits);
 
-	// A one character number is *always* parsed as though the base was the
-	// maximum allowed ibase, per the bc spec.
-	if (!val[1])
+	// The binary limbs of the modulus, and the scratch words, which must hold
+	// the words of the modulus and of 2^(2 * n * BC_NUM_BINDIG_BITS).
+	n = bc_num_binLen(m->len);
+	wlen = bc_vm_growSize(m->len, 2 * n * BC_NUM_BINDIG_WORDS + 1);
+
+	// The modulus, the odd powers, the running result, the squares, the scratch
+	// space for products, and the scratch words.
+	len = bc_vm_growSize(bc_vm_arraySize(n, (((size_t) 1) << (k - 1)) + 3),
+	                     bc_vm_growSize(n + 2, bc_num_binLen(wlen)));
+
+	BC_SIG_LOCK;
+
+	mb = bc_vm_malloc(bc_vm_arraySize(len, sizeof(BcBinDig)));
+	bc_num_init(&x, BC_NUM_DEF_SIZE);
+	bc_num_init(&y, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	r = mb + n;
+	u = r + n;
+	t = u + n;
+	pows = t + n + 2;
+	ws = (uint32_t*) (pows + n * (((size_t) 1) << (k - 1)));
+
+	bc_num_toBin(m, ws);
+	bc_num_binPack(mb, n, ws, m->len);
+
+	// Leading zero limbs would only make more work.
+	while (!mb[n - 1])
 	{
-		BcBigDig dig = bc_num_parseChar(val[0], BC_NUM_MAX_LBASE);
-		bc_num_bigdig2num(n, dig);
+		n -= 1;
 	}
-	else if (base == BC_BASE) bc_num_parseDecimal(n, val);
-	else bc_num_parseBase(n, val, base);
 
-	assert(BC_NUM_RDX_VALID(n));
-}
+	minv = bc_num_binMinv(mb[0]);
 
-void
-bc_num_print(BcNum* restrict n, BcBigDig base, bool newline)
-{
-	assert(n != NULL);
-	assert(BC_ENABLE_EXTRA_MATH || base >= BC_NUM_MIN_BASE);
+	// Montgomery form is a * 2^(n * BC_NUM_BINDIG_BITS) mod m, and getting
+	// there takes a Montgomery product with 2^(2 * n * BC_NUM_BINDIG_BITS) mod
+	// m, which is computed in decimal.
+	// NOLINTNEXTLINE
+	memset(ws, 0, 2 * n * BC_NUM_BINDIG_WORDS * sizeof(uint32_t));
+	ws[2 * n * BC_NUM_BINDIG_WORDS] = 1;
 
-	// We may need a newline, just to start.
-	bc_num_printNewline();
+	bc_num_fromBin(&x, ws, 2 * n * BC_NUM_BINDIG_WORDS + 1);
+	bc_num_rem(&x, m, &y, 0);
 
-	if (BC_NUM_NONZERO(n))
+	bc_num_toBin(&y, ws);
+	bc_num_binPack(u, n, ws, y.len);
+
+	bc_num_toBin(a, ws);
+	bc_num_binPack(r, n, ws, a->len);
+
+	// Precompute the odd powers a, a^3, ..., a^(2^k - 1), using a^2 in u.
+	bc_num_binMontMul(pows, r, u, mb, n, minv, t);
+	bc_num_binMontMul(u, pows, pows, mb, n, minv, t);
+
+	for (i = 1; i < (((size_t) 1) << (k - 1)); ++i)
 	{
-#if BC_ENABLE_LIBRARY
-		BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+		bc_num_binMontMul(pows + i * n, pows + (i - 1) * n, u, mb, n, minv, t);
+	}
 
-		// Print the sign.
-		if (BC_NUM_NEG(n)) bc_num_putchar('-', true);
+	started = false;
 
-		// Print the leading zero if necessary. We don't print when using
-		// scientific or engineering modes.
-		if (BC_Z && BC_NUM_RDX_VAL(n) == n->len && base != 0 && base != 1)
+	for (i = bits - 1; i < bits; i = l - 1)
+	{
+		val = bc_num_modexpWin(w, i, k, &l);
+
+		// There is nothing to square until the first window is in.
+		for (j = l; started && j <= i; ++j)
 		{
-			bc_num_printHex(0, 1, false, !newline);
+			bc_num_binMontMul(r, r, r, mb, n, minv, t);
 		}
-	}
 
-	// Short-circuit 0.
-	if (BC_NUM_ZERO(n)) bc_num_printHex(0, 1, false, !newline);
-	else if (base == BC_BASE) bc_num_printDecimal(n, newline);
-#if BC_ENABLE_EXTRA_MATH
-	else if (base == 0 || base == 1)
-	{
-		bc_num_printExponent(n, base != 0, newline);
+		if (!val) continue;
+
+		if (started)
+		{
+			bc_num_binMontMul(r, r, pows + (val >> 1) * n, mb, n, minv, t);
+		}
+		else
+		{
+			// NOLINTNEXTLINE
+			memcpy(r, pows + (val >> 1) * n, n * sizeof(BcBinDig));
+			started = true;
+		}
 	}
-#endif // BC_ENABLE_EXTRA_MATH
-	else bc_num_printBase(n, base, newline);
 
-	if (newline) bc_num_putchar('\n', false);
+	// Get out of Montgomery form with a Montgomery product with 1.
+	// NOLINTNEXTLINE
+	memset(u, 0, n * sizeof(BcBinDig));
+	u[0] = 1;
+
+	bc_num_binMontMul(r, r, u, mb, n, minv, t);
+
+	bc_num_binUnpack(ws, r, n);
+	bc_num_fromBin(d, ws, n * BC_NUM_BINDIG_WORDS);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&y);
+	bc_num_free(&x);
+	free(mb);
+	BC_LONGJMP_CONT(vm);
 }
 
-BcBigDig
-bc_num_bigdig2(const BcNum* restrict n)
+#endif // BC_NUM_BINARY
+
+void
+bc_num_modexp(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d)
 {
-#if BC_DEBUG
+	BcNum atemp, btemp, ctemp, s, u, n1, n2;
+	BcNumMod* mod;
+	BcNum* r = &n1;
+	BcNum* t = &n2;
+	BcNum* pow;
+	BcVec pows;
+	uint32_t* w;
+	size_t i, j, l, k, bits, val;
+	bool neg, started;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
-#endif // BC_DEBUG
 
-	// This function returns no errors because it's guaranteed to succeed if
-	// its preconditions are met. Those preconditions include both n needs to
-	// be non-NULL, n being non-negative, and n being less than vm->max. If all
-	// of that is true, then we can just convert without worrying about negative
-	// errors or overflow.
+	assert(a != NULL && b != NULL && c != NULL && d != NULL);
+	assert(a != d && b != d && c != d);
 
-	BcBigDig r = 0;
-	size_t nrdx = BC_NUM_RDX_VAL(n);
+	if (BC_ERR(BC_NUM_ZERO(c))) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+	if (BC_ERR(BC_NUM_NEG(b))) bc_err(BC_ERR_MATH_NEGATIVE);
 
-	assert(n != NULL);
-	assert(!BC_NUM_NEG(n));
-	assert(bc_num_cmp(n, &vm->max) < 0);
-	assert(n->len - nrdx <= 3);
+#if BC_DEBUG || BC_GCC
+	// This is entirely for quieting a useless scan-build error.
+	btemp.len = 0;
+	ctemp.len = 0;
+#endif // BC_DEBUG || BC_GCC
 
-	// There is a small speed win from unrolling the loop here, and since it
-	// only adds 53 bytes, I decided that it was worth it.
-	switch (n->len - nrdx)
+	// Eliminate fractional parts that are zero or error if they are not zero.
+	if (BC_ERR(bc_num_nonInt(a, &atemp) || bc_num_nonInt(b, &btemp) ||
+	           bc_num_nonInt(c, &ctemp)))
 	{
-		case 3:
-		{
-			r = (BcBigDig) n->num[nrdx + 2];
+		bc_err(BC_ERR_MATH_NON_INTEGER);
+	}
 
-			// Fallthrough.
-			BC_FALLTHROUGH
+	bc_num_expand(d, ctemp.len);
+
+	// Anything to the zero is one, even modulo one.
+	if (BC_NUM_ZERO(&btemp))
+	{
+		bc_num_one(d);
+		return;
+	}
+
+	// Only the magnitudes matter for the work. Because every step used to be a
+	// truncating remainder, the result is negative exactly when the base is
+	// negative and the exponent is odd. BC_BASE_POW is even, so the bottom limb
+	// has the same parity as the exponent.
+	neg = BC_NUM_NEG(&atemp) && (btemp.num[0] & 1);
+	BC_NUM_NEG_CLR_NP(atemp);
+	BC_NUM_NEG_CLR_NP(ctemp);
+
+	BC_SIG_LOCK;
+
+	w = bc_vm_malloc(bc_vm_arraySize(btemp.len, sizeof(uint32_t)));
+	bc_vec_init(&pows, sizeof(BcNum), BC_DTOR_NUM);
+	bc_num_init(&s, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&n1, BC_NUM_DEF_SIZE);
+	bc_num_init(&n2, BC_NUM_DEF_SIZE);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// The exponent is converted to binary once, and the bits are read from the
+	// words.
+	bits = bc_num_toBinBits(&btemp, w);
+
+	if (ctemp.len == 1)
+	{
+		bc_num_bigdig2num(d, bc_num_modexpDig(&atemp, w, bits,
+		                                      (BcBigDig) ctemp.num[0]));
+	}
+#if BC_NUM_BINARY
+	// Odd moduli that are not too big are done in binary. BC_BASE_POW is even,
+	// so the bottom limb has the same parity as the modulus.
+	else if ((ctemp.num[0] & 1) && ctemp.len < BC_NUM_BIN_MONT_LEN)
+	{
+		bc_num_rem(&atemp, &ctemp, &s, 0);
+		bc_num_modexpBin(&s, &ctemp, w, bits, d);
+	}
+#endif // BC_NUM_BINARY
+	else
+	{
+		k = bc_num_modexpWindow(bits);
+
+		mod = bc_num_modGet(&ctemp);
+
+		// Precompute the odd powers a, a^3, ..., a^(2^k - 1), using a^2 in t.
+		BC_SIG_LOCK;
+
+		for (i = 0; i < (((size_t) 1) << (k - 1)); ++i)
+		{
+			pow = bc_vec_pushEmpty(&pows);
+			bc_num_init(pow, BC_NUM_DEF_SIZE);
 		}
 
-		case 2:
-		{
-			r = r * BC_BASE_POW + (BcBigDig) n->num[nrdx + 1];
+		BC_SIG_UNLOCK;
+
+		pow = bc_vec_item(&pows, 0);
 
-			// Fallthrough.
-			BC_FALLTHROUGH
-		}
+		// We already checked for 0.
+		bc_num_rem(&atemp, &ctemp, pow, 0);
 
-		case 1:
+		// Montgomery form is a * BC_BASE_POW^(m.len) mod m.
+		if (mod->minv)
 		{
-			r = r * BC_BASE_POW + (BcBigDig) n->num[nrdx];
+			bc_num_mul(pow, &mod->c, t, 0);
+			bc_num_redc(t, &mod->m, mod->minv);
+			bc_num_copy(pow, t);
 		}
-	}
-
-	return r;
-}
 
-BcBigDig
-bc_num_bigdig(const BcNum* restrict n)
-{
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+		bc_num_mul(pow, pow, t, 0);
+		bc_num_modReduce(t, mod, &s, &u);
 
-	assert(n != NULL);
+		for (i = 1; i < pows.len; ++i)
+		{
+			pow = bc_vec_item(&pows, i);
+			bc_num_mul(bc_vec_item(&pows, i - 1), t, pow, 0);
+			bc_num_modReduce(pow, mod, &s, &u);
+		}
 
-	// This error checking is extremely important, and if you do not have a
-	// guarantee that converting a number will always succeed in a particular
-	// case, you *must* call this function to get these error checks. This
-	// includes all instances of numbers inputted by the user or calculated by
-	// the user. Otherwise, you can call the faster bc_num_bigdig2().
-	if (BC_ERR(BC_NUM_NEG(n))) bc_err(BC_ERR_MATH_NEGATIVE);
-	if (BC_ERR(bc_num_cmp(n, &vm->max) >= 0)) bc_err(BC_ERR_MATH_OVERFLOW);
+		started = false;
 
-	return bc_num_bigdig2(n);
-}
+		// Scan the bits from the top. Every window ends in a one bit, so it
+		// picks one of the odd powers.
+		for (i = bits - 1; i < bits; i = l - 1)
+		{
+			val = bc_num_modexpWin(w, i, k, &l);
 
-void
-bc_num_bigdig2num(BcNum* restrict n, BcBigDig val)
-{
-	BcDig* ptr;
-	size_t i;
+			// There is nothing to square until the first window is in.
+			for (j = l; started && j <= i; ++j)
+			{
+				bc_num_mul(r, r, t, 0);
+				bc_num_modReduce(t, mod, &s, &u);
+				pow = r;
+				r = t;
+				t = pow;
+			}
 
-	assert(n != NULL);
+			if (!val) continue;
 
-	bc_num_zero(n);
+			pow = bc_vec_item(&pows, val >> 1);
 
-	// Already 0.
-	if (!val) return;
+			if (started)
+			{
+				bc_num_mul(r, pow, t, 0);
+				bc_num_modReduce(t, mod, &s, &u);
+				pow = r;
+				r = t;
+				t = pow;
+			}
+			else
+			{
+				bc_num_copy(r, pow);
+				started = true;
+			}
+		}
 
-	// Expand first. This is the only way this function can fail, and it's a
-	// fatal error.
-	bc_num_expand(n, BC_NUM_BIGDIG_LOG10);
+		// Get out of Montgomery form.
+		if (mod->minv) bc_num_redc(r, &mod->m, mod->minv);
 
-	// The conversion is easy because numbers are laid out in little-endian
-	// order.
-	for (ptr = n->num, i = 0; val; ++i, val /= BC_BASE_POW)
-	{
-		ptr[i] = val % BC_BASE_POW;
+		bc_num_copy(d, r);
 	}
 
-	n->len = i;
-}
+	if (neg && BC_NUM_NONZERO(d)) BC_NUM_NEG_SET(d);
 
-#if BC_ENABLE_EXTRA_MATH
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&n2);
+	bc_num_free(&n1);
+	bc_num_free(&u);
+	bc_num_free(&s);
+	bc_vec_free(&pows);
+	free(w);
+	BC_LONGJMP_CONT(vm);
+	assert(!BC_NUM_NEG(d) || d->len);
+	assert(BC_NUM_RDX_VALID(d));
+	assert(!d->len || d->num[d->len - 1] || BC_NUM_RDX_VAL(d) == d->len);
+}
 
 void
-bc_num_rng(const BcNum* restrict n, BcRNG* rng)
+bc_num_mulmod(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d)
 {
-	BcNum temp, temp2, intn, frac;
-	BcRand state1, state2, inc1, inc2;
-	size_t nrdx = BC_NUM_RDX_VAL(n);
+	BcNum atemp, btemp, ctemp, s, u;
+	BcNumMod* mod;
+	BcNum* x = &atemp;
+	BcNum* y = &btemp;
+	bool neg;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	// This function holds the secret of how I interpret a seed number for the
-	// PRNG. Well, it's actually in the development manual
-	// (manuals/development.md#pseudo-random-number-generator), so look there
-	// before you try to understand this.
-
-	BC_SIG_LOCK;
-
-	bc_num_init(&temp, n->len);
-	bc_num_init(&temp2, n->len);
-	bc_num_init(&frac, nrdx);
-	bc_num_init(&intn, bc_num_int(n));
+	assert(a != NULL && b != NULL && c != NULL && d != NULL);
+	assert(a != d && b != d && c != d);
 
-	BC_SETJMP_LOCKED(vm, err);
+	if (BC_ERR(BC_NUM_ZERO(c))) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
 
-	BC_SIG_UNLOCK;
+#if BC_DEBUG || BC_GCC
+	// This is entirely for quieting a useless scan-build error.
+	btemp.len = 0;
+	ctemp.len = 0;
+#endif // BC_DEBUG || BC_GCC
 
-	assert(BC_NUM_RDX_VALID_NP(vm->max));
+	// Eliminate fractional parts that are zero or error if they are not zero.
+	if (BC_ERR(bc_num_nonInt(a, &atemp) || bc_num_nonInt(b, &btemp) ||
+	           bc_num_nonInt(c, &ctemp)))
+	{
+		bc_err(BC_ERR_MATH_NON_INTEGER);
+	}
 
-	// NOLINTNEXTLINE
-	memcpy(frac.num, n->num, BC_NUM_SIZE(nrdx));
-	frac.len = nrdx;
-	BC_NUM_RDX_SET_NP(frac, nrdx);
-	frac.scale = n->scale;
+	// Like with the % operator, the result has the sign of the product.
+	neg = (BC_NUM_NEG(&atemp) != 0) != (BC_NUM_NEG(&btemp) != 0);
+	BC_NUM_NEG_CLR_NP(atemp);
+	BC_NUM_NEG_CLR_NP(btemp);
+	BC_NUM_NEG_CLR_NP(ctemp);
 
-	assert(BC_NUM_RDX_VALID_NP(frac));
-	assert(BC_NUM_RDX_VALID_NP(vm->max2));
+	BC_SIG_LOCK;
 
-	// Multiply the fraction and truncate so that it's an integer. The
-	// truncation is what clamps it, by the way.
-	bc_num_mul(&frac, &vm->max2, &temp, 0);
-	bc_num_truncate(&temp, temp.scale);
-	bc_num_copy(&frac, &temp);
+	bc_num_init(&s, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
 
-	// Get the integer.
-	// NOLINTNEXTLINE
-	memcpy(intn.num, n->num + nrdx, BC_NUM_SIZE(bc_num_int(n)));
-	intn.len = bc_num_int(n);
+	BC_SETJMP_LOCKED(vm, err);
 
-	// This assert is here because it has to be true. It is also here to justify
-	// some optimizations.
-	assert(BC_NUM_NONZERO(&vm->max));
+	BC_SIG_UNLOCK;
 
-	// If there *was* a fractional part...
-	if (BC_NUM_NONZERO(&frac))
+	// Reduction needs the product to be less than the square of the modulus,
+	// so the operands are reduced first, but only if they need it.
+	if (bc_num_cmp(x, &ctemp) >= 0)
 	{
-		// This divmod splits frac into the two state parts.
-		bc_num_divmod(&frac, &vm->max, &temp, &temp2, 0);
-
-		// frac is guaranteed to be smaller than vm->max * vm->max (pow).
-		// This means that when dividing frac by vm->max, as above, the
-		// quotient and remainder are both guaranteed to be less than vm->max,
-		// which means we can use bc_num_bigdig2() here and not worry about
-		// overflow.
-		state1 = (BcRand) bc_num_bigdig2(&temp2);
-		state2 = (BcRand) bc_num_bigdig2(&temp);
+		bc_num_rem(&atemp, &ctemp, &s, 0);
+		x = &s;
 	}
-	else state1 = state2 = 0;
 
-	// If there *was* an integer part...
-	if (BC_NUM_NONZERO(&intn))
+	if (a == b) y = x;
+	else if (bc_num_cmp(y, &ctemp) >= 0)
 	{
-		// This divmod splits intn into the two inc parts.
-		bc_num_divmod(&intn, &vm->max, &temp, &temp2, 0);
+		bc_num_rem(&btemp, &ctemp, &u, 0);
+		y = &u;
+	}
 
-		// Because temp2 is the mod of vm->max, from above, it is guaranteed
-		// to be small enough to use bc_num_bigdig2().
-		inc1 = (BcRand) bc_num_bigdig2(&temp2);
+	mod = bc_num_modGet(&ctemp);
 
-		// Clamp the second inc part.
-		if (bc_num_cmp(&temp, &vm->max) >= 0)
-		{
-			bc_num_copy(&temp2, &temp);
-			bc_num_mod(&temp2, &vm->max, &temp, 0);
-		}
+	bc_num_mul(x, y, d, 0);
 
-		// The if statement above ensures that temp is less than vm->max, which
-		// means that we can use bc_num_bigdig2() here.
-		inc2 = (BcRand) bc_num_bigdig2(&temp);
+	bc_num_modReduce(d, mod, &s, &u);
+
+	// Montgomery reduction also divided by BC_BASE_POW^(m.len), so multiply by
+	// the conversion constant and reduce again to undo that.
+	if (mod->minv)
+	{
+		bc_num_mul(d, &mod->c, &s, 0);
+		bc_num_redc(&s, &mod->m, mod->minv);
+		bc_num_copy(d, &s);
 	}
-	else inc1 = inc2 = 0;
 
-	bc_rand_seed(rng, state1, state2, inc1, inc2);
+	if (neg && BC_NUM_NONZERO(d)) BC_NUM_NEG_SET(d);
 
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&intn);
-	bc_num_free(&frac);
-	bc_num_free(&temp2);
-	bc_num_free(&temp);
+	bc_num_free(&u);
+	bc_num_free(&s);
 	BC_LONGJMP_CONT(vm);
+	assert(!BC_NUM_NEG(d) || d->len);
+	assert(BC_NUM_RDX_VALID(d));
+	assert(!d->len || d->num[d->len - 1] || BC_NUM_RDX_VAL(d) == d->len);
 }
 
-void
-bc_num_createFromRNG(BcNum* restrict n, BcRNG* rng)
+/**
+ * Returns the limbs of @a n from @a sh up to @a len as one integer. These are
+ * the leading parts that the Lehmer steps of the GCD work on.
+ * @param n    The number.
+ * @param sh   The index of the lowest limb.
+ * @param len  The index after the highest limb. It can be past the end of @a n.
+ * @return     The leading part.
+ */
+static int64_t
+bc_num_gcdLead(const BcNum* restrict n, size_t sh, size_t len)
 {
-	BcRand s1, s2, i1, i2;
-	BcNum conv, temp1, temp2, temp3;
-	BcDig temp1_num[BC_RAND_NUM_SIZE], temp2_num[BC_RAND_NUM_SIZE];
-	BcDig conv_num[BC_NUM_BIGDIG_LOG10];
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+	int64_t x = 0;
+	size_t i;
 
-	BC_SIG_LOCK;
+	for (i = len; i > sh; --i)
+	{
+		x = x * BC_BASE_POW + (i <= n->len ? n->num[i - 1] : 0);
+	}
 
-	bc_num_init(&temp3, 2 * BC_RAND_NUM_SIZE);
+	return x;
+}
 
-	BC_SETJMP_LOCKED(vm, err);
+/**
+ * Pads @a n with zero limbs up to @a len limbs, so that the GCD kernels can
+ * run over two numbers of different lengths at once.
+ * @param n    The number to pad.
+ * @param len  The number of limbs to pad to.
+ */
+static void
+bc_num_gcdPad(BcNum* restrict n, size_t len)
+{
+	bc_num_expand(n, len);
 
-	BC_SIG_UNLOCK;
+	// NOLINTNEXTLINE
+	if (len > n->len) memset(n->num + n->len, 0, BC_NUM_SIZE(len - n->len));
 
-	bc_num_setup(&temp1, temp1_num, sizeof(temp1_num) / sizeof(BcDig));
-	bc_num_setup(&temp2, temp2_num, sizeof(temp2_num) / sizeof(BcDig));
-	bc_num_setup(&conv, conv_num, sizeof(conv_num) / sizeof(BcDig));
+	n->len = len;
+}
 
-	// This assert is here because it has to be true. It is also here to justify
-	// the assumption that vm->max is not zero.
-	assert(BC_NUM_NONZERO(&vm->max));
+/**
+ * Takes the low limb off of the signed carry @a c of a GCD kernel, rounding
+ * toward negative infinity so that the limb is in [0, BC_BASE_POW).
+ * @param c  An in/out parameter; the carry.
+ * @return   The limb.
+ */
+static BcDig
+bc_num_gcdCarry(int64_t* restrict c)
+{
+	int64_t r = *c % BC_BASE_POW;
 
-	// Because this is true, we can just ignore math errors that would happen
-	// otherwise.
-	assert(BC_NUM_NONZERO(&vm->max2));
+	*c /= BC_BASE_POW;
 
-	bc_rand_getRands(rng, &s1, &s2, &i1, &i2);
+	if (r < 0)
+	{
+		r += BC_BASE_POW;
+		*c -= 1;
+	}
 
-	// Put the second piece of state into a number.
-	bc_num_bigdig2num(&conv, (BcBigDig) s2);
+	return (BcDig) r;
+}
 
-	assert(BC_NUM_RDX_VALID_NP(conv));
+/**
+ * Applies the inverse of the matrix @a n of a Lehmer step to @a a and @a b in
+ * place, which makes them n11 * a - n01 * b and n00 * b - n10 * a. The Lehmer
+ * step makes sure that both are non-negative.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param n  The matrix, in row-major order.
+ */
+static void
+bc_num_gcdApply(BcNum* restrict a, BcNum* restrict b, const int64_t* n)
+{
+	size_t i, len = BC_MAX(a->len, b->len);
+	int64_t ca = 0, cb = 0, x, y;
 
-	// Multiply by max to make room for the first piece of state.
-	bc_num_mul(&conv, &vm->max, &temp1, 0);
+	bc_num_gcdPad(a, len);
+	bc_num_gcdPad(b, len);
 
-	// Add in the first piece of state.
-	bc_num_bigdig2num(&conv, (BcBigDig) s1);
-	bc_num_add(&conv, &temp1, &temp2, 0);
+	for (i = 0; i < len; ++i)
+	{
+		x = a->num[i];
+		y = b->num[i];
 
-	// Divide to make it an entirely fractional part.
-	bc_num_div(&temp2, &vm->max2, &temp3, BC_RAND_STATE_BITS);
+		ca += n[3] * x - n[1] * y;
+		cb += n[0] * y - n[2] * x;
+
+		a->num[i] = bc_num_gcdCarry(&ca);
+		b->num[i] = bc_num_gcdCarry(&cb);
+	}
+
+	assert(!ca && !cb);
+
+	bc_num_clean(a);
+	bc_num_clean(b);
+}
+
+/**
+ * Multiplies the matrix @a m of GCD steps by the matrix @a n of a Lehmer step
+ * in place. Both are in row-major order, and all of their entries are
+ * non-negative.
+ * @param m  An in/out parameter; the matrix of steps.
+ * @param n  The matrix of the Lehmer step.
+ */
+static void
+bc_num_gcdMatStep(BcNum* restrict m, const int64_t* n)
+{
+	size_t i, j, len;
+	int64_t c0, c1, x, y;
+
+	for (i = 0; i < 4; i += 2)
+	{
+		// The sum of two entries of n is less than 2^32, which fits in
+		// BC_NUM_GCD_LIMBS limbs.
+		len = bc_vm_growSize(BC_MAX(m[i].len, m[i + 1].len), BC_NUM_GCD_LIMBS);
+
+		bc_num_gcdPad(&m[i], len);
+		bc_num_gcdPad(&m[i + 1], len);
+
+		for (j = 0, c0 = c1 = 0; j < len; ++j)
+		{
+			x = m[i].num[j];
+			y = m[i + 1].num[j];
+
+			c0 += x * n[0] + y * n[2];
+			c1 += x * n[1] + y * n[3];
+
+			m[i].num[j] = bc_num_gcdCarry(&c0);
+			m[i + 1].num[j] = bc_num_gcdCarry(&c1);
+		}
+
+		assert(!c0 && !c1);
+
+		bc_num_clean(&m[i]);
+		bc_num_clean(&m[i + 1]);
+	}
+}
+
+/**
+ * Multiplies the matrix @a m of GCD steps by another one, @a n, in place. Both
+ * are in row-major order, and all of their entries are non-negative.
+ * @param m  An in/out parameter; the matrix of steps.
+ * @param n  The other matrix.
+ */
+static void
+bc_num_gcdMatMul(BcNum* restrict m, BcNum* restrict n)
+{
+	BcNum t, u, v;
+	size_t i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
+
+	BC_SIG_LOCK;
 
-	// Now start on the increment parts. It's the same process without the
-	// divide, so put the second piece of increment into a number.
-	bc_num_bigdig2num(&conv, (BcBigDig) i2);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&v, BC_NUM_DEF_SIZE);
 
-	assert(BC_NUM_RDX_VALID_NP(conv));
+	BC_SETJMP_LOCKED(vm, err);
 
-	// Multiply by max to make room for the first piece of increment.
-	bc_num_mul(&conv, &vm->max, &temp1, 0);
+	BC_SIG_UNLOCK;
 
-	// Add in the first piece of increment.
-	bc_num_bigdig2num(&conv, (BcBigDig) i1);
-	bc_num_add(&conv, &temp1, &temp2, 0);
+	for (i = 0; i < 4; i += 2)
+	{
+		bc_num_mul(&m[i], &n[0], &t, 0);
+		bc_num_mul(&m[i + 1], &n[2], &u, 0);
+		bc_num_add(&t, &u, &t, 0);
 
-	// Now add the two together.
-	bc_num_add(&temp2, &temp3, n, 0);
+		bc_num_mul(&m[i], &n[1], &u, 0);
+		bc_num_mul(&m[i + 1], &n[3], &v, 0);
+		bc_num_add(&u, &v, &m[i + 1], 0);
 
-	assert(BC_NUM_RDX_VALID(n));
+		BC_SIG_LOCK;
+		bc_num_swap(&m[i], &t);
+		BC_SIG_UNLOCK;
+	}
 
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&temp3);
+	bc_num_free(&v);
+	bc_num_free(&u);
+	bc_num_free(&t);
 	BC_LONGJMP_CONT(vm);
 }
 
-void
-bc_num_irand(BcNum* restrict a, BcNum* restrict b, BcRNG* restrict rng)
+/**
+ * Does one Lehmer step of the GCD. It runs Euclid on the leading limbs of @a a
+ * and @a b, taking a quotient only when the bounds on the leading limbs prove
+ * that it is the quotient of the whole numbers, and then applies all of the
+ * quotients to the whole numbers at once with single-limb multipliers.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param s  The number of limbs that both numbers must stay above, which is
+ *           for the half GCD. If it is zero, there is no limit.
+ * @param m  An in/out parameter; the matrix of steps, or NULL if the caller
+ *           does not need it.
+ * @return   True if the step made progress, false otherwise.
+ */
+static bool
+bc_num_gcdLehmer(BcNum* restrict a, BcNum* restrict b, size_t s,
+                 BcNum* restrict m)
 {
-	BcNum atemp;
-	size_t i;
-
-	assert(a != b);
+	int64_t n[4] = { 1, 0, 0, 1 };
+	int64_t x, y, e, q, lo, t0, t1;
+	size_t sh, len = BC_MAX(a->len, b->len);
 
-	if (BC_ERR(BC_NUM_NEG(a))) bc_err(BC_ERR_MATH_NEGATIVE);
+	sh = len > BC_NUM_GCD_LIMBS ? len - BC_NUM_GCD_LIMBS : 0;
+	if (sh < s) return false;
 
-	// If either of these are true, then the numbers are integers.
-	if (BC_NUM_ZERO(a) || BC_NUM_ONE(a)) return;
+	x = bc_num_gcdLead(a, sh, len);
+	y = bc_num_gcdLead(b, sh, len);
 
-#if BC_GCC
-	// This is here in GCC to quiet the "maybe-uninitialized" warning.
-	atemp.num = NULL;
-	atemp.len = 0;
-#endif // BC_GCC
+	// Because of the truncated low limbs, the current numbers, in units of the
+	// lowest leading limb, are in [x - n01, x + n11] and [y - n10, y + n00].
+	// If there were no low limbs, the leading parts are exact.
+	e = (sh != 0);
 
-	if (BC_ERR(bc_num_nonInt(a, &atemp))) bc_err(BC_ERR_MATH_NON_INTEGER);
+	for (;;)
+	{
+		if (x - e * n[1] >= y + e * n[0])
+		{
+			lo = y - e * n[2];
+			if (lo < 1) break;
 
-	assert(atemp.num != NULL);
-	assert(atemp.len);
+			q = (x - e * n[1]) / (y + e * n[0]);
+			if (q > BC_NUM_GCD_MAX || q != (x + e * n[3]) / lo) break;
 
-	if (atemp.len > 2)
-	{
-		size_t len;
+			t0 = n[1] + q * n[0];
+			t1 = n[3] + q * n[2];
+			if (t0 > BC_NUM_GCD_MAX || t1 > BC_NUM_GCD_MAX) break;
 
-		len = atemp.len - 2;
+			// The new first number must stay at least one lowest leading limb.
+			if (x - q * y - e * t0 < 1) break;
 
-		// Just generate a random number for each limb.
-		for (i = 0; i < len; i += 2)
+			x -= q * y;
+			n[1] = t0;
+			n[3] = t1;
+		}
+		else if (y - e * n[2] >= x + e * n[3])
 		{
-			BcRand dig;
+			lo = x - e * n[1];
+			if (lo < 1) break;
 
-			dig = bc_rand_bounded(rng, BC_BASE_RAND_POW);
+			q = (y - e * n[2]) / (x + e * n[3]);
+			if (q > BC_NUM_GCD_MAX || q != (y + e * n[0]) / lo) break;
 
-			b->num[i] = (BcDig) (dig % BC_BASE_POW);
-			b->num[i + 1] = (BcDig) (dig / BC_BASE_POW);
+			t0 = n[0] + q * n[1];
+			t1 = n[2] + q * n[3];
+			if (t0 > BC_NUM_GCD_MAX || t1 > BC_NUM_GCD_MAX) break;
+
+			if (y - q * x - e * t1 < 1) break;
+
+			y -= q * x;
+			n[0] = t0;
+			n[2] = t1;
 		}
+		else break;
 	}
-	else
-	{
-		// We need this set.
-		i = 0;
-	}
-
-	// This will be true if there's one full limb after the two limb groups.
-	if (i == atemp.len - 2)
-	{
-		// Increment this for easy use.
-		i += 1;
 
-		// If the last digit is not one, we need to set a bound for it
-		// explicitly. Since there's still an empty limb, we need to fill that.
-		if (atemp.num[i] != 1)
-		{
-			BcRand dig;
-			BcRand bound;
+	if (!n[1] && !n[2]) return false;
 
-			// Set the bound to the bound of the last limb times the amount
-			// needed to fill the second-to-last limb as well.
-			bound = ((BcRand) atemp.num[i]) * BC_BASE_POW;
+	bc_num_gcdApply(a, b, n);
+	if (m != NULL) bc_num_gcdMatStep(m, n);
 
-			dig = bc_rand_bounded(rng, bound);
+	return true;
+}
 
-			// Fill the last two.
-			b->num[i - 1] = (BcDig) (dig % BC_BASE_POW);
-			b->num[i] = (BcDig) (dig / BC_BASE_POW);
+/**
+ * Does one step of Euclid with a full division, for when a Lehmer step cannot
+ * make progress, such as when one number is much bigger than the other.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param s  The number of limbs that both numbers must stay above, which is
+ *           for the half GCD. If it is zero, there is no limit.
+ * @param m  An in/out parameter; the matrix of steps, or NULL if the caller
+ *           does not need it.
+ * @return   True if the step made progress, false otherwise.
+ */
+static bool
+bc_num_gcdDiv(BcNum* restrict a, BcNum* restrict b, size_t s,
+              BcNum* restrict m)
+{
+	BcNum q, r, t;
+	BcNum* big;
+	BcNum* small;
+	size_t i, col;
+	bool ok = false;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-			// Ensure that the length will be correct. If the last limb is zero,
-			// then the length needs to be one less than the bound.
-			b->len = atemp.len - (b->num[i] == 0);
-		}
-		// Here the last limb *is* one, which means the last limb does *not*
-		// need to be filled. Also, the length needs to be one less because the
-		// last limb is 0.
-		else
-		{
-			b->num[i - 1] = (BcDig) bc_rand_bounded(rng, BC_BASE_POW);
-			b->len = atemp.len - 1;
-		}
+	// Subtracting from a changes the second column of the matrix, and
+	// subtracting from b changes the first.
+	if (bc_num_cmp(a, b) >= 0)
+	{
+		big = a;
+		small = b;
+		col = 1;
 	}
-	// Here, there is only one limb to fill.
 	else
 	{
-		// See above for how this works.
-		if (atemp.num[i] != 1)
-		{
-			b->num[i] = (BcDig) bc_rand_bounded(rng, (BcRand) atemp.num[i]);
-			b->len = atemp.len - (b->num[i] == 0);
-		}
-		else b->len = atemp.len - 1;
+		big = b;
+		small = a;
+		col = 0;
 	}
 
-	bc_num_clean(b);
-
-	assert(BC_NUM_RDX_VALID(b));
-}
-#endif // BC_ENABLE_EXTRA_MATH
-
-size_t
-bc_num_addReq(const BcNum* a, const BcNum* b, size_t scale)
-{
-	size_t aint, bint, ardx, brdx;
+	if (small->len <= s) return false;
 
-	// Addition and subtraction require the max of the length of the two numbers
-	// plus 1.
+	BC_SIG_LOCK;
 
-	BC_UNUSED(scale);
+	bc_num_init(&q, BC_NUM_DEF_SIZE);
+	bc_num_init(&r, small->len);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
 
-	ardx = BC_NUM_RDX_VAL(a);
-	aint = bc_num_int(a);
-	assert(aint <= a->len && ardx <= a->len);
+	BC_SETJMP_LOCKED(vm, err);
 
-	brdx = BC_NUM_RDX_VAL(b);
-	bint = bc_num_int(b);
-	assert(bint <= b->len && brdx <= b->len);
+	BC_SIG_UNLOCK;
 
-	ardx = BC_MAX(ardx, brdx);
-	aint = BC_MAX(aint, bint);
+	bc_num_divmod(big, small, &q, &r, 0);
 
-	return bc_vm_growSize(bc_vm_growSize(ardx, aint), 1);
-}
+	// If the remainder is too small for the half GCD, take one less.
+	if (s && r.len <= s)
+	{
+		if (BC_NUM_ONE(&q)) goto err;
 
-size_t
-bc_num_mulReq(const BcNum* a, const BcNum* b, size_t scale)
-{
-	size_t max, rdx;
+		bc_num_one(&t);
+		bc_num_sub(&q, &t, &q, 0);
+		bc_num_add(&r, small, &r, 0);
+	}
 
-	// Multiplication requires the sum of the lengths of the numbers.
+	BC_SIG_LOCK;
+	bc_num_swap(big, &r);
+	BC_SIG_UNLOCK;
 
-	rdx = bc_vm_growSize(BC_NUM_RDX_VAL(a), BC_NUM_RDX_VAL(b));
+	if (m != NULL)
+	{
+		for (i = 0; i < 4; i += 2)
+		{
+			bc_num_mul(&q, &m[i + 1 - col], &t, 0);
+			bc_num_add(&m[i + col], &t, &m[i + col], 0);
+		}
+	}
 
-	max = BC_NUM_RDX(scale);
+	ok = true;
 
-	max = bc_vm_growSize(BC_MAX(max, rdx), 1);
-	rdx = bc_vm_growSize(bc_vm_growSize(bc_num_int(a), bc_num_int(b)), max);
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&t);
+	bc_num_free(&r);
+	bc_num_free(&q);
+	BC_LONGJMP_CONT(vm);
 
-	return rdx;
+	return ok;
 }
 
-size_t
-bc_num_divReq(const BcNum* a, const BcNum* b, size_t scale)
+/**
+ * Does one step of the GCD, a Lehmer step if it can.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param s  The number of limbs that both numbers must stay above. If it is
+ *           zero, there is no limit.
+ * @param m  An in/out parameter; the matrix of steps, or NULL.
+ * @return   True if the step made progress, false otherwise.
+ */
+static bool
+bc_num_gcdStep(BcNum* restrict a, BcNum* restrict b, size_t s,
+               BcNum* restrict m)
 {
-	size_t max, rdx;
+	return bc_num_gcdLehmer(a, b, s, m) || bc_num_gcdDiv(a, b, s, m);
+}
 
-	// Division requires the length of the dividend plus the scale.
+static bool
+bc_num_hgcd(BcNum* restrict a, BcNum* restrict b, BcNum* restrict m);
 
-	rdx = bc_vm_growSize(BC_NUM_RDX_VAL(a), BC_NUM_RDX_VAL(b));
+/**
+ * Runs the half GCD on the limbs of @a a and @a b from @a p up, then applies
+ * the steps it takes to the whole numbers. Möller showed that, with the limits
+ * that bc_num_hgcd() keeps, steps for the top limbs are also steps for the
+ * whole numbers, and applying them only needs products of the low limbs.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param p  The number of low limbs to leave out.
+ * @param m  An in/out parameter; the matrix of steps, or NULL.
+ * @return   True if there were any steps, false otherwise.
+ */
+static bool
+bc_num_hgcdTop(BcNum* restrict a, BcNum* restrict b, size_t p,
+               BcNum* restrict m)
+{
+	BcNum ah, bh, al, bl, t, u, ta, tb;
+	BcNum n[4];
+	size_t i;
+	bool ok = false;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	max = BC_NUM_RDX(scale);
+	BC_SIG_LOCK;
 
-	max = bc_vm_growSize(BC_MAX(max, rdx), 1);
-	rdx = bc_vm_growSize(bc_num_int(a), max);
+	bc_num_view(a, p, a->len, &t);
+	bc_num_createCopy(&ah, &t);
+	bc_num_view(b, p, b->len, &t);
+	bc_num_createCopy(&bh, &t);
 
-	return rdx;
-}
+	for (i = 0; i < 4; ++i)
+	{
+		bc_num_init(&n[i], BC_NUM_DEF_SIZE);
+	}
 
-size_t
-bc_num_powReq(const BcNum* a, const BcNum* b, size_t scale)
-{
-	BC_UNUSED(scale);
-	return bc_vm_growSize(bc_vm_growSize(a->len, b->len), 1);
-}
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_init(&u, BC_NUM_DEF_SIZE);
+	bc_num_init(&ta, BC_NUM_DEF_SIZE);
+	bc_num_init(&tb, BC_NUM_DEF_SIZE);
 
-#if BC_ENABLE_EXTRA_MATH
-size_t
-bc_num_placesReq(const BcNum* a, const BcNum* b, size_t scale)
-{
-	BC_UNUSED(scale);
-	return a->len + b->len - BC_NUM_RDX_VAL(a) - BC_NUM_RDX_VAL(b);
-}
-#endif // BC_ENABLE_EXTRA_MATH
+	BC_SETJMP_LOCKED(vm, err);
 
-void
-bc_num_add(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, false, bc_num_as, bc_num_addReq(a, b, scale));
-}
+	BC_SIG_UNLOCK;
 
-void
-bc_num_sub(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, true, bc_num_as, bc_num_addReq(a, b, scale));
-}
+	bc_num_one(&n[0]);
+	bc_num_one(&n[3]);
 
-void
-bc_num_mul(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_m, bc_num_mulReq(a, b, scale));
-}
+	ok = bc_num_hgcd(&ah, &bh, n);
+	if (!ok) goto err;
 
-void
-bc_num_div(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_d, bc_num_divReq(a, b, scale));
-}
+	// a = ah * BASE^p + n11 * al - n01 * bl, and b = bh * BASE^p + n00 * bl -
+	// n10 * al, where al and bl are the low limbs.
+	bc_num_view(a, 0, p, &al);
+	bc_num_view(b, 0, p, &bl);
 
-void
-bc_num_mod(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_rem, bc_num_divReq(a, b, scale));
-}
+	bc_num_mul(&n[3], &al, &t, 0);
+	bc_num_mul(&n[1], &bl, &u, 0);
+	bc_num_sub(&t, &u, &ta, 0);
 
-void
-bc_num_pow(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_p, bc_num_powReq(a, b, scale));
-}
+	bc_num_mul(&n[0], &bl, &t, 0);
+	bc_num_mul(&n[2], &al, &u, 0);
+	bc_num_sub(&t, &u, &tb, 0);
 
-#if BC_ENABLE_EXTRA_MATH
-void
-bc_num_places(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_place, bc_num_placesReq(a, b, scale));
-}
+	bc_num_shiftLeft(&ah, p * BC_BASE_DIGS);
+	bc_num_shiftLeft(&bh, p * BC_BASE_DIGS);
 
-void
-bc_num_lshift(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_left, bc_num_placesReq(a, b, scale));
-}
+	bc_num_add(&ah, &ta, a, 0);
+	bc_num_add(&bh, &tb, b, 0);
+
+	assert(!BC_NUM_NEG(a) && !BC_NUM_NEG(b));
 
-void
-bc_num_rshift(BcNum* a, BcNum* b, BcNum* c, size_t scale)
-{
-	assert(BC_NUM_RDX_VALID(a));
-	assert(BC_NUM_RDX_VALID(b));
-	bc_num_binary(a, b, c, scale, bc_num_right, bc_num_placesReq(a, b, scale));
+	if (m != NULL) bc_num_gcdMatMul(m, n);
+
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&tb);
+	bc_num_free(&ta);
+	bc_num_free(&u);
+	bc_num_free(&t);
+	for (i = 0; i < 4; ++i)
+	{
+		bc_num_free(&n[i]);
+	}
+	bc_num_free(&bh);
+	bc_num_free(&ah);
+	BC_LONGJMP_CONT(vm);
+
+	return ok;
 }
-#endif // BC_ENABLE_EXTRA_MATH
 
-void
-bc_num_sqrt(BcNum* restrict a, BcNum* restrict b, size_t scale)
+/**
+ * The half GCD, after Möller's version of Schönhage's algorithm. It takes the
+ * steps of Euclid on @a a and @a b that keep both of them above half of their
+ * limbs, reducing them to about half of their size. Above BC_NUM_HGCD_LEN, it
+ * gets most of the steps by recursing on the top limbs twice, which makes the
+ * GCD subquadratic.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param m  An in/out parameter; the matrix of steps, or NULL.
+ * @return   True if there were any steps, false otherwise.
+ */
+static bool
+bc_num_hgcd(BcNum* restrict a, BcNum* restrict b, BcNum* restrict m)
 {
-	BcNum num1, num2, half, f, fprime;
-	BcNum* x0;
-	BcNum* x1;
-	BcNum* temp;
-	// realscale is meant to quiet a warning on GCC about longjmp() clobbering.
-	// This one is real.
-	size_t pow, len, rdx, req, resscale, realscale;
-	BcDig half_digs[1];
-#if BC_ENABLE_LIBRARY
-	BcVm* vm = bcl_getspecific();
-#endif // BC_ENABLE_LIBRARY
+	size_t n = BC_MAX(a->len, b->len), s = n / 2 + 1;
+	bool progress = false;
 
-	assert(a != NULL && b != NULL && a != b);
+	if (BC_MIN(a->len, b->len) <= s) return false;
 
-	if (BC_ERR(BC_NUM_NEG(a))) bc_err(BC_ERR_MATH_NEGATIVE);
+	if (n >= BC_NUM_HGCD_LEN)
+	{
+		// The first recursion takes them down to about three quarters.
+		progress = bc_num_hgcdTop(a, b, n / 2, m);
 
-	// We want to calculate to a's scale if it is bigger so that the result will
-	// truncate properly.
-	if (a->scale > scale) realscale = a->scale;
-	else realscale = scale;
+		while (BC_MAX(a->len, b->len) > 3 * n / 4 + 1)
+		{
+			if (!bc_num_gcdStep(a, b, s, m)) return progress;
+			progress = true;
+		}
 
-	// Set parameters for the result.
-	len = bc_vm_growSize(bc_num_intDigits(a), 1);
-	rdx = BC_NUM_RDX(realscale);
+		// The second takes them down to about a half.
+		n = BC_MAX(a->len, b->len);
 
-	// Square root needs half of the length of the parameter.
-	req = bc_vm_growSize(BC_MAX(rdx, BC_NUM_RDX_VAL(a)), len >> 1);
-	req = bc_vm_growSize(req, 1);
+		if (n > s + 2 && bc_num_hgcdTop(a, b, 2 * s - n + 1, m))
+		{
+			progress = true;
+		}
+	}
 
-	BC_SIG_LOCK;
+	while (bc_num_gcdStep(a, b, s, m))
+	{
+		progress = true;
+	}
 
-	// Unlike the binary operators, this function is the only single parameter
-	// function and is expected to initialize the result. This means that it
-	// expects that b is *NOT* preallocated. We allocate it here.
-	bc_num_init(b, req);
+	return progress;
+}
 
-	BC_SIG_UNLOCK;
+/**
+ * Finishes the GCD of two numbers that fit in one machine word.
+ * @param a  An in/out parameter; the first number. It gets the GCD.
+ * @param b  An in/out parameter; the second number. It gets zero.
+ */
+static void
+bc_num_gcdWord(BcNum* restrict a, BcNum* restrict b)
+{
+	uint64_t x, y, t;
+	size_t i;
 
-	assert(a != NULL && b != NULL && a != b);
-	assert(a->num != NULL && b->num != NULL);
+	x = (uint64_t) bc_num_gcdLead(a, 0, a->len);
+	y = (uint64_t) bc_num_gcdLead(b, 0, b->len);
 
-	// Easy case.
-	if (BC_NUM_ZERO(a))
+	while (y)
 	{
-		bc_num_setToZero(b, realscale);
-		return;
+		t = x % y;
+		x = y;
+		y = t;
 	}
 
-	// Another easy case.
-	if (BC_NUM_ONE(a))
+	// The GCD is no bigger than either number, so it fits in a.
+	for (i = 0; x; ++i, x /= BC_BASE_POW)
 	{
-		bc_num_one(b);
-		bc_num_extend(b, realscale);
-		return;
+		a->num[i] = (BcDig) (x % BC_BASE_POW);
 	}
 
-	// Set the parameters again.
-	rdx = BC_NUM_RDX(realscale);
-	rdx = BC_MAX(rdx, BC_NUM_RDX_VAL(a));
-	len = bc_vm_growSize(a->len, rdx);
+	a->len = i;
+	bc_num_zero(b);
+}
 
-	BC_SIG_LOCK;
+/**
+ * Runs the GCD of @a a and @a b, which must be non-negative integers, in place
+ * until one of them is zero; the other is the GCD.
+ * @param a  An in/out parameter; the first number.
+ * @param b  An in/out parameter; the second number.
+ * @param m  An in/out parameter; NULL, or the matrix of steps, which must
+ *           start as the identity. It ends so that the old numbers are it
+ *           times the new ones.
+ */
+static void
+bc_num_gcdRun(BcNum* restrict a, BcNum* restrict b, BcNum* restrict m)
+{
+	size_t len;
+
+	while (BC_NUM_NONZERO(a) && BC_NUM_NONZERO(b))
+	{
+		len = BC_MAX(a->len, b->len);
+
+		if (m == NULL && len <= BC_NUM_GCD_LIMBS)
+		{
+			bc_num_gcdWord(a, b);
+			return;
+		}
+
+		if (len >= BC_NUM_HGCD_LEN && bc_num_hgcd(a, b, m)) continue;
+
+		// Without a limit, a division always makes progress.
+		bc_num_gcdStep(a, b, 0, m);
+	}
+}
 
-	bc_num_init(&num1, len);
-	bc_num_init(&num2, len);
-	bc_num_setup(&half, half_digs, sizeof(half_digs) / sizeof(BcDig));
+/**
+ * Computes the GCD of @a a and @a b, which must be non-negative integers that
+ * are consumed, along with their coefficients in Bezout's identity.
+ * @param a  The first number.
+ * @param b  The second number.
+ * @param g  The return parameter for the GCD. It must be initialized.
+ * @param x  The return parameter for the coefficient of @a a. It must be
+ *           initialized.
+ * @param y  The return parameter for the coefficient of @a b, or NULL if it is
+ *           not needed.
+ */
+static void
+bc_num_gcdCoef(BcNum* restrict a, BcNum* restrict b, BcNum* restrict g,
+               BcNum* restrict x, BcNum* restrict y)
+{
+	BcNum m[4];
+	size_t i;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// There is a division by two in the formula. We set up a number that's 1/2
-	// so that we can use multiplication instead of heavy division.
-	bc_num_setToZero(&half, 1);
-	half.num[0] = BC_BASE_POW / 2;
-	half.len = 1;
-	BC_NUM_RDX_SET_NP(half, 1);
+	BC_SIG_LOCK;
 
-	bc_num_init(&f, len);
-	bc_num_init(&fprime, len);
+	for (i = 0; i < 4; ++i)
+	{
+		bc_num_init(&m[i], BC_NUM_DEF_SIZE);
+	}
 
 	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	// Pointers for easy switching.
-	x0 = &num1;
-	x1 = &num2;
+	bc_num_one(&m[0]);
+	bc_num_one(&m[3]);
 
-	// Start with 1.
-	bc_num_one(x0);
+	bc_num_gcdRun(a, b, m);
 
-	// The power of the operand is needed for the estimate.
-	pow = bc_num_intDigits(a);
+	// The old numbers are m times (g, 0) or (0, g), and m has a determinant of
+	// 1, so the coefficients come from a row of its inverse.
+	if (BC_NUM_NONZERO(a))
+	{
+		bc_num_copy(g, a);
+		bc_num_copy(x, &m[3]);
 
-	// The code in this if statement calculates the initial estimate. First, if
-	// a is less than 1, then 0 is a good estimate. Otherwise, we want something
-	// in the same ballpark. That ballpark is half of pow because the result
-	// will have half the digits.
-	if (pow)
+		if (y != NULL)
+		{
+			bc_num_copy(y, &m[1]);
+			bc_num_negate(y);
+		}
+	}
+	else
 	{
-		// An odd number is served by starting with 2^((pow-1)/2), and an even
-		// number is served by starting with 6^((pow-2)/2). Why? Because math.
-		if (pow & 1) x0->num[0] = 2;
-		else x0->num[0] = 6;
+		bc_num_copy(g, b);
+		bc_num_copy(x, &m[2]);
+		bc_num_negate(x);
+		if (y != NULL) bc_num_copy(y, &m[0]);
+	}
 
-		pow -= 2 - (pow & 1);
-		bc_num_shiftLeft(x0, pow / 2);
+err:
+	BC_SIG_MAYLOCK;
+	for (i = 0; i < 4; ++i)
+	{
+		bc_num_free(&m[i]);
 	}
+	BC_LONGJMP_CONT(vm);
+}
 
-	// I can set the rdx here directly because neg should be false.
-	x0->scale = x0->rdx = 0;
-	resscale = (realscale + BC_BASE_DIGS) + 2;
+void
+bc_num_gcd(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	BcNum v, x, y;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-	// This is the calculation loop. This compare goes to 0 eventually as the
-	// difference between the two numbers gets smaller than resscale.
-	while (bc_num_cmp(x1, x0))
-	{
-		assert(BC_NUM_NONZERO(x0));
+	BC_UNUSED(scale);
 
-		// This loop directly corresponds to the iteration in Newton's method.
-		// If you know the formula, this loop makes sense. Go study the formula.
+	assert(a != c && b != c);
 
-		bc_num_div(a, x0, &f, resscale);
-		bc_num_add(x0, &f, &fprime, resscale);
+	// Like the library, this returns the first argument as is if the second is
+	// zero.
+	if (BC_NUM_ZERO(b))
+	{
+		bc_num_copy(c, a);
+		return;
+	}
 
-		assert(BC_NUM_RDX_VALID_NP(fprime));
-		assert(BC_NUM_RDX_VALID_NP(half));
+	BC_SIG_LOCK;
 
-		bc_num_mul(&fprime, &half, x1, resscale);
+	bc_num_intView(a, &v);
+	bc_num_createCopy(&x, &v);
+	bc_num_intView(b, &v);
+	bc_num_createCopy(&y, &v);
 
-		// Switch.
-		temp = x0;
-		x0 = x1;
-		x1 = temp;
-	}
+	BC_SETJMP_LOCKED(vm, err);
 
-	// Copy to the result and truncate.
-	bc_num_copy(b, x0);
-	if (b->scale > realscale) bc_num_truncate(b, b->scale - realscale);
+	BC_SIG_UNLOCK;
 
-	assert(!BC_NUM_NEG(b) || BC_NUM_NONZERO(b));
-	assert(BC_NUM_RDX_VALID(b));
-	assert(BC_NUM_RDX_VAL(b) <= b->len || !b->len);
-	assert(!b->len || b->num[b->len - 1] || BC_NUM_RDX_VAL(b) == b->len);
+	bc_num_gcdRun(&x, &y, NULL);
+
+	bc_num_copy(c, BC_NUM_NONZERO(&x) ? &x : &y);
 
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&fprime);
-	bc_num_free(&f);
-	bc_num_free(&num2);
-	bc_num_free(&num1);
+	bc_num_free(&y);
+	bc_num_free(&x);
 	BC_LONGJMP_CONT(vm);
 }
 
 void
-bc_num_divmod(BcNum* a, BcNum* b, BcNum* c, BcNum* d, size_t scale)
+bc_num_lcm(BcNum* a, BcNum* b, BcNum* c, size_t scale)
 {
-	size_t ts, len;
-	BcNum *ptr_a, num2;
-	// This is volatile to quiet a warning on GCC about clobbering with
-	// longjmp().
-	volatile bool init = false;
+	BcNum x, y, u, w;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	// The bulk of this function is just doing what bc_num_binary() does for the
-	// binary operators. However, it assumes that only c and a can be equal.
-
-	// Set up the parameters.
-	ts = BC_MAX(scale + b->scale, a->scale);
-	len = bc_num_mulReq(a, b, ts);
+	BC_UNUSED(scale);
 
-	assert(a != NULL && b != NULL && c != NULL && d != NULL);
-	assert(c != d && a != d && b != d && b != c);
+	assert(a != c && b != c);
 
-	// Initialize or expand as necessary.
-	if (c == a)
+	if (BC_NUM_ZERO(a) && BC_NUM_ZERO(b))
 	{
-		// NOLINTNEXTLINE
-		memcpy(&num2, c, sizeof(BcNum));
-		ptr_a = &num2;
-
-		BC_SIG_LOCK;
-
-		bc_num_init(c, len);
-
-		init = true;
+		bc_num_zero(c);
+		return;
+	}
 
-		BC_SETJMP_LOCKED(vm, err);
+	bc_num_intView(a, &x);
+	bc_num_intView(b, &y);
 
-		BC_SIG_UNLOCK;
-	}
-	else
+	// Like the library, this divides zero by zero if the operands truncate to
+	// zero, and otherwise, the product is zero if either does.
+	if (BC_ERR(BC_NUM_ZERO(&x) && BC_NUM_ZERO(&y)))
 	{
-		ptr_a = a;
-		bc_num_expand(c, len);
+		bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
 	}
 
-	// Do the quick version if possible.
-	if (BC_NUM_NONZERO(a) && !BC_NUM_RDX_VAL(a) && !BC_NUM_RDX_VAL(b) &&
-	    b->len == 1 && !scale)
+	if (BC_NUM_ZERO(&x) || BC_NUM_ZERO(&y))
 	{
-		BcBigDig rem;
+		bc_num_zero(c);
+		return;
+	}
 
-		bc_num_divArray(ptr_a, (BcBigDig) b->num[0], c, &rem);
+	BC_SIG_LOCK;
 
-		assert(rem < BC_BASE_POW);
+	bc_num_createCopy(&u, &x);
+	bc_num_createCopy(&w, &y);
 
-		d->num[0] = (BcDig) rem;
-		d->len = (rem != 0);
-	}
-	// Do the slow method.
-	else bc_num_r(ptr_a, b, c, d, scale, ts);
+	BC_SETJMP_LOCKED(vm, err);
 
-	assert(!BC_NUM_NEG(c) || BC_NUM_NONZERO(c));
-	assert(BC_NUM_RDX_VALID(c));
-	assert(BC_NUM_RDX_VAL(c) <= c->len || !c->len);
-	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
-	assert(!BC_NUM_NEG(d) || BC_NUM_NONZERO(d));
-	assert(BC_NUM_RDX_VALID(d));
-	assert(BC_NUM_RDX_VAL(d) <= d->len || !d->len);
-	assert(!d->len || d->num[d->len - 1] || BC_NUM_RDX_VAL(d) == d->len);
+	BC_SIG_UNLOCK;
+
+	bc_num_gcdRun(&u, &w, NULL);
+
+	// Dividing first keeps the product small. The division is exact.
+	bc_num_div(&x, BC_NUM_NONZERO(&u) ? &u : &w, &w, 0);
+	bc_num_mul(&w, &y, c, 0);
 
 err:
-	// Only cleanup if we initialized.
-	if (init)
-	{
-		BC_SIG_MAYLOCK;
-		bc_num_free(&num2);
-		BC_LONGJMP_CONT(vm);
-	}
+	BC_SIG_MAYLOCK;
+	bc_num_free(&w);
+	bc_num_free(&u);
+	BC_LONGJMP_CONT(vm);
 }
 
 void
-bc_num_modexp(BcNum* a, BcNum* b, BcNum* c, BcNum* restrict d)
+bc_num_gcdext(BcNum* a, BcNum* b, BcNum* restrict g, BcNum* restrict x,
+              BcNum* restrict y)
 {
-	BcNum base, exp, two, temp, atemp, btemp, ctemp;
-	BcDig two_digs[2];
+	BcNum atemp, btemp, u, w;
+	bool aneg, bneg;
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
 
-	assert(a != NULL && b != NULL && c != NULL && d != NULL);
-	assert(a != d && b != d && c != d);
-
-	if (BC_ERR(BC_NUM_ZERO(c))) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
-	if (BC_ERR(BC_NUM_NEG(b))) bc_err(BC_ERR_MATH_NEGATIVE);
+	assert(a != NULL && b != NULL && g != NULL && x != NULL && y != NULL);
+	assert(a != g && a != x && a != y && b != g && b != x && b != y);
 
 #if BC_DEBUG || BC_GCC
 	// This is entirely for quieting a useless scan-build error.
 	btemp.len = 0;
-	ctemp.len = 0;
 #endif // BC_DEBUG || BC_GCC
 
 	// Eliminate fractional parts that are zero or error if they are not zero.
-	if (BC_ERR(bc_num_nonInt(a, &atemp) || bc_num_nonInt(b, &btemp) ||
-	           bc_num_nonInt(c, &ctemp)))
+	if (BC_ERR(bc_num_nonInt(a, &atemp) || bc_num_nonInt(b, &btemp)))
 	{
 		bc_err(BC_ERR_MATH_NON_INTEGER);
 	}
 
-	bc_num_expand(d, ctemp.len);
+	aneg = BC_NUM_NEG(&atemp);
+	bneg = BC_NUM_NEG(&btemp);
+	BC_NUM_NEG_CLR_NP(atemp);
+	BC_NUM_NEG_CLR_NP(btemp);
 
 	BC_SIG_LOCK;
 
-	bc_num_init(&base, ctemp.len);
-	bc_num_setup(&two, two_digs, sizeof(two_digs) / sizeof(BcDig));
-	bc_num_init(&temp, btemp.len + 1);
-	bc_num_createCopy(&exp, &btemp);
+	bc_num_createCopy(&u, &atemp);
+	bc_num_createCopy(&w, &btemp);
 
 	BC_SETJMP_LOCKED(vm, err);
 
 	BC_SIG_UNLOCK;
 
-	bc_num_one(&two);
-	two.num[0] = 2;
-	bc_num_one(d);
+	bc_num_gcdCoef(&u, &w, g, x, y);
 
-	// We already checked for 0.
-	bc_num_rem(&atemp, &ctemp, &base, 0);
+	if (aneg) bc_num_negate(x);
+	if (bneg) bc_num_negate(y);
 
-	// If you know the algorithm I used, the memory-efficient method, then this
-	// loop should be self-explanatory because it is the calculation loop.
-	while (BC_NUM_NONZERO(&exp))
-	{
-		// Num two cannot be 0, so no errors.
-		bc_num_divmod(&exp, &two, &exp, &temp, 0);
+err:
+	BC_SIG_MAYLOCK;
+	bc_num_free(&w);
+	bc_num_free(&u);
+	BC_LONGJMP_CONT(vm);
+	assert(BC_NUM_RDX_VALID(g) && BC_NUM_RDX_VALID(x) && BC_NUM_RDX_VALID(y));
+}
 
-		if (BC_NUM_ONE(&temp) && !BC_NUM_NEG_NP(temp))
-		{
-			assert(BC_NUM_RDX_VALID(d));
-			assert(BC_NUM_RDX_VALID_NP(base));
+void
+bc_num_invmod(BcNum* a, BcNum* b, BcNum* c, size_t scale)
+{
+	BcNum atemp, btemp, u, w, g, x;
+	bool neg;
+#if BC_ENABLE_LIBRARY
+	BcVm* vm = bcl_getspecific();
+#endif // BC_ENABLE_LIBRARY
 
-			bc_num_mul(d, &base, &temp, 0);
+	BC_UNUSED(scale);
 
-			// We already checked for 0.
-			bc_num_rem(&temp, &ctemp, d, 0);
-		}
+	assert(a != NULL && b != NULL && c != NULL);
+	assert(a != c && b != c);
 
-		assert(BC_NUM_RDX_VALID_NP(base));
+	if (BC_ERR(BC_NUM_ZERO(b))) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
 
-		bc_num_mul(&base, &base, &temp, 0);
+#if BC_DEBUG || BC_GCC
+	// This is entirely for quieting a useless scan-build error.
+	btemp.len = 0;
+#endif // BC_DEBUG || BC_GCC
 
-		// We already checked for 0.
-		bc_num_rem(&temp, &ctemp, &base, 0);
+	// Eliminate fractional parts that are zero or error if they are not zero.
+	if (BC_ERR(bc_num_nonInt(a, &atemp) || bc_num_nonInt(b, &btemp)))
+	{
+		bc_err(BC_ERR_MATH_NON_INTEGER);
 	}
 
+	// The inverse of -a is the negated inverse of a.
+	neg = BC_NUM_NEG(&atemp);
+	BC_NUM_NEG_CLR_NP(atemp);
+	BC_NUM_NEG_CLR_NP(btemp);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&u, btemp.len);
+	bc_num_createCopy(&w, &btemp);
+	bc_num_init(&g, BC_NUM_DEF_SIZE);
+	bc_num_init(&x, btemp.len);
+
+	BC_SETJMP_LOCKED(vm, err);
+
+	BC_SIG_UNLOCK;
+
+	// Only the coefficient of a in Bezout's identity is needed.
+	bc_num_rem(&atemp, &btemp, &u, 0);
+	bc_num_gcdCoef(&u, &w, &g, &x, NULL);
+
+	// If the GCD is not one, there is no inverse, which is the same as
+	// dividing by zero.
+	if (BC_ERR(!BC_NUM_ONE(&g))) bc_err(BC_ERR_MATH_DIVIDE_BY_ZERO);
+
+	// The coefficient is in (-b, b), so it only needs one fix up.
+	if (BC_NUM_NEG(&x)) bc_num_add(&x, &btemp, &x, 0);
+
+	if (neg && BC_NUM_NONZERO(&x)) bc_num_sub(&btemp, &x, c, 0);
+	else bc_num_copy(c, &x);
+
 err:
 	BC_SIG_MAYLOCK;
-	bc_num_free(&exp);
-	bc_num_free(&temp);
-	bc_num_free(&base);
+	bc_num_free(&x);
+	bc_num_free(&g);
+	bc_num_free(&w);
+	bc_num_free(&u);
 	BC_LONGJMP_CONT(vm);
-	assert(!BC_NUM_NEG(d) || d->len);
-	assert(BC_NUM_RDX_VALID(d));
-	assert(!d->len || d->num[d->len - 1] || BC_NUM_RDX_VAL(d) == d->len);
+	assert(!BC_NUM_NEG(c) || c->len);
+	assert(BC_NUM_RDX_VALID(c));
+	assert(!c->len || c->num[c->len - 1] || BC_NUM_RDX_VAL(c) == c->len);
 }
 
 #if BC_DEBUG_CODE
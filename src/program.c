@@ -1760,6 +1760,81 @@ exit:
 	BC_LONGJMP_CONT(vm);
 }
 
+/**
+ * Calls a math library function through its native kernel instead of its
+ * bytecode. The arguments are replaced by the result, just like a return would
+ * leave them.
+ * @param p   The program.
+ * @param f   The function, which must have a native kernel.
+ * @param ip  The instruction pointer of the call.
+ */
+static void
+bc_program_callNative(BcProgram* p, BcFunc* f, const BcInstPtr* ip)
+{
+	BcResult* opds[BC_PROG_NATIVE_MAX_PARAMS];
+	BcNum* nums[BC_PROG_NATIVE_MAX_PARAMS];
+	BcResult* res;
+	size_t i;
+
+	assert(f->native && f->nparams >= 1);
+	assert(f->nparams <= BC_PROG_NATIVE_MAX_PARAMS);
+
+	res = bc_program_prepResult(p);
+
+	// The first argument is the deepest one on the stack.
+	for (i = 0; i < f->nparams; ++i)
+	{
+		bc_program_operand(p, &opds[i], &nums[i], f->nparams - i);
+	}
+
+	// Getting a later argument can reallocate an array out from under an
+	// earlier one, so they are all gotten again before they are used.
+	for (i = 0; i < f->nparams; ++i)
+	{
+		nums[i] = bc_program_num(p, opds[i]);
+		bc_program_type_num(opds[i], nums[i]);
+	}
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&res->d.n, BC_NUM_DEF_SIZE);
+
+	// The kernel runs in a frame on the execution stack, like the bytecode
+	// would, so that errors in it show the function in stack traces. Bad
+	// arguments are the caller's fault, so the frame is only pushed now.
+	bc_vec_push(&p->stack, ip);
+
+	BC_SIG_UNLOCK;
+
+	switch (f->nparams)
+	{
+		case 1:
+		{
+			f->kernel.unary(nums[0], &res->d.n, BC_PROG_SCALE(p));
+			break;
+		}
+
+		case 2:
+		{
+			f->kernel.binary(nums[0], nums[1], &res->d.n, BC_PROG_SCALE(p));
+			break;
+		}
+
+		default:
+		{
+			f->kernel.ternary(nums[0], nums[1], nums[2], &res->d.n,
+			                  BC_PROG_SCALE(p));
+			break;
+		}
+	}
+
+	BC_SIG_LOCK;
+	bc_vec_pop(&p->stack);
+	BC_SIG_UNLOCK;
+
+	bc_program_retire(p, 1, f->nparams);
+}
+
 /**
  * Executes a function call for bc.
  * @param p     The program.
@@ -1799,6 +1874,13 @@ bc_program_call(BcProgram* p, const char* restrict code, size_t* restrict bgn)
 
 	assert(BC_PROG_STACK(&p->results, nargs));
 
+	// Math library functions with a native kernel are computed directly.
+	if (f->native)
+	{
+		bc_program_callNative(p, f, &ip);
+		return;
+	}
+
 	// Prepare the globals' stacks.
 	if (BC_G) bc_program_prepGlobals(p);
 
@@ -2148,11 +2230,13 @@ bc_program_divmod(BcProgram* p)
 }
 
 /**
- * Executes modular exponentiation.
- * @param p  The program.
+ * Executes modular exponentiation or another modular operator with three
+ * operands.
+ * @param p   The program.
+ * @param op  The operator, like bc_num_modexp().
  */
 static void
-bc_program_modexp(BcProgram* p)
+bc_program_modexp(BcProgram* p, BcNumModOp op)
 {
 	BcResult* r1;
 	BcResult* r2;
@@ -2196,11 +2280,90 @@ bc_program_modexp(BcProgram* p)
 
 	BC_SIG_UNLOCK;
 
-	bc_num_modexp(n1, n2, n3, &res->d.n);
+	op(n1, n2, n3, &res->d.n);
 
 	bc_program_retire(p, 1, 3);
 }
 
+#if BC_ENABLE_EXTRA_MATH
+
+/**
+ * Executes a modular inverse.
+ * @param p  The program.
+ */
+static void
+bc_program_invmod(BcProgram* p)
+{
+	BcResult* opd1;
+	BcResult* opd2;
+	BcResult* res;
+	BcNum* n1;
+	BcNum* n2;
+
+	res = bc_program_prepResult(p);
+
+	bc_program_binOpPrep(p, &opd1, &n1, &opd2, &n2, 1);
+
+	BC_SIG_LOCK;
+
+	bc_num_init(&res->d.n, n2->len);
+
+	BC_SIG_UNLOCK;
+
+	bc_num_invmod(n1, n2, &res->d.n, 0);
+
+	bc_program_retire(p, 1, 2);
+}
+
+/**
+ * Executes an extended GCD. The GCD is left deepest on the stack, with the
+ * coefficient of the second operand above it and the coefficient of the first
+ * operand on top.
+ * @param p  The program.
+ */
+static void
+bc_program_gcdext(BcProgram* p)
+{
+	BcResult* opd1;
+	BcResult* opd2;
+	BcResult* res;
+	BcResult* res2;
+	BcResult* res3;
+	BcNum* n1;
+	BcNum* n2;
+	size_t req;
+
+	// We grow first to avoid pointer invalidation.
+	bc_vec_grow(&p->results, 3);
+
+	// We don't need to update the pointers because
+	// the capacity is enough due to the line above.
+	res3 = bc_program_prepResult(p);
+	res2 = bc_program_prepResult(p);
+	res = bc_program_prepResult(p);
+
+	// Prepare the operands.
+	bc_program_binOpPrep(p, &opd1, &n1, &opd2, &n2, 3);
+
+	req = BC_MAX(n1->len, n2->len);
+
+	BC_SIG_LOCK;
+
+	// Initialize the results.
+	bc_num_init(&res->d.n, req);
+	bc_num_init(&res2->d.n, req);
+	bc_num_init(&res3->d.n, req);
+
+	BC_SIG_UNLOCK;
+
+	// Execute.
+	bc_num_gcdext(n1, n2, &res3->d.n, &res->d.n, &res2->d.n);
+
+	bc_program_retire(p, 3, 2);
+}
+
+#endif // BC_ENABLE_EXTRA_MATH
+
 /**
  * Asciifies a number for dc. This is a helper for bc_program_asciify().
  * @param p  The program.
@@ -2803,6 +2966,69 @@ bc_program_insertFunc(BcProgram* p, const char* name)
 	return idx;
 }
 
+#if BC_ENABLED
+
+/**
+ * Finds a math library function and marks it as computed by a native kernel.
+ * @param p        The program.
+ * @param name     The name of the function. It must already exist.
+ * @param nparams  The number of parameters that the kernel takes. The function
+ *                 must have the same number.
+ * @return         The function, for the caller to set the kernel in.
+ */
+static BcFunc*
+bc_program_nativeFunc(BcProgram* p, const char* name, size_t nparams)
+{
+	BcId* id;
+	BcFunc* f;
+	size_t idx;
+
+	// This is only used in an assert.
+	BC_UNUSED(nparams);
+
+	assert(p != NULL && name != NULL);
+
+	idx = bc_map_index(&p->fn_map, name);
+	assert(idx != BC_VEC_INVALID_IDX);
+
+	id = (BcId*) bc_vec_item(&p->fn_map, idx);
+	f = (BcFunc*) bc_vec_item(&p->fns, id->idx);
+
+	// The kernel must take the place of a function with the same parameters.
+	assert(f->nparams == nparams);
+
+	f->native = true;
+
+	return f;
+}
+
+void
+bc_program_setNative(BcProgram* p, const char* name, BcNumUnaryOp op)
+{
+	assert(op != NULL);
+	bc_program_nativeFunc(p, name, 1)->kernel.unary = op;
+}
+
+#if BC_ENABLE_EXTRA_MATH
+
+void
+bc_program_setNative2(BcProgram* p, const char* name, BcNumBinaryOp op)
+{
+	assert(op != NULL);
+	bc_program_nativeFunc(p, name, 2)->kernel.binary = op;
+}
+
+void
+bc_program_setNative3(BcProgram* p, const char* name, BcNumTernaryOp op)
+{
+	assert(op != NULL);
+	bc_program_nativeFunc(p, name, 3)->kernel.ternary = op;
+}
+
+#endif // BC_ENABLE_EXTRA_MATH
+
+#endif // BC_ENABLED
+
 #if BC_DEBUG
 void
 bc_program_free(BcProgram* p)
@@ -3518,7 +3744,7 @@ bc_program_exec(BcProgram* p)
 			BC_PROG_LBL(BC_INST_MODEXP):
 			// clang-format on
 			{
-				bc_program_modexp(p);
+				bc_program_modexp(p, bc_num_modexp);
 				BC_PROG_JUMP(inst, code, ip);
 			}
 
@@ -3530,6 +3756,32 @@ bc_program_exec(BcProgram* p)
 				BC_PROG_JUMP(inst, code, ip);
 			}
 
+#if BC_ENABLE_EXTRA_MATH
+			// clang-format off
+			BC_PROG_LBL(BC_INST_MULMOD):
+			// clang-format on
+			{
+				bc_program_modexp(p, bc_num_mulmod);
+				BC_PROG_JUMP(inst, code, ip);
+			}
+
+			// clang-format off
+			BC_PROG_LBL(BC_INST_INVMOD):
+			// clang-format on
+			{
+				bc_program_invmod(p);
+				BC_PROG_JUMP(inst, code, ip);
+			}
+
+			// clang-format off
+			BC_PROG_LBL(BC_INST_GCDEXT):
+			// clang-format on
+			{
+				bc_program_gcdext(p);
+				BC_PROG_JUMP(inst, code, ip);
+			}
+#endif // BC_ENABLE_EXTRA_MATH
+
 			// clang-format off
 			BC_PROG_LBL(BC_INST_PRINT_STREAM):
 			// clang-format on
@@ -453,29 +453,6 @@ bc_vm_handleError(BcErr e, size_t line, ...)
 	BC_SIG_TRYUNLOCK(lock);
 }
 
-char*
-bc_vm_getenv(const char* var)
-{
-	char* ret;
-
-#ifndef _WIN32
-	ret = getenv(var);
-#else // _WIN32
-	_dupenv_s(&ret, NULL, var);
-#endif // _WIN32
-
-	return ret;
-}
-
-void
-bc_vm_getenvFree(char* val)
-{
-	BC_UNUSED(val);
-#ifdef _WIN32
-	free(val);
-#endif // _WIN32
-}
-
 /**
  * Sets a flag from an environment variable and the default.
  * @param var   The environment variable.
@@ -638,9 +615,36 @@ bc_vm_envLen(const char* var)
 }
 #endif // BC_ENABLE_LIBRARY
 
+char*
+bc_vm_getenv(const char* var)
+{
+	char* ret;
+
+#ifndef _WIN32
+	ret = getenv(var);
+#else // _WIN32
+	_dupenv_s(&ret, NULL, var);
+#endif // _WIN32
+
+	return ret;
+}
+
+void
+bc_vm_getenvFree(char* val)
+{
+	BC_UNUSED(val);
+#ifdef _WIN32
+	free(val);
+#endif // _WIN32
+}
+
 void
 bc_vm_shutdown(void)
 {
+#if BC_DEBUG && !BC_ENABLE_LIBRARY
+	size_t i;
+#endif // BC_DEBUG && !BC_ENABLE_LIBRARY
+
 	BC_SIG_ASSERT_LOCKED;
 
 #if BC_ENABLE_NLS
@@ -673,6 +677,16 @@ bc_vm_shutdown(void)
 	bc_program_free(&vm->prog);
 
 	bc_slabvec_free(&vm->slabs);
+
+	bc_vec_free(&vm->pows);
+	bc_vec_free(&vm->bin_pows);
+	bc_num_free(&vm->mod.c);
+	bc_num_free(&vm->mod.m);
+
+	for (i = 0; i < BC_NUM_CONST_NUM; ++i)
+	{
+		bc_num_free(&vm->consts[i]);
+	}
 #endif // !BC_ENABLE_LIBRARY
 
 	bc_vm_freeTemps();
@@ -1464,8 +1478,32 @@ bc_vm_exec(void)
 
 		bc_vm_load(bc_lib_name, bc_lib);
 
+		// The core of the math library is computed natively; the kernels do
+		// exactly what the bc source does, only without the interpreter.
+		bc_program_setNative(&vm->prog, "e", bc_num_exp);
+		bc_program_setNative(&vm->prog, "l", bc_num_ln);
+		bc_program_setNative(&vm->prog, "s", bc_num_sin);
+		bc_program_setNative(&vm->prog, "c", bc_num_cos);
+		bc_program_setNative(&vm->prog, "a", bc_num_atan);
+
 #if BC_ENABLE_EXTRA_MATH
-		if (!BC_IS_POSIX) bc_vm_load(bc_lib2_name, bc_lib2);
+		if (!BC_IS_POSIX)
+		{
+			bc_vm_load(bc_lib2_name, bc_lib2);
+			bc_program_setNative(&vm->prog, "pi", bc_num_pi);
+			bc_program_setNative(&vm->prog, "f", bc_num_fact);
+			bc_program_setNative2(&vm->prog, "perm", bc_num_perm);
+			bc_program_setNative2(&vm->prog, "comb", bc_num_comb);
+			bc_program_setNative2(&vm->prog, "gcd", bc_num_gcd);
+			bc_program_setNative2(&vm->prog, "lcm", bc_num_lcm);
+			bc_program_setNative2(&vm->prog, "band", bc_num_band);
+			bc_program_setNative2(&vm->prog, "bor", bc_num_bor);
+			bc_program_setNative2(&vm->prog, "bxor", bc_num_bxor);
+			bc_program_setNative2(&vm->prog, "bnotn", bc_num_bnotn);
+			bc_program_setNative2(&vm->prog, "brevn", bc_num_brevn);
+			bc_program_setNative3(&vm->prog, "broln", bc_num_broln);
+			bc_program_setNative3(&vm->prog, "brorn", bc_num_brorn);
+		}
 #endif // BC_ENABLE_EXTRA_MATH
 
 		// Make sure to clear this.
@@ -1722,6 +1760,11 @@ bc_vm_boot(int argc, char* argv[])
 void
 bc_vm_init(void)
 {
+#if !BC_ENABLE_LIBRARY
+	char* kernels;
+#endif // !BC_ENABLE_LIBRARY
+	size_t i;
+
 #if BC_ENABLE_LIBRARY
 	BcVm* vm = bcl_getspecific();
 #endif // BC_ENABLE_LIBRARY
@@ -1729,6 +1772,12 @@ bc_vm_init(void)
 	BC_SIG_ASSERT_LOCKED;
 
 #if !BC_ENABLE_LIBRARY
+	// Pick the limb kernels for this CPU. The library does this once in
+	// bcl_start() instead because this runs for every thread.
+	kernels = bc_vm_getenv(BC_VM_KERNELS_STR);
+	bc_num_kernelsInit(kernels);
+	bc_vm_getenvFree(kernels);
+
 	// Set up the constant zero.
 	bc_num_setup(&vm->zero, vm->zero_num, BC_VM_ONE_CAP);
 #endif // !BC_ENABLE_LIBRARY
@@ -1749,6 +1798,16 @@ bc_vm_init(void)
 	vm->max.len = bc_num_bigdigMax_size;
 	vm->max2.len = bc_num_bigdigMax2_size;
 
+	bc_vec_init(&vm->pows, sizeof(BcNum), BC_DTOR_NUM);
+	bc_vec_init(&vm->bin_pows, sizeof(BcNum), BC_DTOR_NUM);
+	bc_num_init(&vm->mod.m, BC_NUM_DEF_SIZE);
+	bc_num_init(&vm->mod.c, BC_NUM_DEF_SIZE);
+
+	for (i = 0; i < BC_NUM_CONST_NUM; ++i)
+	{
+		bc_num_init(&vm->consts[i], BC_NUM_DEF_SIZE);
+	}
+
 	// Set up the maxes for the globals.
 	vm->maxes[BC_PROG_GLOBALS_IBASE] = BC_NUM_MAX_POSIX_IBASE;
 	vm->maxes[BC_PROG_GLOBALS_OBASE] = BC_MAX_OBASE;
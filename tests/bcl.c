@@ -57,6 +57,8 @@ main(void)
 	size_t scale;
 	BclNumber n, n2, n3, n4, n5, n6, n7;
 	char* res;
+	char big[601];
+	size_t i;
 	BclBigDig b = 0;
 
 	e = bcl_start();
@@ -265,6 +267,139 @@ main(void)
 	n7 = bcl_modexp(bcl_dup(n5), bcl_dup(n5), bcl_dup(n5));
 	err(bcl_err(n7));
 
+	// Check mulmod and invmod, which share the modulus cache with modexp.
+	n6 = bcl_parse("7");
+	err(bcl_err(n6));
+
+	n7 = bcl_mulmod_keep(n5, n5, n6);
+	err(bcl_err(n7));
+
+	res = bcl_string(n7);
+	if (strcmp(res, "2")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	n7 = bcl_mulmod(bcl_dup(n5), bcl_dup(n5), bcl_dup(n6));
+	err(bcl_err(n7));
+
+	res = bcl_string(n7);
+	if (strcmp(res, "2")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	n7 = bcl_invmod_keep(n5, n6);
+	err(bcl_err(n7));
+
+	res = bcl_string(n7);
+	if (strcmp(res, "5")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	n7 = bcl_invmod(bcl_dup(n5), n6);
+	err(bcl_err(n7));
+
+	res = bcl_string(n7);
+	if (strcmp(res, "5")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	// Check gcd, lcm, and gcdext, the last of which is another special case.
+	n6 = bcl_parse("24");
+	err(bcl_err(n6));
+
+	n7 = bcl_gcd_keep(n5, n6);
+	err(bcl_err(n7));
+
+	res = bcl_string(n7);
+	if (strcmp(res, "2")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	n7 = bcl_lcm(bcl_dup(n5), bcl_dup(n6));
+	err(bcl_err(n7));
+
+	res = bcl_string(n7);
+	if (strcmp(res, "120")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	e = bcl_gcdext_keep(n5, n6, &n2, &n3, &n4);
+	err(e);
+
+	res = bcl_string(n2);
+	if (strcmp(res, "2")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	res = bcl_string(n3);
+	if (strcmp(res, "5")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	res = bcl_string(n4);
+	if (strcmp(res, "-2")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	e = bcl_gcdext(bcl_dup(n5), n6, &n2, &n3, &n4);
+	err(e);
+
+	res = bcl_string(n3);
+	if (strcmp(res, "5")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
+	// Check a round trip through another base with a number big enough to fill
+	// the cache of powers of the base.
+	for (i = 0; i < sizeof(big) - 1; ++i)
+	{
+		big[i] = (char) ('1' + i % 9);
+	}
+
+	big[sizeof(big) - 1] = '\0';
+
+	n6 = bcl_parse(big);
+	err(bcl_err(n6));
+
+	bcl_ctxt_setObase(ctxt, 7);
+
+	res = bcl_string_keep(n6);
+
+	bcl_ctxt_setObase(ctxt, 10);
+	bcl_ctxt_setIbase(ctxt, 7);
+
+	n7 = bcl_parse(res);
+	err(bcl_err(n7));
+
+	free(res);
+
+	bcl_ctxt_setIbase(ctxt, 10);
+
+	if (bcl_cmp(n6, n7)) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	bcl_num_free(n6);
+	bcl_num_free(n7);
+
+	// Check modexp with an exponent big enough to fill the cache of powers of
+	// 2 for binary conversion. Since the exponent is a multiple of 6, Fermat
+	// says that the result mod 7 is 1.
+	big[0] = '6';
+	memset(big + 1, '0', sizeof(big) - 2);
+
+	n6 = bcl_parse(big);
+	err(bcl_err(n6));
+
+	n7 = bcl_parse("7");
+	err(bcl_err(n7));
+
+	n6 = bcl_modexp(bcl_dup(n5), n6, n7);
+	err(bcl_err(n6));
+
+	res = bcl_string(n6);
+	if (strcmp(res, "1")) err(BCL_ERROR_FATAL_UNKNOWN_ERR);
+
+	free(res);
+
 	// Clean up.
 	bcl_num_free(n);
 